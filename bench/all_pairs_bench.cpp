@@ -0,0 +1,138 @@
+#include <algorithm>
+#include <cmath>
+#include <limits>
+#include <optional>
+#include <string>
+#include <thread>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "city.h"
+#include "json_reader.h"
+#include "transport_router.h"
+
+// Предрасчёт таблицы маршрутов: исходный Флойд-Уоршелл по таблице optional против блочного на плоских массивах
+void RunAllPairsBench(std::ostream &out) {
+    const int side = 20;
+    const auto document = bench::MakeGridCityDocument(side);
+    const auto &root = document.GetRoot().AsDict();
+    const auto &routing = root.at("routing_settings").AsDict();
+    TransportCatalogue catalogue;
+    LoadCatalogue(catalogue, root.at("base_requests").AsArray());
+    router::TransportRouter router(routing.at("bus_wait_time").AsInt(), routing.at("bus_velocity").AsDouble());
+    router.BuildGraph(catalogue);
+    const auto &graph = router.GetGraph();
+    const size_t vertex_count = graph.GetVertexCount();
+    const size_t pairs = vertex_count * vertex_count;
+    out << "grid " << side << "x" << side << ": " << vertex_count << " vertices, " << graph.GetEdgeCount() << " edges" << std::endl;
+
+    std::unique_ptr<graph::Router<double>> sequential;
+    bench::PrintResult(out, bench::Measure("Router, sequential Floyd-Warshall", 1, pairs, [&] {
+        sequential = std::make_unique<graph::Router<double>>(graph, graph::AllPairsMethod::SEQUENTIAL);
+    }));
+    std::unique_ptr<graph::Router<double>> blocked;
+    bench::PrintResult(out, bench::Measure("Router, blocked Floyd-Warshall", 1, pairs, [&] {
+        blocked = std::make_unique<graph::Router<double>>(graph, graph::AllPairsMethod::BLOCKED);
+    }));
+
+    const size_t max_threads = std::max(4u, std::thread::hardware_concurrency());
+    graph::AllPairsTable table;
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        bench::PrintResult(out, bench::Measure("ComputeAllPairs, " + std::to_string(threads) + " thread(s)", 3, pairs, [&] {
+            table = graph::ComputeAllPairs(graph, threads);
+        }));
+    }
+
+    // веса совпадают с исходным алгоритмом с точностью хранения весов в его таблице (float),
+    // пути восстанавливаются до исходной вершины
+    size_t mismatches = 0;
+    for (graph::VertexId from = 0; from < vertex_count; ++from) {
+        for (graph::VertexId to = 0; to < vertex_count; ++to) {
+            const double weight = table.GetWeight(from, to);
+            const auto expected = sequential->GetRouteWeight(from, to);
+            if (!expected) {
+                mismatches += weight != std::numeric_limits<double>::infinity();
+                continue;
+            }
+            if (std::abs(weight - *expected) > 1e-6 * (1. + weight)) {
+                ++mismatches;
+                continue;
+            }
+            double path_weight = 0.;
+            graph::VertexId vertex = to;
+            for (size_t steps = 0; vertex != from && steps <= vertex_count; ++steps) {
+                const auto &edge = graph.GetEdge(table.GetPrevEdge(from, vertex));
+                path_weight += edge.weight;
+                vertex = edge.from;
+            }
+            mismatches += vertex != from || std::abs(path_weight - weight) > 1e-9 * (1. + weight);
+        }
+    }
+    out << "pairs differing from sequential Floyd-Warshall: " << mismatches << std::endl;
+
+    // Компактная таблица маршрутизатора против таблицы в double с 64-битными рёбрами (прежняя раскладка хранила то же
+    // в optional<{double, optional<EdgeId>}> по вектору на строку): последние рёбра те же, вес ячейки отличается
+    // на округление до float, а время в ответах - сумма рёбер в double - совпадает с точностью до порядка сложений
+    const size_t legacy_bytes = pairs * sizeof(std::optional<std::pair<double, std::optional<graph::EdgeId>>>)
+                                + vertex_count * sizeof(std::vector<std::optional<std::pair<double, std::optional<graph::EdgeId>>>>);
+    const size_t compact_bytes = blocked->GetRoutesInternalData().GetCellCount() * sizeof(graph::Router<double>::RouteInternalData);
+    out << "routes table: " << (legacy_bytes >> 10) << " KiB in the optional layout, " << (compact_bytes >> 10) << " KiB compact" << std::endl;
+    size_t layout_mismatches = 0;
+    graph::Router<double>::RouteEdges edges;
+    for (graph::VertexId from = 0; from < vertex_count; ++from) {
+        for (graph::VertexId to = 0; to < vertex_count; ++to) {
+            const double weight = table.GetWeight(from, to);
+            const auto &cell = blocked->GetRoutesInternalData().GetCells()[from * vertex_count + to];
+            const auto route_weight = blocked->BuildRoute(from, to, edges);
+            const auto weight_only = blocked->GetRouteWeight(from, to);
+            if (weight == std::numeric_limits<double>::infinity()) {
+                layout_mismatches += cell.weight != graph::Router<double>::UNREACHABLE || route_weight.has_value() || weight_only.has_value();
+                continue;
+            }
+            const auto prev_edge = table.GetPrevEdge(from, to);
+            layout_mismatches += !route_weight || !weight_only || std::abs(cell.weight - weight) > 1e-7 * weight
+                                 || std::abs(*route_weight - weight) > 1e-9 * (1. + weight)
+                                 || std::abs(*weight_only - weight) > 1e-9 * (1. + weight)
+                                 || (prev_edge == graph::AllPairsTable::NO_EDGE ? !edges.empty() : edges.empty() || edges.back().first != prev_edge);
+        }
+    }
+    out << "pairs differing from the double table: " << layout_mismatches << std::endl;
+
+    // оценка перед расчётом: порядок времени и памяти, по которому выбирается таблица или поиск на запрос
+    const auto cost = graph::Router<double>::EstimateCost(vertex_count, graph.GetEdgeCount());
+    out << "estimate: " << cost.seconds * 1000. << " ms, table " << (cost.table_bytes >> 10) << " KiB, peak "
+        << (cost.peak_bytes >> 10) << " KiB" << std::endl;
+
+    // без таблицы маршруты ищутся Дейкстрой на запрос и совпадают с табличными по времени с точностью хранения в таблице
+    router::PrecomputeSettings settings;
+    settings.memory_limit = 1;
+    const router::TransportRouter fallback(catalogue, routing.at("bus_wait_time").AsInt(), routing.at("bus_velocity").AsDouble(), settings);
+    const router::TransportRouter tabled(catalogue, routing.at("bus_wait_time").AsInt(), routing.at("bus_velocity").AsDouble());
+    std::vector<std::string_view> stop_names;
+    for (const auto &[name, stop] : catalogue.GetAllStopsList()) {
+        stop_names.push_back(name);
+    }
+    std::vector<std::pair<std::string_view, std::string_view>> queries;
+    for (size_t i = 0; i < 4096; ++i) {
+        queries.emplace_back(stop_names[i % stop_names.size()], stop_names[(i * 37 + i / stop_names.size()) % stop_names.size()]);
+    }
+    size_t route_mismatches = 0;
+    for (const auto &[from, to] : queries) {
+        const auto expected_time = tabled.GetRouteTime(from, to);
+        const auto time = fallback.GetRouteTime(from, to);
+        route_mismatches += expected_time.has_value() != time.has_value()
+                            || (time && std::abs(*time - *expected_time) > 1e-6 * (1. + *time));
+    }
+    bench::PrintResult(out, bench::Measure("GetRouteTime, routes table", 20, queries.size(), [&] {
+        for (const auto &[from, to] : queries) {
+            bench::DoNotOptimize(tabled.GetRouteTime(from, to));
+        }
+    }));
+    bench::PrintResult(out, bench::Measure("GetRouteTime, Dijkstra per query", 1, queries.size(), [&] {
+        for (const auto &[from, to] : queries) {
+            bench::DoNotOptimize(fallback.GetRouteTime(from, to));
+        }
+    }));
+    out << "routes differing without the table: " << route_mismatches << std::endl;
+}
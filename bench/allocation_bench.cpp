@@ -0,0 +1,146 @@
+#include <algorithm>
+#include <limits>
+#include <map>
+#include <string>
+#include <string_view>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "city.h"
+#include "json_reader.h"
+#include "profiler.h"
+#include "transport_router.h"
+
+namespace {
+// Сверх выделений под само дерево ответа (CountTreeAllocations) запрос города-сетки 14 x 14 выделяет память
+// ровно столько раз: Bus и Route - стек узлов Builder ответа, Stop - ещё временный список маршрутов.
+// Число выделений под дерево растёт с длиной ответа (узел словаря на каждый ключ элемента маршрута),
+// остальное от запроса не зависит. Рост - регрессия: бюджет меняется только вместе с осознанным
+// изменением пути запроса
+const std::map<std::string, uint64_t> ALLOCATION_BUDGETS = {
+    {"Bus", 1},
+    {"Stop", 2},
+    {"Route", 1},
+};
+
+// Выделения, без которых дерева ответа нет: узел словаря на каждый ключ, буфер непустого массива
+// и строки (ключи и значения) длиннее буфера короткой строки
+uint64_t CountTreeAllocations(const json::Node &node) {
+    const size_t short_string_capacity = std::string().capacity();
+    if (node.IsString()) {
+        return node.AsString().size() > short_string_capacity ? 1 : 0;
+    }
+    uint64_t count = 0;
+    if (node.IsArray()) {
+        count += node.AsArray().empty() ? 0 : 1;
+        for (const auto &item : node.AsArray()) {
+            count += CountTreeAllocations(item);
+        }
+    } else if (node.IsMap()) {
+        for (const auto &[key, value] : node.AsDict()) {
+            count += 1 + (key.size() > short_string_capacity ? 1 : 0) + CountTreeAllocations(value);
+        }
+    }
+    return count;
+}
+} // namespace
+
+// Выделения памяти на запрос по типам на городе-сетке; проверка бюджетов ALLOCATION_BUDGETS
+// и отсутствия выделений при поиске маршрутов без таблицы
+void RunAllocationBench(std::ostream &out) {
+    const auto document = bench::MakeGridCityDocument(14);
+    const auto &root = document.GetRoot().AsDict();
+    const auto &routing = root.at("routing_settings").AsDict();
+    TransportCatalogue catalogue;
+    LoadCatalogue(catalogue, root.at("base_requests").AsArray());
+    const router::TransportRouter router(catalogue, routing.at("bus_wait_time").AsInt(), routing.at("bus_velocity").AsDouble());
+    RenderSets render_sets;
+    FillRenderSets(root.at("render_settings"), render_sets);
+    const RequestHandler req_handler(catalogue, router);
+    MapRenderer renderer(render_sets);
+
+    struct TypeAllocations {
+        size_t requests = 0;
+        uint64_t total = 0;
+        uint64_t bytes = 0;
+        // выделения сверх дерева ответа
+        uint64_t min_overhead = std::numeric_limits<uint64_t>::max();
+        uint64_t max_overhead = 0;
+    };
+    std::map<std::string, TypeAllocations> allocations;
+    // первый проход прогревает переиспользуемые буферы, замеряется второй
+    for (int pass = 0; pass < 2; ++pass) {
+        for (const auto &req : root.at("stat_requests").AsArray()) {
+            const auto &type = req.AsDict().at("type").AsString();
+            if (!ALLOCATION_BUDGETS.count(type)) {
+                continue;
+            }
+            const profile::AllocationScope scope;
+            const auto response = GetReqResult(req_handler, req, renderer);
+            const auto counters = scope.GetCounters();
+            bench::DoNotOptimize(response);
+            if (pass == 1) {
+                auto &type_allocations = allocations[type];
+                ++type_allocations.requests;
+                type_allocations.total += counters.count;
+                type_allocations.bytes += counters.bytes;
+                const uint64_t overhead = counters.count - CountTreeAllocations(response);
+                type_allocations.min_overhead = std::min(type_allocations.min_overhead, overhead);
+                type_allocations.max_overhead = std::max(type_allocations.max_overhead, overhead);
+            }
+        }
+    }
+    // сверх дерева ответа каждый запрос типа выделяет ровно бюджет
+    for (const auto &[type, stats] : allocations) {
+        const auto budget = ALLOCATION_BUDGETS.at(type);
+        const bool exact = stats.min_overhead == budget && stats.max_overhead == budget;
+        out << type << ": " << stats.requests << " requests, " << static_cast<double>(stats.total) / static_cast<double>(stats.requests)
+            << " allocations and " << stats.bytes / stats.requests << " bytes per request, beyond the response tree "
+            << stats.min_overhead << ".." << stats.max_overhead << ", budget " << budget << (exact ? " - ok" : " - NOT EXACT")
+            << std::endl;
+        if (!exact) {
+            bench::MarkFailed();
+        }
+    }
+
+    // Маршруты без таблицы: после прогрева рабочие массивы поиска и буфер рёбер переиспользуются,
+    // и запрос не выделяет память ни одним способом поиска
+    std::vector<std::string_view> stop_names;
+    for (const auto &[name, stop] : catalogue.GetAllStopsList()) {
+        stop_names.push_back(name);
+    }
+    std::sort(stop_names.begin(), stop_names.end());
+    std::vector<std::pair<std::string_view, std::string_view>> queries;
+    for (size_t i = 0; i < 512; ++i) {
+        queries.emplace_back(stop_names[i % stop_names.size()], stop_names[(i * 37 + 11) % stop_names.size()]);
+    }
+    const std::vector<std::pair<std::string, router::RouteSearch>> searches = {
+        {"Dijkstra", router::RouteSearch::DIJKSTRA},
+        {"geometric A*", router::RouteSearch::GEOMETRIC_A_STAR},
+        {"ALT", router::RouteSearch::ALT},
+        {"bidirectional", router::RouteSearch::BIDIRECTIONAL},
+    };
+    for (const auto &[search_name, search] : searches) {
+        router::PrecomputeSettings settings;
+        settings.memory_limit = 1;
+        settings.search = search;
+        const router::TransportRouter search_router(catalogue, routing.at("bus_wait_time").AsInt(),
+                                                    routing.at("bus_velocity").AsDouble(), settings);
+        graph::Router<double>::RouteEdges edges;
+        profile::AllocationCounters counters;
+        for (int pass = 0; pass < 2; ++pass) {
+            const profile::AllocationScope scope;
+            for (const auto &[from, to] : queries) {
+                bench::DoNotOptimize(search_router.CreateRoute(from, to, edges));
+                bench::DoNotOptimize(search_router.GetRouteTime(from, to));
+            }
+            counters = scope.GetCounters();
+        }
+        out << "Route without table, " << search_name << ": " << counters.count << " allocations in " << 2 * queries.size()
+            << " searches" << (counters.count == 0 ? " - ok" : " - ALLOCATES") << std::endl;
+        if (counters.count != 0) {
+            bench::MarkFailed();
+        }
+    }
+}
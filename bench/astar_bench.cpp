@@ -0,0 +1,148 @@
+#include <algorithm>
+#include <cmath>
+#include <functional>
+#include <memory>
+#include <optional>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "city.h"
+#include "json_reader.h"
+#include "landmarks.h"
+#include "shortest_paths.h"
+#include "transport_router.h"
+
+namespace {
+void RunAStarCity(std::ostream &out, const std::string &name, const bench::CityParams &params) {
+    const std::string prefix = name + ": ";
+    const auto document = bench::MakeRandomCityDocument(params);
+    const auto &root = document.GetRoot().AsDict();
+    const auto &routing = root.at("routing_settings").AsDict();
+    const int wait_time = routing.at("bus_wait_time").AsInt();
+    const double velocity = routing.at("bus_velocity").AsDouble();
+    TransportCatalogue catalogue;
+    LoadCatalogue(catalogue, root.at("base_requests").AsArray());
+
+    // без таблицы маршрутов: каждый маршрутизатор ищет маршруты своим поиском
+    const std::vector<std::pair<std::string, router::RouteSearch>> searches = {
+        {"Dijkstra", router::RouteSearch::DIJKSTRA},
+        {"geometric A*", router::RouteSearch::GEOMETRIC_A_STAR},
+        {"ALT", router::RouteSearch::ALT},
+        {"bidirectional", router::RouteSearch::BIDIRECTIONAL},
+    };
+    std::vector<std::unique_ptr<router::TransportRouter>> routers;
+    for (const auto &[search_name, search] : searches) {
+        router::PrecomputeSettings settings;
+        settings.memory_limit = 1;
+        settings.search = search;
+        routers.push_back(std::make_unique<router::TransportRouter>(catalogue, wait_time, velocity, settings));
+    }
+    const auto &graph = routers.front()->GetGraph();
+    const size_t vertex_count = graph.GetVertexCount();
+    out << name << " city: " << vertex_count << " vertices, " << graph.GetEdgeCount() << " edges" << std::endl;
+    std::unique_ptr<graph::Landmarks> landmarks;
+    bench::PrintResult(out, bench::Measure(prefix + "Landmarks build", 1, vertex_count, [&] {
+        landmarks = std::make_unique<graph::Landmarks>(graph);
+    }));
+    out << prefix << landmarks->GetLandmarks().size() << " landmarks, " << (landmarks->GetMemoryBytes() >> 10) << " KiB" << std::endl;
+
+    const auto &stop_vertices = routers.front()->GetStopVertices();
+    std::mt19937 generator(params.seed);
+    std::uniform_int_distribution<size_t> stop_index(0, stop_vertices.size() - 1);
+    std::vector<std::pair<graph::VertexId, graph::VertexId>> queries(1 << 11);
+    for (auto &[from, to] : queries) {
+        from = stop_vertices[stop_index(generator)];
+        to = stop_vertices[stop_index(generator)];
+    }
+
+    // Дальние поездки через город: восьмая часть случайных пар с наибольшим временем в пути
+    std::vector<std::pair<double, size_t>> route_times;
+    for (size_t i = 0; i < queries.size(); ++i) {
+        const auto weight = routers.front()->SearchRoute(queries[i].first, queries[i].second, nullptr);
+        if (weight) {
+            route_times.emplace_back(*weight, i);
+        }
+    }
+    std::sort(route_times.begin(), route_times.end(), std::greater<>{});
+    std::vector<std::pair<graph::VertexId, graph::VertexId>> long_queries;
+    for (size_t i = 0; i < queries.size() / 8 && i < route_times.size(); ++i) {
+        long_queries.push_back(queries[route_times[i].second]);
+    }
+
+    // Время совпадает с Дейкстрой с точностью до порядка сложений, маршрут непрерывен и даёт то же время.
+    // Число извлечённых вершин показывает, насколько поиск сужается
+    graph::Router<double>::RouteEdges edges;
+    size_t mismatches = 0;
+    const auto compare = [&](const std::string &set_name, const std::vector<std::pair<graph::VertexId, graph::VertexId>> &set) {
+        std::vector<std::optional<double>> expected(set.size());
+        for (size_t i = 0; i < set.size(); ++i) {
+            expected[i] = routers.front()->SearchRoute(set[i].first, set[i].second, nullptr);
+        }
+        for (size_t s = 0; s < searches.size(); ++s) {
+            const auto &router = *routers[s];
+            size_t settled_total = 0;
+            for (size_t i = 0; i < set.size(); ++i) {
+                const auto &[from, to] = set[i];
+                size_t settled = 0;
+                const auto weight = router.SearchRoute(from, to, &edges, &settled);
+                settled_total += settled;
+                if (weight.has_value() != expected[i].has_value()) {
+                    ++mismatches;
+                    continue;
+                }
+                if (!weight) {
+                    continue;
+                }
+                graph::VertexId vertex = from;
+                double route_weight = 0.;
+                for (const auto &[edge_id, edge] : edges) {
+                    mismatches += edge->from != vertex;
+                    vertex = edge->to;
+                    route_weight += edge->weight;
+                }
+                mismatches += vertex != to || std::abs(*weight - *expected[i]) > 1e-9 * (1. + *expected[i])
+                              || std::abs(route_weight - *weight) > 1e-9 * (1. + *weight);
+            }
+            out << prefix << set_name << ", " << searches[s].first << ": "
+                << static_cast<double>(settled_total) / static_cast<double>(set.size()) << " settled vertices per query" << std::endl;
+            bench::PrintResult(out, bench::Measure(prefix + set_name + ", SearchRoute, " + searches[s].first, 1, set.size(), [&] {
+                for (const auto &[from, to] : set) {
+                    bench::DoNotOptimize(router.SearchRoute(from, to, &edges));
+                }
+            }));
+        }
+    };
+    compare("random", queries);
+    compare("long", long_queries);
+
+    // Короткий поиск ALT против выделения и обнуления массивов на все вершины графа: рабочие массивы
+    // в SearchRoute берутся из рабочей области потока, здесь для сравнения поиск создаётся на каждый запрос
+    bench::PrintResult(out, bench::Measure(prefix + "random, ALT, search created per query", 1, queries.size(), [&] {
+        for (const auto &[from, to] : queries) {
+            graph::PointToPointSearch<double> search(graph);
+            bench::DoNotOptimize(search.Run(from, to, &edges, [&landmarks, to = to](graph::VertexId vertex) {
+                return landmarks->GetLowerBound(vertex, to);
+            }));
+        }
+    }));
+    bench::PrintResult(out, bench::Measure(prefix + "random, ALT, thread workspace", 1, queries.size(), [&] {
+        for (const auto &[from, to] : queries) {
+            bench::DoNotOptimize(routers[2]->SearchRoute(from, to, &edges));
+        }
+    }));
+    out << prefix << "routes differing from Dijkstra: " << mismatches << std::endl;
+    if (mismatches) {
+        bench::MarkFailed();
+    }
+}
+} // namespace
+
+// Поиск маршрута без таблицы: Дейкстра против A* с оценками по прямой и по ориентирам и двунаправленной Дейкстры
+// на случайных и дальних запросах
+void RunAStarBench(std::ostream &out) {
+    RunAStarCity(out, "small", {300, 40, 12, 0.3, {}, 1});
+    RunAStarCity(out, "medium", {800, 120, 20, 0.3, {}, 2});
+}
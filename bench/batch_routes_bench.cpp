@@ -0,0 +1,114 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <set>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "city.h"
+#include "json_builder.h"
+#include "json_reader.h"
+#include "transport_router.h"
+
+namespace {
+// Запросы Route: skew = 0 - исходная остановка равновероятна, иначе вероятность остановки ранга k
+// пропорциональна 1 / (k + 1)^skew (закон Ципфа), так что большинство запросов идёт из немногих остановок
+json::Array MakeRouteRequests(const std::vector<std::string> &stops, size_t count, double skew, uint32_t seed) {
+    std::mt19937 generator(seed);
+    std::vector<double> weights(stops.size());
+    for (size_t rank = 0; rank < stops.size(); ++rank) {
+        weights[rank] = 1. / std::pow(static_cast<double>(rank + 1), skew);
+    }
+    std::discrete_distribution<size_t> origin(weights.begin(), weights.end());
+    std::uniform_int_distribution<size_t> destination(0, stops.size() - 1);
+    json::Array requests;
+    requests.reserve(count);
+    for (size_t i = 0; i < count; ++i) {
+        requests.push_back(json::Builder{}.StartDict().Key("id").Value(static_cast<int>(i)).Key("type").Value("Route")
+                               .Key("from").Value(stops[origin(generator)]).Key("to").Value(stops[destination(generator)])
+                               .EndDict().Build());
+    }
+    return requests;
+}
+} // namespace
+
+// Пакетный расчёт запросов Route (поиск на исходную остановку) против поиска на каждый запрос,
+// без таблицы маршрутов, на равномерной и перекошенных по исходным остановкам нагрузках
+void RunBatchRoutesBench(std::ostream &out) {
+    const auto document = bench::MakeRandomCityDocument({800, 120, 20, 0.3, {}, 3});
+    const auto &root = document.GetRoot().AsDict();
+    const auto &routing = root.at("routing_settings").AsDict();
+    TransportCatalogue catalogue;
+    LoadCatalogue(catalogue, root.at("base_requests").AsArray());
+    router::PrecomputeSettings settings;
+    settings.memory_limit = 1;
+    const router::TransportRouter router(catalogue, routing.at("bus_wait_time").AsInt(), routing.at("bus_velocity").AsDouble(), settings);
+    RenderSets render_sets;
+    FillRenderSets(root.at("render_settings"), render_sets);
+    const RequestHandler req_handler(catalogue, router);
+    MapRenderer renderer(render_sets);
+
+    // остановки, через которые проходят маршруты, в случайном порядке - он же порядок рангов популярности
+    std::set<std::string> served_set;
+    for (const auto &item : root.at("base_requests").AsArray()) {
+        if (item.AsDict().at("type").AsString() == "Bus") {
+            for (const auto &stop : item.AsDict().at("stops").AsArray()) {
+                served_set.insert(stop.AsString());
+            }
+        }
+    }
+    std::vector<std::string> served(served_set.begin(), served_set.end());
+    std::shuffle(served.begin(), served.end(), std::mt19937(7));
+
+    for (const double skew : {0., 1., 1.5}) {
+        const auto requests = MakeRouteRequests(served, 2048, skew, 11);
+        std::set<std::string> origins;
+        for (const auto &req : requests) {
+            origins.insert(req.AsDict().at("from").AsString());
+        }
+        const std::string prefix = "skew " + std::to_string(skew).substr(0, 3) + ": ";
+        out << prefix << requests.size() << " Route requests from " << origins.size() << " origins" << std::endl;
+
+        json::Array per_request;
+        bench::PrintResult(out, bench::Measure(prefix + "search per request", 1, requests.size(), [&] {
+            per_request.clear();
+            for (const auto &req : requests) {
+                per_request.push_back(GetReqResult(req_handler, req, renderer));
+            }
+        }));
+        json::Document batched{nullptr};
+        bench::PrintResult(out, bench::Measure(prefix + "batched by origin", 1, requests.size(), [&] {
+            batched = GetReqsResults(req_handler, requests, renderer);
+        }));
+        // ответы те же и в том же порядке
+        const bool same = batched == json::Document(std::move(per_request));
+        out << prefix << "same responses: " << (same ? "yes" : "no") << std::endl;
+        if (!same) {
+            bench::MarkFailed();
+        }
+    }
+
+    // Пакеты в нескольких потоках: рабочие области живут в потоках пула, поэтому за все пакеты создаётся
+    // не больше поисков, чем потоков на виды поиска (один ко многим и для одиночной пары)
+    const size_t threads_count = 4;
+    const auto requests = MakeRouteRequests(served, 512, 1., 13);
+    std::vector<std::pair<std::string_view, std::string_view>> pairs;
+    for (const auto &req : requests) {
+        pairs.emplace_back(req.AsDict().at("from").AsString(), req.AsDict().at("to").AsString());
+    }
+    const std::vector<std::string_view> matrix_stops(served.begin(), served.begin() + std::min<size_t>(64, served.size()));
+    const int batches_count = 5;
+    const uint64_t searches_before = router::TransportRouter::GetCreatedSearchesCount();
+    for (int batch = 0; batch < batches_count; ++batch) {
+        bench::DoNotOptimize(router.CreateRoutes(pairs, threads_count));
+        bench::DoNotOptimize(router.GetTravelTimes(matrix_stops, matrix_stops, threads_count));
+    }
+    const uint64_t searches = router::TransportRouter::GetCreatedSearchesCount() - searches_before;
+    const bool reused = searches <= 2 * threads_count;
+    out << batches_count << " batches in " << threads_count << " threads: " << searches << " searches created"
+        << (reused ? " - ok" : " - NOT REUSED") << std::endl;
+    if (!reused) {
+        bench::MarkFailed();
+    }
+}
@@ -0,0 +1,53 @@
+#include "bench.h"
+
+#include <iomanip>
+#include <utility>
+#include <vector>
+
+#include "json.h"
+
+namespace bench {
+
+namespace {
+std::string current_suite;
+std::vector<std::pair<std::string, Result>> recorded_results;
+bool failed = false;
+} // namespace
+
+void PrintResult(std::ostream &out, const Result &result) {
+    const auto precision = out.precision();
+    out << std::left << std::setw(48) << result.name
+        << std::right << std::setw(12) << result.operations << " ops"
+        << std::setw(12) << std::fixed << std::setprecision(2) << result.total_ms << " ms"
+        << std::setw(12) << result.NsPerOperation() << " ns/op" << std::endl;
+    out.unsetf(std::ios::fixed);
+    out.precision(precision);
+    recorded_results.emplace_back(current_suite, result);
+}
+
+void BeginSuite(std::string name) {
+    current_suite = std::move(name);
+}
+
+void MarkFailed() {
+    failed = true;
+}
+
+bool HasFailed() {
+    return failed;
+}
+
+void PrintRecordedResults(std::ostream &out) {
+    json::Array results;
+    for (const auto &[suite, result] : recorded_results) {
+        results.push_back(json::Dict{{"suite", suite},
+                                     {"name", result.name},
+                                     {"operations", static_cast<int>(result.operations)},
+                                     {"total_ms", result.total_ms},
+                                     {"ns_per_op", result.NsPerOperation()}});
+    }
+    json::Print(json::Document(json::Dict{{"results", std::move(results)}}), out);
+    out << std::endl;
+}
+
+} // namespace bench
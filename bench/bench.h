@@ -0,0 +1,53 @@
+#pragma once
+
+#include <chrono>
+#include <cstddef>
+#include <iostream>
+#include <string>
+
+namespace bench {
+
+// результат одного замера
+struct Result {
+    std::string name;
+    size_t operations = 0;
+    double total_ms = 0.;
+
+    double NsPerOperation() const {
+        return operations ? total_ms * 1e6 / static_cast<double>(operations) : 0.;
+    }
+};
+
+// Выполняет func() repeats раз; каждый вызов считается за operations_per_call операций
+template <typename Func>
+Result Measure(std::string name, size_t repeats, size_t operations_per_call, Func func) {
+    const auto start = std::chrono::steady_clock::now();
+    for (size_t i = 0; i < repeats; ++i) {
+        func();
+    }
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+    return {std::move(name), repeats * operations_per_call, elapsed.count()};
+}
+
+// Выводит строку замера и запоминает его для PrintRecordedResults
+void PrintResult(std::ostream &out, const Result &result);
+
+// набор, к которому относятся следующие замеры
+void BeginSuite(std::string name);
+
+// Отмечает нарушенную проверку набора: программа бенчмарков завершится с кодом 1
+void MarkFailed();
+
+bool HasFailed();
+
+// Все выведенные замеры одним документом JSON, для сравнения прогонов:
+// {"results": [{"suite", "name", "operations", "total_ms", "ns_per_op"}, ...]}
+void PrintRecordedResults(std::ostream &out);
+
+// Не даёт компилятору выбросить вычисление, результат которого не используется
+template <typename T>
+void DoNotOptimize(const T &value) {
+    asm volatile("" : : "r,m"(value) : "memory");
+}
+
+} // namespace bench
@@ -0,0 +1,56 @@
+#include <algorithm>
+#include <deque>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "map_renderer.h"
+#include "transport_catalogue.h"
+
+namespace {
+// прежнее хранение остановок: имя и координаты в одном объекте дека
+struct LegacyStop {
+    std::string name;
+    geo::Coordinates coordinate;
+};
+} // namespace
+
+void RunCatalogueBench(std::ostream &out) {
+    const size_t stops_count = 1 << 17;
+    std::mt19937 generator(7);
+    std::uniform_real_distribution<double> lat(55.5, 55.9);
+    std::uniform_real_distribution<double> lng(37.3, 37.8);
+
+    TransportCatalogue catalogue;
+    std::deque<LegacyStop> legacy_stops;
+    for (size_t i = 0; i < stops_count; ++i) {
+        const std::string name = "Stop name long enough to leave SSO #" + std::to_string(i);
+        const geo::Coordinates coordinate{lat(generator), lng(generator)};
+        catalogue.AddStop(name, coordinate);
+        legacy_stops.push_back({name, coordinate});
+    }
+
+    const size_t repeats = 100;
+    std::vector<svg::Point> points(stops_count);
+    bench::PrintResult(out, bench::Measure("bounds + projection, deque<Stop>", repeats, stops_count, [&] {
+        // как раньше в StopPointsSetter: сбор координат из объектов остановок в отдельный пул
+        std::vector<geo::Coordinates> coordinate_pool;
+        for (const auto &stop : legacy_stops) {
+            coordinate_pool.push_back(stop.coordinate);
+        }
+        SphereProjector projector(coordinate_pool.begin(), coordinate_pool.end(), 1200., 1200., 50.);
+        size_t i = 0;
+        for (const auto &stop : legacy_stops) {
+            points[i++] = projector(stop.coordinate);
+        }
+        bench::DoNotOptimize(points.back());
+    }));
+    const auto &lats = catalogue.GetStopLatitudes();
+    const auto &lngs = catalogue.GetStopLongitudes();
+    bench::PrintResult(out, bench::Measure("bounds + projection, lat/lng arrays", repeats, stops_count, [&] {
+        SphereProjector projector(lats.begin(), lats.end(), lngs.begin(), lngs.end(), 1200., 1200., 50.);
+        projector.Project(lats, lngs, points);
+        bench::DoNotOptimize(points.back());
+    }));
+}
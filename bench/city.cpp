@@ -0,0 +1,211 @@
+#include "city.h"
+
+#include <algorithm>
+#include <cmath>
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "geo.h"
+#include "json_builder.h"
+
+namespace bench {
+
+namespace {
+json::Dict MakeRenderSettings() {
+    return json::Builder{}.StartDict()
+        .Key("width").Value(1200.).Key("height").Value(1200.).Key("padding").Value(50.)
+        .Key("stop_radius").Value(5.).Key("line_width").Value(14.)
+        .Key("bus_label_font_size").Value(20).Key("bus_label_offset").Value(json::Array{7., 15.})
+        .Key("stop_label_font_size").Value(20).Key("stop_label_offset").Value(json::Array{7., -3.})
+        .Key("underlayer_color").Value(json::Array{255, 255, 255, 0.85}).Key("underlayer_width").Value(3.)
+        .Key("color_palette").Value(json::Array{std::string("green"), json::Array{255, 160, 0}, std::string("red")})
+        .EndDict().Build().AsDict();
+}
+
+json::Dict MakeRoutingSettings() {
+    return json::Builder{}.StartDict().Key("bus_wait_time").Value(6).Key("bus_velocity").Value(40.).EndDict().Build().AsDict();
+}
+
+json::Document MakeCityDocument(json::Array base, json::Array requests) {
+    return json::Document(json::Builder{}.StartDict()
+                              .Key("base_requests").Value(std::move(base))
+                              .Key("stat_requests").Value(std::move(requests))
+                              .Key("render_settings").Value(MakeRenderSettings())
+                              .Key("routing_settings").Value(MakeRoutingSettings())
+                              .EndDict().Build());
+}
+} // namespace
+
+json::Document MakeGridCityDocument(int side) {
+    json::Array base;
+    auto name = [](int row, int column) {
+        return "Stop " + std::to_string(row) + "-" + std::to_string(column);
+    };
+    for (int row = 0; row < side; ++row) {
+        for (int column = 0; column < side; ++column) {
+            json::Dict distances;
+            if (column + 1 < side) {
+                distances[name(row, column + 1)] = 400 + 13 * ((row + column) % 7);
+            }
+            if (row + 1 < side) {
+                distances[name(row + 1, column)] = 500 + 11 * ((row * column) % 5);
+            }
+            base.push_back(json::Builder{}.StartDict()
+                               .Key("type").Value("Stop")
+                               .Key("name").Value(name(row, column))
+                               .Key("latitude").Value(55.6 + 0.01 * row)
+                               .Key("longitude").Value(37.5 + 0.01 * column)
+                               .Key("road_distances").Value(distances)
+                               .EndDict().Build());
+        }
+    }
+    for (int line = 0; line < side; ++line) {
+        json::Array horizontal;
+        json::Array vertical;
+        for (int i = 0; i < side; ++i) {
+            horizontal.push_back(name(line, i));
+            vertical.push_back(name(i, line));
+        }
+        base.push_back(json::Builder{}.StartDict().Key("type").Value("Bus").Key("name").Value("H" + std::to_string(line))
+                           .Key("stops").Value(horizontal).Key("is_roundtrip").Value(false).EndDict().Build());
+        base.push_back(json::Builder{}.StartDict().Key("type").Value("Bus").Key("name").Value("V" + std::to_string(line))
+                           .Key("stops").Value(vertical).Key("is_roundtrip").Value(false).EndDict().Build());
+    }
+    json::Array requests;
+    int id = 1;
+    for (int row = 0; row < side; ++row) {
+        requests.push_back(json::Builder{}.StartDict().Key("id").Value(id++).Key("type").Value("Bus").Key("name").Value("H" + std::to_string(row)).EndDict().Build());
+        requests.push_back(json::Builder{}.StartDict().Key("id").Value(id++).Key("type").Value("Stop").Key("name").Value(name(row, row)).EndDict().Build());
+        for (int column = 0; column < side; column += 3) {
+            requests.push_back(json::Builder{}.StartDict().Key("id").Value(id++).Key("type").Value("Route")
+                                   .Key("from").Value(name(row, 0)).Key("to").Value(name(side - 1 - column, column)).EndDict().Build());
+        }
+    }
+    requests.push_back(json::Builder{}.StartDict().Key("id").Value(id++).Key("type").Value("Map").EndDict().Build());
+    return MakeCityDocument(std::move(base), std::move(requests));
+}
+
+json::Document MakeRandomCityDocument(const CityParams &params) {
+    std::mt19937 generator(params.seed);
+    std::uniform_real_distribution<double> jitter(-0.3, 0.3);
+    const size_t count = std::max<size_t>(params.stops_count, 2);
+    const auto side = static_cast<size_t>(std::ceil(std::sqrt(static_cast<double>(count))));
+    std::vector<geo::Coordinates> coordinates(count);
+    for (size_t i = 0; i < count; ++i) {
+        coordinates[i] = {55.6 + 0.005 * (static_cast<double>(i / side) + jitter(generator)),
+                          37.4 + 0.008 * (static_cast<double>(i % side) + jitter(generator))};
+    }
+    auto stop_name = [](size_t stop) {
+        return "Stop " + std::to_string(stop);
+    };
+    // соседние узлы сетки, включая диагональные
+    auto neighbours = [&](size_t stop) {
+        std::vector<size_t> result;
+        const auto row = static_cast<std::ptrdiff_t>(stop / side);
+        const auto column = static_cast<std::ptrdiff_t>(stop % side);
+        for (std::ptrdiff_t dr = -1; dr <= 1; ++dr) {
+            for (std::ptrdiff_t dc = -1; dc <= 1; ++dc) {
+                const auto r = row + dr;
+                const auto c = column + dc;
+                if ((dr || dc) && r >= 0 && c >= 0 && c < static_cast<std::ptrdiff_t>(side)
+                    && static_cast<size_t>(r) * side + static_cast<size_t>(c) < count) {
+                    result.push_back(static_cast<size_t>(r) * side + static_cast<size_t>(c));
+                }
+            }
+        }
+        return result;
+    };
+
+    // дорожное расстояние длиннее прямого в 1.1-1.5 раза, задаётся один раз для пары остановок
+    std::vector<std::map<size_t, int>> distances(count);
+    std::uniform_real_distribution<double> detour(1.1, 1.5);
+    auto add_distance = [&](size_t from, size_t to) {
+        if (from != to && !distances[from].count(to) && !distances[to].count(from)) {
+            distances[from][to] = static_cast<int>(geo::ComputeDistance(coordinates[from], coordinates[to]) * detour(generator)) + 1;
+        }
+    };
+
+    std::uniform_int_distribution<size_t> any_stop(0, count - 1);
+    std::bernoulli_distribution is_roundtrip(params.roundtrip_ratio);
+    const size_t route_length = std::max<size_t>(params.route_length, 2);
+    std::vector<bool> used(count, false);
+    json::Array buses;
+    for (size_t bus = 0; bus < params.buses_count; ++bus) {
+        const bool roundtrip = is_roundtrip(generator) && route_length > 2;
+        std::vector<size_t> stops{any_stop(generator)};
+        // блуждание без немедленного возврата на предыдущую остановку
+        while (stops.size() < (roundtrip ? route_length - 1 : route_length)) {
+            auto options = neighbours(stops.back());
+            if (stops.size() > 1 && options.size() > 1) {
+                options.erase(std::find(options.begin(), options.end(), stops[stops.size() - 2]));
+            }
+            stops.push_back(options[std::uniform_int_distribution<size_t>(0, options.size() - 1)(generator)]);
+        }
+        // блуждание могло само вернуться в начало, тогда кольцо уже замкнуто
+        if (roundtrip && stops.back() != stops.front()) {
+            stops.push_back(stops.front());
+        }
+        json::Array names;
+        for (size_t i = 0; i < stops.size(); ++i) {
+            used[stops[i]] = true;
+            names.push_back(stop_name(stops[i]));
+            if (i > 0) {
+                add_distance(stops[i - 1], stops[i]);
+            }
+        }
+        buses.push_back(json::Builder{}.StartDict().Key("type").Value("Bus").Key("name").Value("Bus " + std::to_string(bus))
+                            .Key("stops").Value(std::move(names)).Key("is_roundtrip").Value(roundtrip).EndDict().Build());
+    }
+
+    json::Array base;
+    for (size_t stop = 0; stop < count; ++stop) {
+        json::Dict road_distances;
+        for (const auto &[to, distance] : distances[stop]) {
+            road_distances[stop_name(to)] = distance;
+        }
+        base.push_back(json::Builder{}.StartDict()
+                           .Key("type").Value("Stop")
+                           .Key("name").Value(stop_name(stop))
+                           .Key("latitude").Value(coordinates[stop].lat)
+                           .Key("longitude").Value(coordinates[stop].lng)
+                           .Key("road_distances").Value(std::move(road_distances))
+                           .EndDict().Build());
+    }
+    for (auto &bus : buses) {
+        base.push_back(std::move(bus));
+    }
+
+    // запросы Stop и Route - по остановкам, через которые проходят маршруты
+    std::vector<size_t> served;
+    for (size_t stop = 0; stop < count; ++stop) {
+        if (used[stop]) {
+            served.push_back(stop);
+        }
+    }
+    std::uniform_int_distribution<size_t> any_served(0, served.size() - 1);
+    std::uniform_int_distribution<size_t> any_bus(0, std::max<size_t>(params.buses_count, 1) - 1);
+    json::Array requests;
+    int id = 1;
+    for (size_t i = 0; i < params.requests.bus; ++i) {
+        requests.push_back(json::Builder{}.StartDict().Key("id").Value(id++).Key("type").Value("Bus")
+                               .Key("name").Value("Bus " + std::to_string(any_bus(generator))).EndDict().Build());
+    }
+    for (size_t i = 0; i < params.requests.stop; ++i) {
+        requests.push_back(json::Builder{}.StartDict().Key("id").Value(id++).Key("type").Value("Stop")
+                               .Key("name").Value(stop_name(served[any_served(generator)])).EndDict().Build());
+    }
+    for (size_t i = 0; i < params.requests.route; ++i) {
+        const size_t from = served[any_served(generator)];
+        const size_t to = served[any_served(generator)];
+        requests.push_back(json::Builder{}.StartDict().Key("id").Value(id++).Key("type").Value("Route")
+                               .Key("from").Value(stop_name(from)).Key("to").Value(stop_name(to)).EndDict().Build());
+    }
+    for (size_t i = 0; i < params.requests.map; ++i) {
+        requests.push_back(json::Builder{}.StartDict().Key("id").Value(id++).Key("type").Value("Map").EndDict().Build());
+    }
+    return MakeCityDocument(std::move(base), std::move(requests));
+}
+
+} // namespace bench
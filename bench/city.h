@@ -0,0 +1,38 @@
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+
+#include "json.h"
+
+namespace bench {
+
+// Город-сетка side x side остановок: линейные маршруты по каждой строке и столбцу,
+// запросы всех типов и настройки отрисовки и маршрутизации
+json::Document MakeGridCityDocument(int side);
+
+// число запросов каждого типа в stat_requests
+struct RequestMix {
+    size_t bus = 0;
+    size_t stop = 0;
+    size_t route = 0;
+    size_t map = 0;
+};
+
+struct CityParams {
+    size_t stops_count = 1000;
+    size_t buses_count = 100;
+    // число остановок в маршруте, включая повтор первой у кольцевого
+    size_t route_length = 20;
+    // доля кольцевых маршрутов
+    double roundtrip_ratio = 0.3;
+    RequestMix requests;
+    uint32_t seed = 1;
+};
+
+// Случайный город, одинаковый при одинаковых параметрах: остановки на сетке со случайным сдвигом,
+// маршруты - случайные блуждания по соседним узлам сетки. Дорожные расстояния задаются для всех
+// соседних остановок маршрутов, запросы Bus, Stop и Route выбираются среди остановок и маршрутов города
+json::Document MakeRandomCityDocument(const CityParams &params);
+
+} // namespace bench
@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <cmath>
+#include <random>
+#include <vector>
+
+#include "bench.h"
+#include "geo.h"
+
+void RunGeoBench(std::ostream &out) {
+    // отрезки в пределах города, как в маршрутах автобусов
+    const size_t points_count = 1 << 16;
+    std::mt19937 generator(42);
+    std::uniform_real_distribution<double> lat(55.5, 55.9);
+    std::uniform_real_distribution<double> lng(37.3, 37.8);
+    std::vector<geo::Coordinates> points(points_count + 1);
+    for (auto &point : points) {
+        point = {lat(generator), lng(generator)};
+    }
+    std::vector<geo::PreparedCoordinates> prepared(points.size());
+    std::transform(points.begin(), points.end(), prepared.begin(), geo::PrepareCoordinates);
+    std::vector<double> distances(points_count);
+
+    const size_t repeats = 50;
+    bench::PrintResult(out, bench::Measure("ComputeDistance (coordinates)", repeats, points_count, [&] {
+        for (size_t i = 0; i < points_count; ++i) {
+            distances[i] = geo::ComputeDistance(points[i], points[i + 1]);
+        }
+        bench::DoNotOptimize(distances.back());
+    }));
+    bench::PrintResult(out, bench::Measure("ComputeDistancesScalar (prepared)", repeats, points_count, [&] {
+        geo::ComputeDistancesScalar(prepared.data(), prepared.data() + 1, distances.data(), points_count);
+        bench::DoNotOptimize(distances.back());
+    }));
+    bench::PrintResult(out, bench::Measure(geo::IsVectorizedDistanceAvailable() ? "ComputeDistances (avx2)" : "ComputeDistances (scalar fallback)",
+                                           repeats, points_count, [&] {
+        geo::ComputeDistances(prepared.data(), prepared.data() + 1, distances.data(), points_count);
+        bench::DoNotOptimize(distances.back());
+    }));
+
+    // сверка точности пакетного расчёта с исходной формулой и со скалярным вариантом
+    std::vector<double> scalar_distances(points_count);
+    geo::ComputeDistancesScalar(prepared.data(), prepared.data() + 1, scalar_distances.data(), points_count);
+    double max_error_vs_original = 0.;
+    double max_error_vs_scalar = 0.;
+    for (size_t i = 0; i < points_count; ++i) {
+        const double expected = geo::ComputeDistance(points[i], points[i + 1]);
+        max_error_vs_original = std::max(max_error_vs_original, std::abs(distances[i] - expected) / expected);
+        max_error_vs_scalar = std::max(max_error_vs_scalar, std::abs(distances[i] - scalar_distances[i]) / scalar_distances[i]);
+    }
+    out << "max relative error vs ComputeDistance: " << max_error_vs_original << std::endl;
+    out << "max relative error vs scalar kernel:   " << max_error_vs_scalar << std::endl;
+
+    // Граничные случаи: совпадающие и почти противоположные точки, где косинус угла может выйти за [-1, 1].
+    // Векторный и скалярный пути должны давать одно и то же число, без NaN
+    std::vector<geo::Coordinates> edge_from;
+    std::vector<geo::Coordinates> edge_to;
+    for (size_t i = 0; i < 64; ++i) {
+        const geo::Coordinates point = {lat(generator), lng(generator)};
+        edge_from.push_back(point);
+        edge_to.push_back(point);
+        edge_from.push_back(point);
+        edge_to.push_back({-point.lat, point.lng - 180.});
+        edge_from.push_back(point);
+        edge_to.push_back({-point.lat + 1e-9, point.lng + 180. - 1e-9});
+    }
+    edge_from.push_back({0., 0.});
+    edge_to.push_back({0., 180.});
+    edge_from.push_back({90., 0.});
+    edge_to.push_back({-90., 0.});
+    const size_t edge_count = edge_from.size();
+    std::vector<geo::PreparedCoordinates> prepared_from(edge_count);
+    std::vector<geo::PreparedCoordinates> prepared_to(edge_count);
+    std::transform(edge_from.begin(), edge_from.end(), prepared_from.begin(), geo::PrepareCoordinates);
+    std::transform(edge_to.begin(), edge_to.end(), prepared_to.begin(), geo::PrepareCoordinates);
+    std::vector<double> dispatched(edge_count);
+    std::vector<double> scalar(edge_count);
+    geo::ComputeDistances(prepared_from.data(), prepared_to.data(), dispatched.data(), edge_count);
+    geo::ComputeDistancesScalar(prepared_from.data(), prepared_to.data(), scalar.data(), edge_count);
+    size_t mismatches = 0;
+    for (size_t i = 0; i < edge_count; ++i) {
+        const double original = geo::ComputeDistance(edge_from[i], edge_to[i]);
+        const bool same = edge_from[i] == edge_to[i];
+        const auto close = [&](double value) {
+            return std::isfinite(value) && (same ? value == 0. : std::abs(value - original) <= 1e-9 * original);
+        };
+        if (!std::isfinite(original) || !close(dispatched[i]) || !close(scalar[i])) {
+            ++mismatches;
+        }
+    }
+    out << "identical and near-antipodal points differing between paths: " << mismatches << " of " << edge_count << std::endl;
+    if (mismatches) {
+        bench::MarkFailed();
+    }
+}
@@ -0,0 +1,57 @@
+#include <algorithm>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "city.h"
+#include "json_reader.h"
+#include "transport_router.h"
+
+namespace {
+bool SameGraphs(const graph::DirectedWeightedGraph<double> &lhs, const graph::DirectedWeightedGraph<double> &rhs) {
+    if (lhs.GetVertexCount() != rhs.GetVertexCount() || lhs.GetEdgeCount() != rhs.GetEdgeCount()) {
+        return false;
+    }
+    for (graph::EdgeId edge_id = 0; edge_id < lhs.GetEdgeCount(); ++edge_id) {
+        const auto &a = lhs.GetEdge(edge_id);
+        const auto &b = rhs.GetEdge(edge_id);
+        if (a.name != b.name || a.span != b.span || a.from != b.from || a.to != b.to || a.weight != b.weight) {
+            return false;
+        }
+    }
+    for (graph::VertexId vertex = 0; vertex < lhs.GetVertexCount(); ++vertex) {
+        const auto a = lhs.GetIncidentEdges(vertex);
+        const auto b = rhs.GetIncidentEdges(vertex);
+        if (!std::equal(a.begin(), a.end(), b.begin(), b.end())) {
+            return false;
+        }
+    }
+    return true;
+}
+} // namespace
+
+// Масштабирование построения графа по числу потоков на большой сетке; таблица маршрутов не строится
+void RunGraphBuildBench(std::ostream &out) {
+    const int side = 60;
+    const auto document = bench::MakeGridCityDocument(side);
+    const auto &root = document.GetRoot().AsDict();
+    const auto &routing = root.at("routing_settings").AsDict();
+    TransportCatalogue catalogue;
+    LoadCatalogue(catalogue, root.at("base_requests").AsArray());
+
+    router::TransportRouter reference(routing.at("bus_wait_time").AsInt(), routing.at("bus_velocity").AsDouble());
+    reference.BuildGraph(catalogue, 1);
+    out << "grid " << side << "x" << side << ": " << reference.GetGraph().GetVertexCount() << " vertices, "
+        << reference.GetGraph().GetEdgeCount() << " edges, " << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+    const size_t max_threads = std::max(8u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        router::TransportRouter router(routing.at("bus_wait_time").AsInt(), routing.at("bus_velocity").AsDouble());
+        bench::PrintResult(out, bench::Measure("BuildGraph, " + std::to_string(threads) + " thread(s)", 5,
+                                               reference.GetGraph().GetEdgeCount(), [&] {
+            router.BuildGraph(catalogue, threads);
+        }));
+        out << "  same graph as single-threaded build: " << (SameGraphs(router.GetGraph(), reference.GetGraph()) ? "yes" : "NO") << std::endl;
+    }
+}
@@ -0,0 +1,104 @@
+#include <cmath>
+#include <memory>
+#include <random>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+#include "city.h"
+#include "hub_labels.h"
+#include "json_reader.h"
+#include "transport_router.h"
+
+namespace {
+void RunHubLabelsCity(std::ostream &out, const std::string &name, const bench::CityParams &params) {
+    const std::string prefix = name + ": ";
+    const auto document = bench::MakeRandomCityDocument(params);
+    const auto &root = document.GetRoot().AsDict();
+    const auto &routing = root.at("routing_settings").AsDict();
+    TransportCatalogue catalogue;
+    LoadCatalogue(catalogue, root.at("base_requests").AsArray());
+    router::TransportRouter graph_builder(routing.at("bus_wait_time").AsInt(), routing.at("bus_velocity").AsDouble());
+    graph_builder.BuildGraph(catalogue);
+    const auto &graph = graph_builder.GetGraph();
+    const size_t vertex_count = graph.GetVertexCount();
+    out << name << " city: " << vertex_count << " vertices, " << graph.GetEdgeCount() << " edges" << std::endl;
+
+    std::unique_ptr<graph::Router<double>> table;
+    bench::PrintResult(out, bench::Measure(prefix + "Router precompute", 1, vertex_count, [&] {
+        table = std::make_unique<graph::Router<double>>(graph);
+    }));
+    std::unique_ptr<graph::HubLabels> labels;
+    bench::PrintResult(out, bench::Measure(prefix + "HubLabels build", 1, vertex_count, [&] {
+        labels = std::make_unique<graph::HubLabels>(graph);
+    }));
+    const size_t table_bytes = table->GetRoutesInternalData().GetCellCount() * sizeof(graph::Router<double>::RouteInternalData);
+    out << prefix << "labels: " << static_cast<double>(labels->GetEntriesCount()) / (2. * static_cast<double>(vertex_count))
+        << " entries per vertex and direction, " << (labels->GetMemoryBytes() >> 10) << " KiB; routes table " << (table_bytes >> 10)
+        << " KiB" << std::endl;
+
+    // запросы между вершинами ожидания остановок, как у запросов Route
+    const auto &stop_vertices = graph_builder.GetStopVertices();
+    std::mt19937 generator(params.seed);
+    std::uniform_int_distribution<size_t> stop_index(0, stop_vertices.size() - 1);
+    std::vector<std::pair<graph::VertexId, graph::VertexId>> queries(1 << 14);
+    for (auto &[from, to] : queries) {
+        from = stop_vertices[stop_index(generator)];
+        to = stop_vertices[stop_index(generator)];
+    }
+    bench::PrintResult(out, bench::Measure(prefix + "Router::GetRouteWeight", 10, queries.size(), [&] {
+        for (const auto &[from, to] : queries) {
+            bench::DoNotOptimize(table->GetRouteWeight(from, to));
+        }
+    }));
+    bench::PrintResult(out, bench::Measure(prefix + "HubLabels::GetDistance", 10, queries.size(), [&] {
+        for (const auto &[from, to] : queries) {
+            bench::DoNotOptimize(labels->GetDistance(from, to));
+        }
+    }));
+    graph::Router<double>::RouteEdges edges;
+    bench::PrintResult(out, bench::Measure(prefix + "Router::BuildRoute", 10, queries.size(), [&] {
+        for (const auto &[from, to] : queries) {
+            bench::DoNotOptimize(table->BuildRoute(from, to, edges));
+        }
+    }));
+    bench::PrintResult(out, bench::Measure(prefix + "HubLabels::BuildRoute", 1, queries.size(), [&] {
+        for (const auto &[from, to] : queries) {
+            bench::DoNotOptimize(labels->BuildRoute(from, to, edges));
+        }
+    }));
+
+    // время совпадает с таблицей, восстановленный маршрут непрерывен и имеет то же время
+    size_t mismatches = 0;
+    for (const auto &[from, to] : queries) {
+        const auto expected = table->GetRouteWeight(from, to);
+        const auto distance = labels->GetDistance(from, to);
+        const auto route_weight = labels->BuildRoute(from, to, edges);
+        if (expected.has_value() != distance.has_value() || expected.has_value() != route_weight.has_value()) {
+            ++mismatches;
+            continue;
+        }
+        if (!expected) {
+            continue;
+        }
+        graph::VertexId vertex = from;
+        for (const auto &[edge_id, edge] : edges) {
+            mismatches += edge->from != vertex;
+            vertex = edge->to;
+        }
+        mismatches += vertex != to || std::abs(*distance - *expected) > 1e-9 * (1. + *expected)
+                      || std::abs(*route_weight - *expected) > 1e-9 * (1. + *expected);
+    }
+    out << prefix << "queries differing from the routes table: " << mismatches << std::endl;
+    if (mismatches) {
+        bench::MarkFailed();
+    }
+}
+} // namespace
+
+// Двухточечная разметка против таблицы маршрутизатора: размер, время построения и запросов
+void RunHubLabelsBench(std::ostream &out) {
+    RunHubLabelsCity(out, "small", {300, 40, 12, 0.3, {}, 1});
+    RunHubLabelsCity(out, "medium", {800, 120, 20, 0.3, {}, 2});
+}
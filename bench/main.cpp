@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <fstream>
+#include <functional>
+#include <iostream>
+#include <string>
+#include <utility>
+#include <vector>
+
+#include "bench.h"
+
+// наборы бенчмарков, реализованы в соседних файлах
+void RunGeoBench(std::ostream &out);
+void RunCatalogueBench(std::ostream &out);
+void RunNamesBench(std::ostream &out);
+void RunRouterLookupBench(std::ostream &out);
+void RunSnapshotBench(std::ostream &out);
+void RunServerBench(std::ostream &out);
+void RunUpdateBench(std::ostream &out);
+void RunVersionsBench(std::ostream &out);
+void RunGraphBuildBench(std::ostream &out);
+void RunAllPairsBench(std::ostream &out);
+void RunMatrixBench(std::ostream &out);
+void RunTimetableBench(std::ostream &out);
+void RunParetoBench(std::ostream &out);
+void RunRouteCacheBench(std::ostream &out);
+void RunPipelineBench(std::ostream &out);
+void RunAllocationBench(std::ostream &out);
+void RunHubLabelsBench(std::ostream &out);
+void RunAStarBench(std::ostream &out);
+void RunBatchRoutesBench(std::ostream &out);
+
+int main(int argc, char **argv) {
+    const std::vector<std::pair<std::string, std::function<void(std::ostream &)>>> suites = {
+        {"geo", RunGeoBench},
+        {"catalogue", RunCatalogueBench},
+        {"names", RunNamesBench},
+        {"router_lookup", RunRouterLookupBench},
+        {"snapshot", RunSnapshotBench},
+        {"server", RunServerBench},
+        {"updates", RunUpdateBench},
+        {"versions", RunVersionsBench},
+        {"graph_build", RunGraphBuildBench},
+        {"all_pairs", RunAllPairsBench},
+        {"matrix", RunMatrixBench},
+        {"timetable", RunTimetableBench},
+        {"pareto", RunParetoBench},
+        {"route_cache", RunRouteCacheBench},
+        {"pipeline", RunPipelineBench},
+        {"allocations", RunAllocationBench},
+        {"hub_labels", RunHubLabelsBench},
+        {"astar", RunAStarBench},
+        {"batch_routes", RunBatchRoutesBench},
+    };
+    // без аргументов выполняются все наборы, иначе только перечисленные;
+    // --json=FILE дополнительно записывает все замеры в FILE
+    const std::string json_option = "--json=";
+    std::string json_path;
+    std::vector<std::string> selected;
+    for (int i = 1; i < argc; ++i) {
+        const std::string arg = argv[i];
+        if (arg.compare(0, json_option.size(), json_option) == 0) {
+            json_path = arg.substr(json_option.size());
+        } else {
+            selected.push_back(arg);
+        }
+    }
+    for (const auto &[name, run] : suites) {
+        if (!selected.empty() && std::find(selected.begin(), selected.end(), name) == selected.end()) {
+            continue;
+        }
+        std::cout << "== " << name << " ==" << std::endl;
+        bench::BeginSuite(name);
+        run(std::cout);
+    }
+    if (!json_path.empty()) {
+        std::ofstream json_output(json_path);
+        if (!json_output) {
+            std::cerr << "Cannot open " << json_path << std::endl;
+            return 1;
+        }
+        bench::PrintRecordedResults(json_output);
+    }
+    return bench::HasFailed() ? 1 : 0;
+}
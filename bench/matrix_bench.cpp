@@ -0,0 +1,84 @@
+#include <algorithm>
+#include <cmath>
+#include <optional>
+#include <string>
+#include <string_view>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "city.h"
+#include "json_reader.h"
+#include "transport_router.h"
+
+namespace {
+using TravelTimes = std::vector<std::vector<std::optional<double>>>;
+
+// суммы весов по разным путям одинаковой длины могут отличаться в последних знаках
+size_t CountMismatches(const TravelTimes &lhs, const TravelTimes &rhs) {
+    size_t mismatches = 0;
+    for (size_t row = 0; row < lhs.size(); ++row) {
+        for (size_t column = 0; column < lhs[row].size(); ++column) {
+            const auto &a = lhs[row][column];
+            const auto &b = rhs[row][column];
+            mismatches += a.has_value() != b.has_value() || (a && std::abs(*a - *b) > 1e-9 * std::max(1., *a));
+        }
+    }
+    return mismatches;
+}
+} // namespace
+
+// Матрица времени в пути: таблица маршрутов, поиски из каждой исходной остановки и маршруты по каждой паре
+void RunMatrixBench(std::ostream &out) {
+    const int side = 30;
+    const auto document = bench::MakeGridCityDocument(side);
+    const auto &root = document.GetRoot().AsDict();
+    const auto &routing = root.at("routing_settings").AsDict();
+    TransportCatalogue catalogue;
+    LoadCatalogue(catalogue, root.at("base_requests").AsArray());
+    const int wait_time = routing.at("bus_wait_time").AsInt();
+    const double velocity = routing.at("bus_velocity").AsDouble();
+
+    const router::TransportRouter table_router(catalogue, wait_time, velocity);
+    router::TransportRouter graph_router(wait_time, velocity);
+    graph_router.BuildGraph(catalogue);
+
+    // остановки вразброс по сетке, одна неизвестная в каждом списке
+    const size_t matrix_side = 64;
+    std::vector<std::string> origin_names;
+    std::vector<std::string> destination_names;
+    for (size_t i = 0; i + 1 < matrix_side; ++i) {
+        origin_names.push_back("Stop " + std::to_string(i * 7 % side) + "-" + std::to_string(i * 13 % side));
+        destination_names.push_back("Stop " + std::to_string(i * 11 % side) + "-" + std::to_string(i * 5 % side));
+    }
+    origin_names.push_back("Unknown");
+    destination_names.push_back("Unknown");
+    const std::vector<std::string_view> origins(origin_names.begin(), origin_names.end());
+    const std::vector<std::string_view> destinations(destination_names.begin(), destination_names.end());
+    const size_t pairs = origins.size() * destinations.size();
+    out << "grid " << side << "x" << side << ", " << origins.size() << "x" << destinations.size() << " matrix, "
+        << std::thread::hardware_concurrency() << " hardware threads" << std::endl;
+
+    TravelTimes from_table;
+    bench::PrintResult(out, bench::Measure("matrix from routes table", 20, pairs, [&] {
+        from_table = table_router.GetTravelTimes(origins, destinations);
+    }));
+    TravelTimes from_routes(origins.size(), std::vector<std::optional<double>>(destinations.size()));
+    bench::PrintResult(out, bench::Measure("CreateRoute per pair", 20, pairs, [&] {
+        for (size_t row = 0; row < origins.size(); ++row) {
+            for (size_t column = 0; column < destinations.size(); ++column) {
+                const auto route = table_router.CreateRoute(origins[row], destinations[column]);
+                from_routes[row][column] = route ? std::optional<double>(route->weight) : std::nullopt;
+            }
+        }
+    }));
+    const size_t max_threads = std::max(4u, std::thread::hardware_concurrency());
+    for (size_t threads = 1; threads <= max_threads; threads *= 2) {
+        TravelTimes from_search;
+        bench::PrintResult(out, bench::Measure("one-to-many search, " + std::to_string(threads) + " thread(s)", 5, pairs, [&] {
+            from_search = graph_router.GetTravelTimes(origins, destinations, threads);
+        }));
+        out << "  mismatches with routes table: " << CountMismatches(from_search, from_table) << std::endl;
+    }
+    out << "mismatches between table and per-pair routes: " << CountMismatches(from_table, from_routes) << std::endl;
+}
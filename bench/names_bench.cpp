@@ -0,0 +1,68 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+namespace {
+// память под std::string с таким содержимым (libstdc++: SSO до 15 символов)
+size_t StringBytes(std::string_view value) {
+    return sizeof(std::string) + (value.size() > 15 ? value.size() + 1 : 0);
+}
+} // namespace
+
+void RunNamesBench(std::ostream &out) {
+    const size_t stops_count = 5000;
+    const size_t buses_count = 500;
+    const size_t route_length = 25;
+    std::mt19937 generator(3);
+    std::uniform_int_distribution<size_t> stop_index(0, stops_count - 1);
+
+    TransportCatalogue catalogue;
+    std::vector<std::string> stop_names;
+    for (size_t i = 0; i < stops_count; ++i) {
+        stop_names.push_back("Street " + std::to_string(i) + " / Avenue " + std::to_string(i * 7 % 1000));
+        catalogue.AddStop(stop_names.back(), {55.5 + 0.4 * i / stops_count, 37.3 + 0.5 * (i % 97) / 97.});
+    }
+    for (size_t i = 0; i < buses_count; ++i) {
+        std::vector<std::string_view> route;
+        for (size_t j = 0; j < route_length; ++j) {
+            route.push_back(stop_names[stop_index(generator)]);
+        }
+        for (size_t j = 1; j < route.size(); ++j) {
+            catalogue.SetDistance(route[j - 1], route[j], 1000.);
+        }
+        catalogue.AddBus("Express route " + std::to_string(i), route, true);
+    }
+    router::TransportRouter router;
+    router.BuildGraph(catalogue);
+
+    // прежняя схема: собственная копия имени в остановке, маршруте, каждом ребре графа и ключе stop_ids_
+    size_t legacy_bytes = 0;
+    size_t references = 0;
+    for (const auto &[name, stop] : catalogue.GetAllStopsList()) {
+        legacy_bytes += 2 * StringBytes(name);
+        references += 2;
+    }
+    for (const auto &[name, bus] : catalogue.GetAllRoutes()) {
+        legacy_bytes += StringBytes(name);
+        ++references;
+    }
+    const auto &graph = router.GetGraph();
+    for (graph::EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        legacy_bytes += StringBytes(graph.GetEdge(edge_id).name);
+        ++references;
+    }
+
+    const auto usage = catalogue.GetNamePool().GetMemoryUsage();
+    const size_t pooled_bytes = usage.arena_bytes + usage.index_bytes + references * sizeof(std::string_view);
+    out << "unique names:           " << usage.names_count << std::endl;
+    out << "name references:        " << references << std::endl;
+    out << "graph edges:            " << graph.GetEdgeCount() << std::endl;
+    out << "per-copy std::string:   " << legacy_bytes << " bytes" << std::endl;
+    out << "interned (arena+index+views): " << pooled_bytes << " bytes (arena "
+        << usage.arena_bytes << ", used " << usage.used_bytes << ", index " << usage.index_bytes << ")" << std::endl;
+    out << "saved:                  " << static_cast<long long>(legacy_bytes) - static_cast<long long>(pooled_bytes) << " bytes" << std::endl;
+}
@@ -0,0 +1,74 @@
+#include <cmath>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "city.h"
+#include "json_reader.h"
+#include "transport_router.h"
+
+// Маршруты, оптимальные по времени и числу пересадок: задержка, размер множества Парето
+// и сверка самого быстрого варианта с однокритериальным маршрутом
+void RunParetoBench(std::ostream &out) {
+    const int side = 30;
+    const auto document = bench::MakeGridCityDocument(side);
+    const auto &root = document.GetRoot().AsDict();
+    const auto &routing = root.at("routing_settings").AsDict();
+    TransportCatalogue catalogue;
+    LoadCatalogue(catalogue, root.at("base_requests").AsArray());
+    std::mt19937 generator(23);
+    std::uniform_int_distribution<int> coordinate(0, side - 1);
+    // извилистые маршруты по соседним остановкам: доехать без пересадок можно, но дольше, чем по прямым линиям
+    std::vector<std::string> stop_names;
+    for (int bus = 0; bus < 30; ++bus) {
+        int row = coordinate(generator);
+        int column = coordinate(generator);
+        stop_names.clear();
+        for (int step = 0; step < 60; ++step) {
+            stop_names.push_back("Stop " + std::to_string(row) + "-" + std::to_string(column));
+            const bool vertical = generator() % 2 != 0;
+            int &position = vertical ? row : column;
+            position = position == 0 ? 1 : position == side - 1 ? side - 2 : position + (generator() % 2 != 0 ? 1 : -1);
+        }
+        catalogue.AddBus("Snake " + std::to_string(bus), std::vector<std::string_view>(stop_names.begin(), stop_names.end()), true);
+    }
+    catalogue.RefreshStatistics();
+    const router::TransportRouter router(catalogue, routing.at("bus_wait_time").AsInt(), routing.at("bus_velocity").AsDouble());
+
+    std::vector<std::pair<std::string, std::string>> queries(500);
+    for (auto &[from, to] : queries) {
+        from = "Stop " + std::to_string(coordinate(generator)) + "-" + std::to_string(coordinate(generator));
+        to = "Stop " + std::to_string(coordinate(generator)) + "-" + std::to_string(coordinate(generator));
+    }
+    const size_t vertex_count = router.GetGraph().GetVertexCount();
+    out << "grid " << side << "x" << side << ": " << vertex_count << " vertices" << std::endl;
+
+    for (const size_t max_rides : {2u, 4u, 0u}) {
+        size_t routes_count = 0;
+        size_t fastest_mismatches = 0;
+        bench::PrintResult(out, bench::Measure("Pareto routes, max rides " + (max_rides ? std::to_string(max_rides) : std::string("unbounded")),
+                                               1, queries.size(), [&] {
+            for (const auto &[from, to] : queries) {
+                const auto routes = router.CreateParetoRoutes(from, to, max_rides);
+                routes_count += routes.size();
+                // без ограничения последний вариант - самый быстрый маршрут вообще
+                if (max_rides == 0) {
+                    const auto fastest = router.CreateRoute(from, to);
+                    fastest_mismatches += routes.empty() != !fastest
+                                          || (fastest && std::abs(routes.back().weight - fastest->weight) > 1e-9 * (1. + fastest->weight));
+                }
+            }
+        }));
+        out << "  routes per query: " << static_cast<double>(routes_count) / static_cast<double>(queries.size());
+        if (max_rides == 0) {
+            out << ", fastest differs from single-criterion route: " << fastest_mismatches;
+        }
+        out << std::endl;
+    }
+    bench::PrintResult(out, bench::Measure("single-criterion CreateRoute", 1, queries.size(), [&] {
+        for (const auto &[from, to] : queries) {
+            bench::DoNotOptimize(router.CreateRoute(from, to));
+        }
+    }));
+}
@@ -0,0 +1,91 @@
+#include <memory>
+#include <sstream>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "city.h"
+#include "json_reader.h"
+#include "transport_router.h"
+
+namespace {
+struct CityPreset {
+    std::string name;
+    bench::CityParams params;
+};
+
+void RunPipeline(std::ostream &out, const CityPreset &preset) {
+    const std::string prefix = preset.name + ": ";
+    std::ostringstream text;
+    json::Print(bench::MakeRandomCityDocument(preset.params), text);
+    const std::string input = text.str();
+
+    json::Document document{nullptr};
+    bench::PrintResult(out, bench::Measure(prefix + "parse", 1, input.size(), [&] {
+        std::istringstream stream(input);
+        document = json::Load(stream);
+    }));
+    const auto &root = document.GetRoot().AsDict();
+    const auto &base_requests = root.at("base_requests").AsArray();
+    const auto &stat_requests = root.at("stat_requests").AsArray();
+    const auto &routing = root.at("routing_settings").AsDict();
+    const int wait_time = routing.at("bus_wait_time").AsInt();
+    const double velocity = routing.at("bus_velocity").AsDouble();
+
+    TransportCatalogue catalogue;
+    bench::PrintResult(out, bench::Measure(prefix + "catalogue build", 1, base_requests.size(), [&] {
+        LoadCatalogue(catalogue, base_requests);
+    }));
+    router::TransportRouter graph_builder(wait_time, velocity);
+    bench::PrintResult(out, bench::Measure(prefix + "graph build", 1, catalogue.GetAllRoutes().size(), [&] {
+        graph_builder.BuildGraph(catalogue);
+    }));
+    const auto &graph = graph_builder.GetGraph();
+    out << preset.name << " city: " << catalogue.GetStopCount() << " stops, " << catalogue.GetAllRoutes().size() << " buses, "
+        << graph.GetVertexCount() << " vertices, " << graph.GetEdgeCount() << " edges" << std::endl;
+    std::unique_ptr<graph::Router<double>> precomputed;
+    bench::PrintResult(out, bench::Measure(prefix + "router precompute", 1, graph.GetVertexCount() * graph.GetVertexCount(), [&] {
+        precomputed = std::make_unique<graph::Router<double>>(graph);
+    }));
+    precomputed.reset();
+
+    const router::TransportRouter router(catalogue, wait_time, velocity);
+    RenderSets render_sets;
+    FillRenderSets(root.at("render_settings"), render_sets);
+    const RequestHandler req_handler(catalogue, router);
+    MapRenderer renderer(render_sets);
+    // запросы каждого типа замеряются отдельно, Map - отрисовка SVG
+    for (const std::string type : {"Bus", "Stop", "Route", "Map"}) {
+        json::Array requests;
+        for (const auto &req : stat_requests) {
+            if (req.AsDict().at("type").AsString() == type) {
+                requests.push_back(req);
+            }
+        }
+        if (requests.empty()) {
+            continue;
+        }
+        size_t response_size = 0;
+        bench::PrintResult(out, bench::Measure(prefix + type + " queries", 1, requests.size(), [&] {
+            for (const auto &req : requests) {
+                const auto response = GetReqResult(req_handler, req, renderer);
+                response_size += response.AsDict().size();
+            }
+        }));
+        bench::DoNotOptimize(response_size);
+    }
+}
+} // namespace
+
+// Весь путь обработки входа на случайных городах разного размера: разбор JSON, каталог, граф,
+// предрасчёт таблицы маршрутов, запросы каждого типа и отрисовка карты
+void RunPipelineBench(std::ostream &out) {
+    const bench::RequestMix requests{500, 500, 2000, 1};
+    const std::vector<CityPreset> presets = {
+        {"small", {300, 40, 12, 0.3, requests, 1}},
+        {"medium", {800, 120, 20, 0.3, requests, 2}},
+    };
+    for (const auto &preset : presets) {
+        RunPipeline(out, preset);
+    }
+}
@@ -0,0 +1,116 @@
+#include <cmath>
+#include <random>
+#include <sstream>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "city.h"
+#include "json_reader.h"
+#include "request_server.h"
+
+namespace {
+// пакеты запросов Route, пары остановок выбираются по закону Ципфа: k-я по популярности пара - с весом 1 / k^s
+std::vector<json::Array> MakeZipfianBatches(int side, size_t pairs_count, double exponent, size_t batches_count, size_t batch_size) {
+    std::mt19937 generator(29);
+    std::uniform_int_distribution<int> coordinate(0, side - 1);
+    const auto stop_name = [&] {
+        return "Stop " + std::to_string(coordinate(generator)) + "-" + std::to_string(coordinate(generator));
+    };
+    std::vector<std::pair<std::string, std::string>> pairs(pairs_count);
+    std::vector<double> weights(pairs_count);
+    for (size_t k = 0; k < pairs_count; ++k) {
+        pairs[k] = {stop_name(), stop_name()};
+        weights[k] = 1. / std::pow(static_cast<double>(k + 1), exponent);
+    }
+    std::discrete_distribution<size_t> popularity(weights.begin(), weights.end());
+    std::vector<json::Array> batches(batches_count);
+    int request_id = 0;
+    for (auto &batch : batches) {
+        for (size_t i = 0; i < batch_size; ++i) {
+            const auto &[from, to] = pairs[popularity(generator)];
+            batch.push_back(json::Dict{{"id", ++request_id}, {"type", std::string("Route")}, {"from", from}, {"to", to}});
+        }
+    }
+    return batches;
+}
+
+std::vector<json::Document> HandleBatches(server::RequestServer &request_server, const std::vector<json::Array> &batches) {
+    std::vector<json::Document> responses;
+    responses.reserve(batches.size());
+    for (const auto &batch : batches) {
+        responses.push_back(request_server.HandleBatch(batch));
+    }
+    return responses;
+}
+
+std::string PrintResponses(const std::vector<json::Document> &responses) {
+    std::ostringstream output;
+    for (const auto &response : responses) {
+        json::PrintCompact(response, output);
+    }
+    return output.str();
+}
+} // namespace
+
+// Кеш ответов Route на потоке запросов, где немногие пары остановок встречаются очень часто
+void RunRouteCacheBench(std::ostream &out) {
+    const int side = 30;
+    const auto document = bench::MakeGridCityDocument(side);
+    const auto &root = document.GetRoot().AsDict();
+    const auto &routing = root.at("routing_settings").AsDict();
+    TransportCatalogue catalogue;
+    LoadCatalogue(catalogue, root.at("base_requests").AsArray());
+    const router::TransportRouter router(catalogue, routing.at("bus_wait_time").AsInt(), routing.at("bus_velocity").AsDouble());
+    RenderSets render_sets;
+    FillRenderSets(root.at("render_settings"), render_sets);
+    const RequestHandler req_handler(catalogue, router);
+
+    const size_t batches_count = 100;
+    const size_t batch_size = 500;
+    const auto batches = MakeZipfianBatches(side, 20000, 1.1, batches_count, batch_size);
+    const size_t requests_count = batches_count * batch_size;
+
+    // печать ответов от кеша не зависит и в замер не входит
+    std::vector<json::Document> responses;
+    server::RequestServer uncached_server(req_handler, render_sets);
+    bench::PrintResult(out, bench::Measure("Route without cache", 1, requests_count, [&] {
+        responses = HandleBatches(uncached_server, batches);
+    }));
+    const std::string expected = PrintResponses(responses);
+    for (const size_t capacity : {256u, 2048u, 16384u}) {
+        server::RouteCache route_cache(capacity);
+        server::RequestServer cached_server(req_handler, render_sets);
+        cached_server.SetRouteCache(&route_cache);
+        bench::PrintResult(out, bench::Measure("Route with cache of " + std::to_string(capacity), 1, requests_count, [&] {
+            responses = HandleBatches(cached_server, batches);
+        }));
+        const auto stats = route_cache.GetStats();
+        out << "  hit rate " << 100. * static_cast<double>(stats.hits) / static_cast<double>(stats.hits + stats.misses)
+            << "%, " << stats.size << " entries, same responses: " << (PrintResponses(responses) == expected ? "yes" : "NO") << std::endl;
+    }
+
+    // общий кеш для нескольких серверов в разных потоках
+    const size_t threads_count = 4;
+    server::RouteCache shared_cache(2048);
+    std::vector<std::string> outputs(threads_count);
+    std::vector<std::thread> threads;
+    for (size_t i = 0; i < threads_count; ++i) {
+        threads.emplace_back([&, i] {
+            server::RequestServer request_server(req_handler, render_sets);
+            request_server.SetRouteCache(&shared_cache);
+            outputs[i] = PrintResponses(HandleBatches(request_server, batches));
+        });
+    }
+    for (auto &thread : threads) {
+        thread.join();
+    }
+    size_t matched = 0;
+    for (const auto &output : outputs) {
+        matched += output == expected;
+    }
+    const auto stats = shared_cache.GetStats();
+    out << threads_count << " servers sharing one cache: " << stats.hits + stats.misses << " lookups of " << threads_count * requests_count
+        << ", responses matching: " << matched << " of " << threads_count << std::endl;
+}
@@ -0,0 +1,82 @@
+#include <map>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+void RunRouterLookupBench(std::ostream &out) {
+    const size_t stops_count = 300;
+    std::mt19937 generator(11);
+    std::uniform_int_distribution<size_t> stop_index(0, stops_count - 1);
+
+    TransportCatalogue catalogue;
+    std::vector<std::string> stop_names;
+    for (size_t i = 0; i < stops_count; ++i) {
+        stop_names.push_back("Stop " + std::to_string(i) + " near the central square");
+        catalogue.AddStop(stop_names.back(), {55.5 + 0.4 * i / stops_count, 37.3 + 0.5 * (i % 17) / 17.});
+    }
+    for (size_t i = 0; i + 1 < stops_count; i += 10) {
+        std::vector<std::string_view> route;
+        for (size_t j = i; j < std::min(i + 11, stops_count); ++j) {
+            route.push_back(stop_names[j]);
+        }
+        for (size_t j = 1; j < route.size(); ++j) {
+            catalogue.SetDistance(route[j - 1], route[j], 700.);
+        }
+        catalogue.AddBus("Bus " + std::to_string(i), route, true);
+    }
+    router::TransportRouter router(catalogue, 6, 40.);
+
+    std::vector<std::pair<std::string_view, std::string_view>> queries(1 << 16);
+    for (auto &[from, to] : queries) {
+        from = stop_names[stop_index(generator)];
+        to = stop_names[stop_index(generator)];
+    }
+
+    // прежняя схема: std::map<std::string, VertexId> и временные строки на каждый запрос
+    std::map<std::string, graph::VertexId> legacy_ids;
+    for (const auto &name : stop_names) {
+        legacy_ids[name] = *router.GetStopVertex(name);
+    }
+    const size_t repeats = 50;
+    bench::PrintResult(out, bench::Measure("stop lookup, map<string> + temp strings", repeats, queries.size(), [&] {
+        graph::VertexId sum = 0;
+        for (const auto &[from, to] : queries) {
+            sum += legacy_ids.at(std::string(from)) + legacy_ids.at(std::string(to));
+        }
+        bench::DoNotOptimize(sum);
+    }));
+    bench::PrintResult(out, bench::Measure("stop lookup, GetStopVertex", repeats, queries.size(), [&] {
+        graph::VertexId sum = 0;
+        for (const auto &[from, to] : queries) {
+            sum += *router.GetStopVertex(from) + *router.GetStopVertex(to);
+        }
+        bench::DoNotOptimize(sum);
+    }));
+    // маршрут от остановки до неё же: поиск пути вырожден, остаются только накладные расходы запроса
+    bench::PrintResult(out, bench::Measure("CreateRoute(stop, same stop)", repeats, queries.size(), [&] {
+        for (const auto &[from, to] : queries) {
+            bench::DoNotOptimize(router.CreateRoute(from, from));
+        }
+    }));
+    // полные маршруты: новый вектор на каждый запрос, переиспользуемый буфер и только время
+    bench::PrintResult(out, bench::Measure("CreateRoute, new vector per call", repeats / 5, queries.size(), [&] {
+        for (const auto &[from, to] : queries) {
+            bench::DoNotOptimize(router.CreateRoute(from, to));
+        }
+    }));
+    graph::Router<double>::RouteEdges edges;
+    bench::PrintResult(out, bench::Measure("CreateRoute, reused edges buffer", repeats / 5, queries.size(), [&] {
+        for (const auto &[from, to] : queries) {
+            bench::DoNotOptimize(router.CreateRoute(from, to, edges));
+        }
+    }));
+    bench::PrintResult(out, bench::Measure("GetRouteTime", repeats / 5, queries.size(), [&] {
+        for (const auto &[from, to] : queries) {
+            bench::DoNotOptimize(router.GetRouteTime(from, to));
+        }
+    }));
+}
@@ -0,0 +1,49 @@
+#include <sstream>
+#include <string>
+
+#include "bench.h"
+#include "city.h"
+#include "json_reader.h"
+#include "request_server.h"
+
+// Локальный клиент долгоживущего сервера: пакеты stat_requests подаются построчно,
+// ответы сверяются с однократной обработкой того же документа
+void RunServerBench(std::ostream &out) {
+    const auto document = bench::MakeGridCityDocument(14);
+    const auto &root = document.GetRoot().AsDict();
+    const auto &stat_requests = root.at("stat_requests").AsArray();
+
+    TransportCatalogue catalogue;
+    LoadCatalogue(catalogue, root.at("base_requests").AsArray());
+    router::TransportRouter router(catalogue, root.at("routing_settings").AsDict().at("bus_wait_time").AsInt(),
+                                   root.at("routing_settings").AsDict().at("bus_velocity").AsDouble());
+    RenderSets render_sets;
+    FillRenderSets(root.at("render_settings"), render_sets);
+    RequestHandler req_handler(catalogue, router);
+
+    MapRenderer renderer(render_sets);
+    std::ostringstream expected_line;
+    json::PrintCompact(GetReqsResults(req_handler, stat_requests, renderer), expected_line);
+
+    const size_t batches = 200;
+    std::ostringstream frames;
+    for (size_t i = 0; i < batches; ++i) {
+        json::PrintCompact(json::Document(json::Dict{{"stat_requests", stat_requests}}), frames);
+        frames << '\n';
+    }
+    std::istringstream input(frames.str());
+    std::ostringstream output;
+    server::RequestServer request_server(req_handler, render_sets);
+    bench::PrintResult(out, bench::Measure("serve stat_requests batches", 1, batches * stat_requests.size(), [&] {
+        request_server.Serve(input, output);
+    }));
+
+    std::istringstream responses(output.str());
+    std::string line;
+    size_t matched = 0;
+    while (std::getline(responses, line)) {
+        matched += line == expected_line.str();
+    }
+    out << "responses matching one-shot run: " << matched << " of " << batches << std::endl;
+    request_server.PrintLatencyReport(out);
+}
@@ -0,0 +1,126 @@
+#include <chrono>
+#include <cstdio>
+#include <fstream>
+#include <sstream>
+#include <string>
+
+#include "bench.h"
+#include "city.h"
+#include "json_reader.h"
+#include "serialization.h"
+
+namespace {
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+// make_base и process_requests без таблицы маршрутов: загруженная база ищет маршруты тем же способом,
+// с разметкой, если она строилась, и отвечает так же, как построенная из JSON
+void CheckSnapshotWithoutTable(std::ostream &out, const json::Dict &root, const std::string &path, router::RouteSearch search,
+                               bool hub_labels) {
+    TransportCatalogue catalogue;
+    LoadCatalogue(catalogue, root.at("base_requests").AsArray());
+    router::PrecomputeSettings settings;
+    settings.memory_limit = 1;
+    settings.hub_labels = hub_labels;
+    settings.search = search;
+    router::TransportRouter router(catalogue, root.at("routing_settings").AsDict().at("bus_wait_time").AsInt(),
+                                   root.at("routing_settings").AsDict().at("bus_velocity").AsDouble(), settings);
+    RenderSets render_sets;
+    FillRenderSets(root.at("render_settings"), render_sets);
+    serialization::SaveSnapshot(path, catalogue, router, render_sets);
+    const auto base = serialization::LoadSnapshot(path);
+    std::remove(path.c_str());
+
+    MapRenderer json_renderer(render_sets);
+    const auto expected = GetReqsResults(RequestHandler(catalogue, router), root.at("stat_requests").AsArray(), json_renderer);
+    MapRenderer snapshot_renderer(base->render_sets);
+    const auto actual = GetReqsResults(RequestHandler(base->catalogue, *base->router), root.at("stat_requests").AsArray(), snapshot_renderer);
+    const bool same_search = !base->router->HasRoutesTable() && base->router->GetRouteSearch() == search
+                             && base->router->HasHubLabels() == hub_labels;
+    out << "snapshot without table, search " << static_cast<int>(search) << (hub_labels ? " with hub labels" : "")
+        << ": search restored " << (same_search ? "yes" : "NO") << ", responses match " << (expected == actual ? "yes" : "NO")
+        << std::endl;
+    if (!same_search || expected != actual) {
+        bench::MarkFailed();
+    }
+}
+} // namespace
+
+void RunSnapshotBench(std::ostream &out) {
+    const auto document = bench::MakeGridCityDocument(14);
+    const auto &root = document.GetRoot().AsDict();
+    const std::string path = "transport_catalogue_bench.snapshot";
+
+    auto start = std::chrono::steady_clock::now();
+    TransportCatalogue catalogue;
+    LoadCatalogue(catalogue, root.at("base_requests").AsArray());
+    router::TransportRouter router(catalogue, root.at("routing_settings").AsDict().at("bus_wait_time").AsInt(),
+                                   root.at("routing_settings").AsDict().at("bus_velocity").AsDouble());
+    RenderSets render_sets;
+    FillRenderSets(root.at("render_settings"), render_sets);
+    out << "build from JSON:  " << ElapsedMs(start) << " ms (" << router.GetGraph().GetVertexCount() << " vertices)" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    serialization::SaveSnapshot(path, catalogue, router, render_sets);
+    out << "save snapshot:    " << ElapsedMs(start) << " ms" << std::endl;
+
+    start = std::chrono::steady_clock::now();
+    const auto base = serialization::LoadSnapshot(path);
+    out << "load snapshot:    " << ElapsedMs(start) << " ms" << std::endl;
+    const bool mapped = base->router->HasRoutesTable() && base->router->GetRouter().GetRoutesInternalData().mapped_cells != nullptr;
+    out << "routes table read from the mapping: " << (mapped ? "yes" : "NO") << std::endl;
+    if (!mapped) {
+        bench::MarkFailed();
+    }
+
+    // ответы по загруженной базе должны совпадать с ответами по базе, построенной из JSON
+    MapRenderer json_renderer(render_sets);
+    const auto expected = GetReqsResults(RequestHandler(catalogue, router), root.at("stat_requests").AsArray(), json_renderer);
+    MapRenderer snapshot_renderer(base->render_sets);
+    const auto actual = GetReqsResults(RequestHandler(base->catalogue, *base->router), root.at("stat_requests").AsArray(), snapshot_renderer);
+    out << "responses match JSON-built base: " << (expected == actual ? "yes" : "NO") << std::endl;
+
+    // Таблица занимает большую часть файла, середина файла лежит в ней. Обычная загрузка ячейки таблицы
+    // не проверяет, повреждение находит только загрузка с проверкой таблицы
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekg(0, std::ios::end);
+        const auto middle = file.tellg() / 2;
+        file.seekg(middle);
+        const char byte = static_cast<char>(file.get());
+        file.seekp(middle);
+        file.put(static_cast<char>(byte ^ '\x7f'));
+    }
+    try {
+        serialization::LoadSnapshot(path);
+        out << "corrupted table loaded without verification: yes" << std::endl;
+    } catch (const serialization::SnapshotError &error) {
+        out << "corrupted table loaded without verification: NO (" << error.what() << ")" << std::endl;
+        bench::MarkFailed();
+    }
+    try {
+        serialization::LoadSnapshot(path, true);
+        out << "corrupted table rejected by verification: NO" << std::endl;
+        bench::MarkFailed();
+    } catch (const serialization::SnapshotError &error) {
+        out << "corrupted table rejected by verification: yes (" << error.what() << ")" << std::endl;
+    }
+
+    // повреждённый файл должен отвергаться
+    {
+        std::fstream file(path, std::ios::in | std::ios::out | std::ios::binary);
+        file.seekp(-1, std::ios::end);
+        file.put('\x7f');
+    }
+    try {
+        serialization::LoadSnapshot(path);
+        out << "corrupted snapshot rejected: NO" << std::endl;
+    } catch (const serialization::SnapshotError &error) {
+        out << "corrupted snapshot rejected: yes (" << error.what() << ")" << std::endl;
+    }
+    std::remove(path.c_str());
+
+    CheckSnapshotWithoutTable(out, root, path, router::RouteSearch::ALT, false);
+    CheckSnapshotWithoutTable(out, root, path, router::RouteSearch::BIDIRECTIONAL, true);
+}
@@ -0,0 +1,84 @@
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "city.h"
+#include "json_reader.h"
+#include "timetable_router.h"
+
+namespace {
+// поездки идут цепочкой от начальной остановки к конечной, время не убывает, пересадки не короче заданных
+bool IsConsistent(const router::TimetableRouter::Journey &journey, const TransportCatalogue &catalogue,
+                  domain::StopId from, domain::StopId to) {
+    domain::StopId stop = from;
+    double ready = journey.departure_time;
+    for (const auto &leg : journey.legs) {
+        if (leg.from != stop || leg.departure_time < ready || leg.arrival_time < leg.departure_time) {
+            return false;
+        }
+        stop = leg.to;
+        ready = leg.arrival_time + catalogue.GetTransferTime(stop);
+    }
+    return stop == to && (journey.legs.empty() || journey.legs.back().arrival_time == journey.arrival_time);
+}
+} // namespace
+
+// Поиск по расписанию на сетке, где у каждого маршрута своё расписание, а у остановок - время пересадки
+void RunTimetableBench(std::ostream &out) {
+    const int side = 40;
+    const auto document = bench::MakeGridCityDocument(side);
+    const auto &root = document.GetRoot().AsDict();
+    TransportCatalogue catalogue;
+    LoadCatalogue(catalogue, root.at("base_requests").AsArray());
+    std::mt19937 generator(17);
+    std::uniform_int_distribution<int> headway(4, 12);
+    std::uniform_int_distribution<int> offset(0, 10);
+    for (const auto &[name, bus] : catalogue.GetAllRoutes()) {
+        catalogue.SetBusSchedule(name, domain::BusSchedule{300. + offset(generator), 1440., static_cast<double>(headway(generator))});
+    }
+    for (domain::StopId stop_id = 0; stop_id < catalogue.GetStopCount(); stop_id += 3) {
+        catalogue.SetTransferTime(catalogue.GetStop(stop_id).name, 2.);
+    }
+
+    const double velocity = root.at("routing_settings").AsDict().at("bus_velocity").AsDouble();
+    router::TimetableRouter timetable(catalogue, velocity);
+    out << "grid " << side << "x" << side << ": " << timetable.GetTripCount() << " trips, " << timetable.GetConnectionCount()
+        << " connections (" << timetable.GetConnectionCount() * 32 / (1 << 20) << " MiB)" << std::endl;
+    bench::PrintResult(out, bench::Measure("build connections", 3, timetable.GetConnectionCount(), [&] {
+        timetable = router::TimetableRouter(catalogue, velocity);
+    }));
+
+    std::uniform_int_distribution<domain::StopId> stop_index(0, static_cast<domain::StopId>(catalogue.GetStopCount() - 1));
+    std::uniform_int_distribution<int> minute(360, 1320);
+    struct Query {
+        domain::StopId from;
+        domain::StopId to;
+        double departure_time;
+    };
+    std::vector<Query> queries(200);
+    for (auto &query : queries) {
+        query = {stop_index(generator), stop_index(generator), static_cast<double>(minute(generator))};
+    }
+    size_t found = 0;
+    size_t inconsistent = 0;
+    size_t later_arrives_earlier = 0;
+    bench::PrintResult(out, bench::Measure("FindJourney", 1, queries.size(), [&] {
+        for (const auto &query : queries) {
+            const auto journey = timetable.FindJourney(query.from, query.to, query.departure_time);
+            if (!journey) {
+                continue;
+            }
+            ++found;
+            inconsistent += !IsConsistent(*journey, catalogue, query.from, query.to);
+        }
+    }));
+    // отправившись позже, нельзя приехать раньше
+    for (const auto &query : queries) {
+        const auto journey = timetable.FindJourney(query.from, query.to, query.departure_time);
+        const auto later = timetable.FindJourney(query.from, query.to, query.departure_time + 7.);
+        later_arrives_earlier += journey && later && later->arrival_time < journey->arrival_time;
+    }
+    out << "journeys found: " << found << " of " << queries.size() << ", inconsistent: " << inconsistent
+        << ", later departure arriving earlier: " << later_arrives_earlier << std::endl;
+}
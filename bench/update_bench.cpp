@@ -0,0 +1,198 @@
+#include <algorithm>
+#include <chrono>
+#include <cmath>
+#include <cstdio>
+#include <limits>
+#include <memory>
+#include <random>
+#include <string>
+#include <vector>
+
+#include "bench.h"
+#include "city.h"
+#include "json_builder.h"
+#include "json_reader.h"
+#include "router.h"
+#include "serialization.h"
+
+namespace {
+double ElapsedMs(std::chrono::steady_clock::time_point start) {
+    return std::chrono::duration<double, std::milli>(std::chrono::steady_clock::now() - start).count();
+}
+
+std::string StopName(int row, int column) {
+    return "Stop " + std::to_string(row) + "-" + std::to_string(column);
+}
+
+// Изменения сетки: новое расстояние, замена и удаление маршрута, новая остановка с маршрутом
+std::vector<json::Array> MakePatches(int side) {
+    std::vector<json::Array> patches;
+    json::Dict distances;
+    distances[StopName(2, 3)] = 150;
+    patches.push_back({json::Builder{}.StartDict().Key("type").Value("Stop").Key("name").Value(StopName(2, 2))
+                           .Key("latitude").Value(55.62).Key("longitude").Value(37.52)
+                           .Key("road_distances").Value(distances).EndDict().Build()});
+    json::Array shortened;
+    for (int i = 0; i < side / 2; ++i) {
+        shortened.push_back(StopName(3, i));
+    }
+    patches.push_back({json::Builder{}.StartDict().Key("type").Value("Bus").Key("name").Value("H3")
+                           .Key("stops").Value(shortened).Key("is_roundtrip").Value(false).EndDict().Build()});
+    patches.push_back({json::Builder{}.StartDict().Key("type").Value("Bus").Key("name").Value("V5")
+                           .Key("remove").Value(true).EndDict().Build()});
+    json::Dict express_distances;
+    express_distances[StopName(0, 0)] = 900;
+    express_distances[StopName(side - 1, side - 1)] = 900;
+    json::Array express{std::string(StopName(0, 0)), std::string("Express hub"), std::string(StopName(side - 1, side - 1))};
+    patches.push_back({json::Builder{}.StartDict().Key("type").Value("Stop").Key("name").Value("Express hub")
+                           .Key("latitude").Value(55.65).Key("longitude").Value(37.55)
+                           .Key("road_distances").Value(express_distances).EndDict().Build(),
+                       json::Builder{}.StartDict().Key("type").Value("Bus").Key("name").Value("Express")
+                           .Key("stops").Value(express).Key("is_roundtrip").Value(false).EndDict().Build()});
+    return patches;
+}
+
+// Сверка всех пар остановок: время совпадает, а восстановленный путь ведёт из from в to и даёт то же время
+size_t CountMismatches(const TransportCatalogue &catalogue, const router::TransportRouter &router,
+                       const router::TransportRouter &expected_router) {
+    size_t mismatches = 0;
+    for (domain::StopId from = 0; from < catalogue.GetStopCount(); ++from) {
+        for (domain::StopId to = 0; to < catalogue.GetStopCount(); ++to) {
+            const auto route = router.CreateRoute(from, to);
+            const auto expected = expected_router.CreateRoute(from, to);
+            if (route.has_value() != expected.has_value()) {
+                ++mismatches;
+                continue;
+            }
+            if (!route) {
+                continue;
+            }
+            double total = 0.;
+            graph::VertexId vertex = router.GetStopVertices()[from];
+            for (const auto &[edge_id, edge] : route->edges) {
+                total += edge->weight;
+                if (edge->from != vertex || router.GetGraph().IsEdgeRemoved(edge_id)) {
+                    ++mismatches;
+                }
+                vertex = edge->to;
+            }
+            if (vertex != router.GetStopVertices()[to] || std::abs(total - route->weight) > 1e-9 * (1. + total)
+                || std::abs(route->weight - expected->weight) > 1e-9 * (1. + route->weight)) {
+                ++mismatches;
+            }
+        }
+    }
+    return mismatches;
+}
+
+// Случайный граф, у весов которого целая часть мала, а дробная кратна 2^-30 и меньше 2^-22: суммы по любым путям
+// точны в double, но пути одной целой длины различимы только в битах, которых нет у float. Обновление таблицы после удаления
+// и добавления рёбер должно дать ровно те же времена путей, что и полный расчёт
+size_t CountRepairMismatches() {
+    const size_t vertex_count = 200;
+    std::mt19937 generator(17);
+    std::uniform_int_distribution<graph::VertexId> vertex(0, vertex_count - 1);
+    std::uniform_int_distribution<int> whole(1, 4);
+    std::uniform_int_distribution<int> fraction(0, 1 << 8);
+    const auto random_edge = [&] {
+        const double weight = whole(generator) + std::ldexp(fraction(generator), -30);
+        return graph::Edge<double>{"", 1, vertex(generator), vertex(generator), weight};
+    };
+    graph::DirectedWeightedGraph<double> graph(vertex_count);
+    for (size_t i = 0; i < vertex_count * 6; ++i) {
+        graph.AddEdge(random_edge());
+    }
+    graph::Router<double> router(graph);
+    size_t mismatches = 0;
+    for (int round = 0; round < 10; ++round) {
+        std::vector<graph::EdgeId> removed_edges;
+        while (removed_edges.size() < 3) {
+            const graph::EdgeId edge_id = std::uniform_int_distribution<graph::EdgeId>(0, graph.GetEdgeCount() - 1)(generator);
+            if (!graph.IsEdgeRemoved(edge_id)) {
+                graph.RemoveEdge(edge_id);
+                removed_edges.push_back(edge_id);
+            }
+        }
+        std::vector<graph::EdgeId> added_edges;
+        for (int i = 0; i < 20; ++i) {
+            added_edges.push_back(graph.AddEdge(random_edge()));
+        }
+        router.Update(removed_edges, added_edges);
+        const graph::Router<double> rebuilt(graph);
+        for (graph::VertexId from = 0; from < vertex_count; ++from) {
+            for (graph::VertexId to = 0; to < vertex_count; ++to) {
+                mismatches += router.GetRouteWeight(from, to) != rebuilt.GetRouteWeight(from, to);
+            }
+        }
+    }
+    return mismatches;
+}
+} // namespace
+
+void RunUpdateBench(std::ostream &out) {
+    const int side = 14;
+    const auto document = bench::MakeGridCityDocument(side);
+    const auto &root = document.GetRoot().AsDict();
+    const auto &routing = root.at("routing_settings").AsDict();
+    const int wait_time = routing.at("bus_wait_time").AsInt();
+    const double velocity = routing.at("bus_velocity").AsDouble();
+
+    TransportCatalogue catalogue;
+    LoadCatalogue(catalogue, root.at("base_requests").AsArray());
+    auto start = std::chrono::steady_clock::now();
+    router::TransportRouter router(catalogue, wait_time, velocity);
+    out << "initial build: " << ElapsedMs(start) << " ms (" << router.GetGraph().GetVertexCount() << " vertices)" << std::endl;
+
+    // Время обновления и перестроения - лучшее из нескольких замеров: обновление повторяется на копиях маршрутизатора
+    // до изменения. Обновление не должно быть медленнее перестроения. При большом числе затронутых строк таблица
+    // строится заново тем же расчётом, и времена совпадают с точностью до шума замера, отсюда допуск
+    const int repeats = 5;
+    const double noise_tolerance = 1.1;
+    for (const auto &patch : MakePatches(side)) {
+        const auto bus_stat_before = catalogue.ReportBusStatistic("H2");
+        UpdateCatalogue(catalogue, patch);
+        // замеры чередуются, чтобы колебания нагрузки машины доставались обоим поровну
+        double incremental_ms = std::numeric_limits<double>::infinity();
+        double rebuild_ms = std::numeric_limits<double>::infinity();
+        std::unique_ptr<router::TransportRouter> rebuilt;
+        for (int i = 0; i < repeats; ++i) {
+            router::TransportRouter copy(router, catalogue);
+            start = std::chrono::steady_clock::now();
+            copy.ApplyCatalogueUpdates();
+            incremental_ms = std::min(incremental_ms, ElapsedMs(start));
+
+            start = std::chrono::steady_clock::now();
+            rebuilt = std::make_unique<router::TransportRouter>(catalogue, wait_time, velocity);
+            rebuild_ms = std::min(rebuild_ms, ElapsedMs(start));
+        }
+        router.ApplyCatalogueUpdates();
+
+        const auto bus_stat_after = catalogue.ReportBusStatistic("H2");
+        const size_t mismatches = CountMismatches(catalogue, router, *rebuilt);
+        out << "patch of " << patch.size() << " item(s): incremental " << incremental_ms << " ms, full rebuild " << rebuild_ms
+            << " ms" << (incremental_ms <= rebuild_ms * noise_tolerance ? "" : " - SLOWER") << ", mismatches: " << mismatches
+            << ", H2 length " << bus_stat_before.total_distance << " -> " << bus_stat_after.total_distance << std::endl;
+        if (mismatches || incremental_ms > rebuild_ms * noise_tolerance) {
+            bench::MarkFailed();
+        }
+    }
+
+    // снимок обновлённой базы: удалённые рёбра и имена удалённых маршрутов не должны мешать загрузке
+    const std::string path = "transport_catalogue_update_bench.snapshot";
+    RenderSets render_sets;
+    FillRenderSets(root.at("render_settings"), render_sets);
+    serialization::SaveSnapshot(path, catalogue, router, render_sets);
+    const auto base = serialization::LoadSnapshot(path);
+    const size_t repair_mismatches = CountRepairMismatches();
+    out << "table repair vs full computation, exact time mismatches: " << repair_mismatches << std::endl;
+    if (repair_mismatches) {
+        bench::MarkFailed();
+    }
+
+    const size_t snapshot_mismatches = CountMismatches(base->catalogue, *base->router, router);
+    out << "snapshot of updated base, mismatches: " << snapshot_mismatches << std::endl;
+    if (snapshot_mismatches) {
+        bench::MarkFailed();
+    }
+    std::remove(path.c_str());
+}
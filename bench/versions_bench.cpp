@@ -0,0 +1,94 @@
+#include <algorithm>
+#include <atomic>
+#include <chrono>
+#include <cmath>
+#include <string>
+#include <thread>
+#include <vector>
+
+#include "bench.h"
+#include "city.h"
+#include "json_reader.h"
+#include "versioned_base.h"
+
+// Нагрузочная проверка версионированной базы: читатели без блокировок сверяют ответы маршрутизатора
+// с каталогом той же версии, пока писатели публикуют новые версии
+void RunVersionsBench(std::ostream &out) {
+    const auto document = bench::MakeGridCityDocument(10);
+    const auto &root = document.GetRoot().AsDict();
+    const auto &routing = root.at("routing_settings").AsDict();
+    const std::string from = "Stop 0-0";
+    const std::string to = "Stop 9-9";
+
+    auto base = std::make_unique<serialization::TransportBase>();
+    LoadCatalogue(base->catalogue, root.at("base_requests").AsArray());
+    // прямой маршрут между углами сетки короче любой пересадки, его время зависит только от расстояния
+    base->catalogue.SetDistance(from, to, 100.);
+    base->catalogue.AddBus("Probe", {from, to, from}, false);
+    base->catalogue.RefreshStatistics();
+    base->router = std::make_unique<router::TransportRouter>(base->catalogue, routing.at("bus_wait_time").AsInt(),
+                                                             routing.at("bus_velocity").AsDouble());
+    FillRenderSets(root.at("render_settings"), base->render_sets);
+    server::VersionedBase versions(std::move(base));
+
+    const size_t readers_count = std::max(2u, std::thread::hardware_concurrency());
+    const size_t writers_count = 2;
+    const size_t updates_per_writer = 100;
+    std::atomic<bool> writing{true};
+    std::atomic<size_t> reads{0};
+    std::atomic<size_t> violations{0};
+
+    const auto start = std::chrono::steady_clock::now();
+    std::vector<std::thread> readers;
+    for (size_t i = 0; i < readers_count; ++i) {
+        readers.emplace_back([&] {
+            auto reader = versions.RegisterReader();
+            uint64_t last_version = 0;
+            size_t local_reads = 0;
+            size_t local_violations = 0;
+            while (writing.load(std::memory_order_relaxed)) {
+                const auto version = reader->Lock();
+                const auto &catalogue = version->catalogue;
+                const double distance = catalogue.GetDistance(catalogue.FindStop(from), catalogue.FindStop(to));
+                const auto route = version->router->CreateRoute(from, to);
+                const double expected_time = version->router->GetBusWaitTime() + distance / (version->router->GetBusVelocity() * 100. / 6.);
+                const bool consistent = route && std::abs(route->weight - expected_time) < 1e-9
+                                        && catalogue.ReportBusStatistic("Probe").total_distance == 2 * distance
+                                        && version.GetVersion() >= last_version;
+                local_violations += !consistent;
+                last_version = version.GetVersion();
+                ++local_reads;
+            }
+            reads += local_reads;
+            violations += local_violations;
+        });
+    }
+    std::vector<std::thread> writers;
+    for (size_t i = 0; i < writers_count; ++i) {
+        writers.emplace_back([&, i] {
+            for (size_t j = 0; j < updates_per_writer; ++j) {
+                const double distance = 10. + static_cast<double>((i * updates_per_writer + j) % 90);
+                versions.Update([&](TransportCatalogue &catalogue) {
+                    catalogue.SetDistance(from, to, distance);
+                });
+            }
+        });
+    }
+    for (auto &writer : writers) {
+        writer.join();
+    }
+    writing = false;
+    for (auto &reader : readers) {
+        reader.join();
+    }
+    const std::chrono::duration<double, std::milli> elapsed = std::chrono::steady_clock::now() - start;
+
+    out << readers_count << " readers, " << writers_count << " writers: " << reads.load() << " reads and "
+        << writers_count * updates_per_writer << " versions in " << elapsed.count() << " ms" << std::endl;
+    out << "inconsistent reads: " << violations.load() << std::endl;
+    out << "retired versions pending while readers were active: " << versions.GetRetiredCount() << std::endl;
+    // без читателей очередная публикация освобождает все заменённые версии
+    versions.Update([](TransportCatalogue &) {});
+    out << "retired versions pending after readers finished: " << versions.GetRetiredCount() << std::endl;
+    out << "final version: " << versions.GetVersion() << std::endl;
+}
@@ -0,0 +1,172 @@
+#include "all_pairs.h"
+
+#include <algorithm>
+#include <stdexcept>
+
+#include "parallel.h"
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define ALL_PAIRS_HAS_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
+namespace graph {
+
+namespace {
+// блок 64 x 64: веса и рёбра одного блока занимают 64 КиБ
+const size_t BLOCK_SIZE = 64;
+const size_t LANES = 4;
+const double INF = std::numeric_limits<double>::infinity();
+
+struct Range {
+    size_t begin;
+    size_t end;
+};
+
+// d[i][j] = min(d[i][j], d[i][k] + d[k][j]) для i из rows, j из columns, k из through (k - внешний цикл)
+void RelaxBlockScalar(double *weights, EdgeId *prev_edges, size_t stride, Range rows, Range columns, Range through) {
+    for (size_t k = through.begin; k < through.end; ++k) {
+        const double *weights_k = weights + k * stride;
+        const EdgeId *prev_k = prev_edges + k * stride;
+        for (size_t i = rows.begin; i < rows.end; ++i) {
+            double *weights_i = weights + i * stride;
+            const double weight_ik = weights_i[k];
+            if (weight_ik == INF) {
+                continue;
+            }
+            EdgeId *prev_i = prev_edges + i * stride;
+            for (size_t j = columns.begin; j < columns.end; ++j) {
+                const double candidate = weight_ik + weights_k[j];
+                if (candidate < weights_i[j]) {
+                    weights_i[j] = candidate;
+                    prev_i[j] = prev_k[j];
+                }
+            }
+        }
+    }
+}
+
+#ifdef ALL_PAIRS_HAS_AVX2_KERNEL
+// Та же релаксация по четыре элемента строки; ребро и вес выбираются по одной маске сравнения
+__attribute__((target("avx2"))) void RelaxBlockAvx2(double *weights, EdgeId *prev_edges, size_t stride,
+                                                    Range rows, Range columns, Range through) {
+    static_assert(sizeof(EdgeId) == sizeof(double), "Edge ids must be 64-bit to share the comparison mask with weights");
+    for (size_t k = through.begin; k < through.end; ++k) {
+        const double *weights_k = weights + k * stride;
+        const EdgeId *prev_k = prev_edges + k * stride;
+        for (size_t i = rows.begin; i < rows.end; ++i) {
+            double *weights_i = weights + i * stride;
+            const double weight_ik = weights_i[k];
+            if (weight_ik == INF) {
+                continue;
+            }
+            EdgeId *prev_i = prev_edges + i * stride;
+            const __m256d weight_ik_vector = _mm256_set1_pd(weight_ik);
+            size_t j = columns.begin;
+            for (; j + LANES <= columns.end; j += LANES) {
+                const __m256d candidate = _mm256_add_pd(weight_ik_vector, _mm256_loadu_pd(weights_k + j));
+                const __m256d current = _mm256_loadu_pd(weights_i + j);
+                const __m256d less = _mm256_cmp_pd(candidate, current, _CMP_LT_OQ);
+                if (_mm256_movemask_pd(less) == 0) {
+                    continue;
+                }
+                _mm256_storeu_pd(weights_i + j, _mm256_blendv_pd(current, candidate, less));
+                const __m256d prev_current = _mm256_castsi256_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(prev_i + j)));
+                const __m256d prev_through = _mm256_castsi256_pd(_mm256_loadu_si256(reinterpret_cast<const __m256i *>(prev_k + j)));
+                _mm256_storeu_si256(reinterpret_cast<__m256i *>(prev_i + j), _mm256_castpd_si256(_mm256_blendv_pd(prev_current, prev_through, less)));
+            }
+            for (; j < columns.end; ++j) {
+                const double candidate = weight_ik + weights_k[j];
+                if (candidate < weights_i[j]) {
+                    weights_i[j] = candidate;
+                    prev_i[j] = prev_k[j];
+                }
+            }
+        }
+    }
+}
+
+bool CpuSupportsAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+#endif
+
+void RelaxBlock(double *weights, EdgeId *prev_edges, size_t stride, Range rows, Range columns, Range through) {
+#ifdef ALL_PAIRS_HAS_AVX2_KERNEL
+    if (CpuSupportsAvx2()) {
+        RelaxBlockAvx2(weights, prev_edges, stride, rows, columns, through);
+        return;
+    }
+#endif
+    RelaxBlockScalar(weights, prev_edges, stride, rows, columns, through);
+}
+} // namespace
+
+AllPairsTable ComputeAllPairs(const DirectedWeightedGraph<double> &graph, size_t threads_count, const AllPairsProgress &progress) {
+    AllPairsTable table;
+    const size_t vertex_count = graph.GetVertexCount();
+    table.vertex_count = vertex_count;
+    table.stride = (vertex_count + LANES - 1) / LANES * LANES;
+    table.weights.assign(vertex_count * table.stride, INF);
+    table.prev_edges.assign(vertex_count * table.stride, AllPairsTable::NO_EDGE);
+    double *weights = table.weights.data();
+    EdgeId *prev_edges = table.prev_edges.data();
+    const size_t stride = table.stride;
+
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        weights[vertex * stride + vertex] = 0.;
+    }
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+            const auto &edge = graph.GetEdge(edge_id);
+            if (edge.weight < 0.) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+            const size_t cell = vertex * stride + edge.to;
+            if (weights[cell] > edge.weight) {
+                weights[cell] = edge.weight;
+                prev_edges[cell] = edge_id;
+            }
+        }
+    }
+
+    const size_t blocks_count = (vertex_count + BLOCK_SIZE - 1) / BLOCK_SIZE;
+    const auto block = [vertex_count](size_t index) {
+        return Range{index * BLOCK_SIZE, std::min((index + 1) * BLOCK_SIZE, vertex_count)};
+    };
+    for (size_t pivot = 0; pivot < blocks_count; ++pivot) {
+        const Range through = block(pivot);
+        // ведущий блок на диагонали
+        RelaxBlock(weights, prev_edges, stride, through, through, through);
+        // блоки строки и столбца ведущего блока зависят только от него
+        parallel::ParallelFor(2 * blocks_count, threads_count, [&](size_t task) {
+            const size_t other = task / 2;
+            if (other == pivot) {
+                return;
+            }
+            if (task % 2 == 0) {
+                RelaxBlock(weights, prev_edges, stride, through, block(other), through);
+            } else {
+                RelaxBlock(weights, prev_edges, stride, block(other), through, through);
+            }
+        });
+        // остальные блоки зависят от блоков строки и столбца; задание - полоса блоков одной строки
+        parallel::ParallelFor(blocks_count, threads_count, [&](size_t row) {
+            if (row == pivot) {
+                return;
+            }
+            for (size_t column = 0; column < blocks_count; ++column) {
+                if (column != pivot) {
+                    RelaxBlock(weights, prev_edges, stride, block(row), block(column), through);
+                }
+            }
+        });
+        if (progress) {
+            progress(pivot + 1, blocks_count);
+        }
+    }
+    return table;
+}
+
+} // namespace graph
@@ -0,0 +1,44 @@
+#pragma once
+
+#include "graph.h"
+
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <vector>
+
+namespace graph {
+
+// Таблица кратчайших путей между всеми парами вершин в плоских массивах, индекс пары - from * stride + to.
+// Недостижимая пара - бесконечный вес; у пути из вершины в неё же и у недостижимых пар нет последнего ребра
+struct AllPairsTable {
+    static constexpr EdgeId NO_EDGE = std::numeric_limits<EdgeId>::max();
+
+    size_t vertex_count = 0;
+    // длина строки, кратная ширине векторного регистра
+    size_t stride = 0;
+    std::vector<double> weights;
+    // последнее ребро кратчайшего пути
+    std::vector<EdgeId> prev_edges;
+
+    double GetWeight(VertexId from, VertexId to) const {
+        return weights[from * stride + to];
+    }
+
+    EdgeId GetPrevEdge(VertexId from, VertexId to) const {
+        return prev_edges[from * stride + to];
+    }
+};
+
+// Ход предрасчёта: done из total шагов выполнено. Вызывается в потоке, запустившем расчёт
+using AllPairsProgress = std::function<void(size_t done, size_t total)>;
+
+// Блочный алгоритм Флойда-Уоршелла: матрица делится на квадратные блоки, которые помещаются в кеш.
+// Для каждого ведущего блока по диагонали сначала пересчитывается он сам, затем блоки его строки и столбца,
+// затем остальные; блоки одного этапа независимы и обрабатываются в threads_count потоках (0 - по числу ядер).
+// Внутренний цикл min-plus при поддержке процессором AVX2 обрабатывает по четыре элемента строки.
+// progress вызывается после каждого ведущего блока
+AllPairsTable ComputeAllPairs(const DirectedWeightedGraph<double> &graph, size_t threads_count = 0,
+                              const AllPairsProgress &progress = {});
+
+} // namespace graph
@@ -1,5 +1,7 @@
 #pragma once
 
+#include <cstdint>
+#include <optional>
 #include <string>
 #include <string_view>
 #include <unordered_map>
@@ -22,15 +24,30 @@ private:
     std::size_t combineHashes(const std::size_t h1, const std::size_t h2) const;
 };
 
+using StopId = uint32_t;
+
+// Остановка: имя хранится в пуле имён каталога, а координаты - в массивах каталога,
+// индексированных по id (см. TransportCatalogue::GetStopCoordinates)
 struct Stop {
-    std::string name;
-    geo::Coordinates coordinate;
+    std::string_view name;
+    StopId id;
+};
+
+// Расписание маршрута: рейсы отправляются с первой остановки с first_departure по last_departure
+// каждые headway минут; время - минуты от начала суток
+struct BusSchedule {
+    double first_departure;
+    double last_departure;
+    double headway;
 };
 
+// Имена остановок и маршрутов ссылаются на таблицу интернированных имён каталога
 struct Bus {
-    std::string bus_route;
+    std::string_view bus_route;
     std::vector<const Stop *> stops;
     bool is_roundtrip;
+    // маршрут без расписания в поиске по расписанию не участвует
+    std::optional<BusSchedule> schedule;
 };
 
 struct BusStat {
@@ -47,6 +64,24 @@ struct BusStat {
     double dist_proportion;
 };
 
+// Запись журнала изменений каталога. Подсистемы с производными данными (маршрутизатор)
+// догоняют каталог, применяя записи после последней обработанной
+struct CatalogueUpdate {
+    enum class Type {
+        STOP_ADDED,
+        BUS_ADDED,
+        BUS_REMOVED,
+        DISTANCE_CHANGED,
+        // изменилось расписание маршрута или время пересадки на остановке, граф маршрутов не меняется
+        TIMETABLE_CHANGED
+    };
+    Type type;
+    // имя остановки или маршрута; для DISTANCE_CHANGED - первая остановка пары
+    std::string_view name;
+    // вторая остановка пары для DISTANCE_CHANGED
+    std::string_view other_stop_name;
+};
+
 struct StopStat {
     explicit operator bool() const {
         return (!name.empty());
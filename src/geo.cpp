@@ -1,12 +1,189 @@
 #include "geo.h"
 
+#include <algorithm>
+
+#if defined(__GNUC__) && (defined(__x86_64__) || defined(__i386__))
+#define GEO_HAS_AVX2_KERNEL 1
+#include <immintrin.h>
+#endif
+
 namespace geo {
+
+namespace {
+const double DR = 3.1415926535 / 180.;
+const double EARTH_RADIUS = 6371000;
+
+inline bool IsSamePoint(const PreparedCoordinates &from, const PreparedCoordinates &to) {
+    return from.lat_rad == to.lat_rad && from.lng_rad == to.lng_rad;
+}
+
+// Угол по косинусу, переводимый в расстояние. Из-за округления косинус почти противоположных или почти
+// совпадающих точек выходит за [-1, 1]; он ограничивается так же, как в векторном Acos, чтобы оба пути давали число
+inline double ArcDistance(double cos_angle) {
+    return std::acos(std::clamp(cos_angle, -1., 1.)) * EARTH_RADIUS;
+}
+
+#ifdef GEO_HAS_AVX2_KERNEL
+// Разбиение pi/2 на две части (как в fdlibm): k * PIO2_HI считается без погрешности
+const double PIO2_HI = 1.57079632673412561417e+00;
+const double PIO2_LO = 6.07710050650619224932e-11;
+const double TWO_OVER_PI = 0.63661977236758134308;
+const double PI = 3.14159265358979323846;
+
+// Ряд Тейлора для sin и cos на отрезке [-pi/4, pi/4]; погрешность ниже 1e-18
+__attribute__((target("avx2"))) inline __m256d SinReduced(__m256d r) {
+    const __m256d z = _mm256_mul_pd(r, r);
+    __m256d p = _mm256_set1_pd(1. / 355687428096000.);         // 1/17!
+    p = _mm256_sub_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(1. / 1307674368000.)); // 1/15!
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(1. / 6227020800.));    // 1/13!
+    p = _mm256_sub_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(1. / 39916800.));       // 1/11!
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(1. / 362880.));         // 1/9!
+    p = _mm256_sub_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(1. / 5040.));           // 1/7!
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(1. / 120.));            // 1/5!
+    p = _mm256_sub_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(1. / 6.));              // 1/3!
+    return _mm256_add_pd(r, _mm256_mul_pd(_mm256_mul_pd(p, z), r));
+}
+
+__attribute__((target("avx2"))) inline __m256d CosReduced(__m256d r) {
+    const __m256d z = _mm256_mul_pd(r, r);
+    __m256d p = _mm256_set1_pd(1. / 6402373705728000.);       // 1/18!
+    p = _mm256_sub_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(1. / 20922789888000.)); // 1/16!
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(1. / 87178291200.));    // 1/14!
+    p = _mm256_sub_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(1. / 479001600.));      // 1/12!
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(1. / 3628800.));        // 1/10!
+    p = _mm256_sub_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(1. / 40320.));          // 1/8!
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(1. / 720.));            // 1/6!
+    p = _mm256_sub_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(1. / 24.));             // 1/4!
+    p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(1. / 2.));              // 1/2!
+    return _mm256_sub_pd(_mm256_set1_pd(1.), _mm256_mul_pd(p, z));
+}
+
+// cos(x) для x >= 0: приведение к [-pi/4, pi/4] по модулю pi/2 и выбор sin/cos по номеру четверти
+__attribute__((target("avx2"))) inline __m256d Cos(__m256d x) {
+    const __m256d k = _mm256_round_pd(_mm256_mul_pd(x, _mm256_set1_pd(TWO_OVER_PI)),
+                                      _MM_FROUND_TO_NEAREST_INT | _MM_FROUND_NO_EXC);
+    __m256d r = _mm256_sub_pd(x, _mm256_mul_pd(k, _mm256_set1_pd(PIO2_HI)));
+    r = _mm256_sub_pd(r, _mm256_mul_pd(k, _mm256_set1_pd(PIO2_LO)));
+    // номер четверти 0..3
+    const __m256d quarter = _mm256_sub_pd(k, _mm256_mul_pd(_mm256_set1_pd(4.),
+                                                           _mm256_floor_pd(_mm256_mul_pd(k, _mm256_set1_pd(0.25)))));
+    const __m256d one = _mm256_set1_pd(1.);
+    const __m256d two = _mm256_set1_pd(2.);
+    const __m256d three = _mm256_set1_pd(3.);
+    const __m256d use_sin = _mm256_or_pd(_mm256_cmp_pd(quarter, one, _CMP_EQ_OQ), _mm256_cmp_pd(quarter, three, _CMP_EQ_OQ));
+    const __m256d negate = _mm256_or_pd(_mm256_cmp_pd(quarter, one, _CMP_EQ_OQ), _mm256_cmp_pd(quarter, two, _CMP_EQ_OQ));
+    const __m256d value = _mm256_blendv_pd(CosReduced(r), SinReduced(r), use_sin);
+    return _mm256_xor_pd(value, _mm256_and_pd(negate, _mm256_set1_pd(-0.)));
+}
+
+// acos(c) = 2 * atan(sqrt((1 - |c|) / (1 + |c|))), для отрицательных c результат отражается: pi - acos(|c|).
+// Аргумент atan из [0, 1] дважды уменьшается по формуле половинного угла до 0.2, затем ряд Тейлора.
+// |c| больше единицы ограничивается ею, как в скалярном ArcDistance
+__attribute__((target("avx2"))) inline __m256d Acos(__m256d c) {
+    const __m256d one = _mm256_set1_pd(1.);
+    const __m256d sign_mask = _mm256_set1_pd(-0.);
+    const __m256d negative = _mm256_cmp_pd(c, _mm256_setzero_pd(), _CMP_LT_OQ);
+    const __m256d a = _mm256_min_pd(_mm256_andnot_pd(sign_mask, c), one);
+    __m256d t = _mm256_sqrt_pd(_mm256_div_pd(_mm256_sub_pd(one, a), _mm256_add_pd(one, a)));
+    for (int i = 0; i < 2; ++i) {
+        t = _mm256_div_pd(t, _mm256_add_pd(one, _mm256_sqrt_pd(_mm256_add_pd(one, _mm256_mul_pd(t, t)))));
+    }
+    const __m256d z = _mm256_mul_pd(t, t);
+    __m256d p = _mm256_set1_pd(-1. / 23.);
+    for (int n = 21; n >= 3; n -= 2) {
+        const double coeff = ((n / 2) % 2 == 0) ? 1. / n : -1. / n;
+        p = _mm256_add_pd(_mm256_mul_pd(p, z), _mm256_set1_pd(coeff));
+    }
+    const __m256d atan = _mm256_add_pd(t, _mm256_mul_pd(_mm256_mul_pd(p, z), t));
+    const __m256d result = _mm256_mul_pd(atan, _mm256_set1_pd(8.));
+    return _mm256_blendv_pd(result, _mm256_sub_pd(_mm256_set1_pd(PI), result), negative);
+}
+
+// Транспонирование четырёх структур PreparedCoordinates в четыре вектора полей
+__attribute__((target("avx2"))) inline void LoadPrepared(const PreparedCoordinates *points,
+                                                          __m256d &lat, __m256d &lng, __m256d &sin_lat, __m256d &cos_lat) {
+    const __m256d p0 = _mm256_loadu_pd(&points[0].lat_rad);
+    const __m256d p1 = _mm256_loadu_pd(&points[1].lat_rad);
+    const __m256d p2 = _mm256_loadu_pd(&points[2].lat_rad);
+    const __m256d p3 = _mm256_loadu_pd(&points[3].lat_rad);
+    const __m256d t0 = _mm256_unpacklo_pd(p0, p1);
+    const __m256d t1 = _mm256_unpackhi_pd(p0, p1);
+    const __m256d t2 = _mm256_unpacklo_pd(p2, p3);
+    const __m256d t3 = _mm256_unpackhi_pd(p2, p3);
+    lat = _mm256_permute2f128_pd(t0, t2, 0x20);
+    lng = _mm256_permute2f128_pd(t1, t3, 0x20);
+    sin_lat = _mm256_permute2f128_pd(t0, t2, 0x31);
+    cos_lat = _mm256_permute2f128_pd(t1, t3, 0x31);
+}
+
+__attribute__((target("avx2"))) void ComputeDistancesAvx2(const PreparedCoordinates *from, const PreparedCoordinates *to,
+                                                          double *distances, size_t count) {
+    static_assert(sizeof(PreparedCoordinates) == 4 * sizeof(double), "PreparedCoordinates must be four packed doubles");
+    const __m256d sign_mask = _mm256_set1_pd(-0.);
+    const __m256d radius = _mm256_set1_pd(EARTH_RADIUS);
+    size_t i = 0;
+    for (; i + 4 <= count; i += 4) {
+        __m256d lat1, lng1, sin1, cos1, lat2, lng2, sin2, cos2;
+        LoadPrepared(from + i, lat1, lng1, sin1, cos1);
+        LoadPrepared(to + i, lat2, lng2, sin2, cos2);
+        const __m256d same = _mm256_and_pd(_mm256_cmp_pd(lat1, lat2, _CMP_EQ_OQ), _mm256_cmp_pd(lng1, lng2, _CMP_EQ_OQ));
+        const __m256d delta_lng = _mm256_andnot_pd(sign_mask, _mm256_sub_pd(lng1, lng2));
+        const __m256d arg = _mm256_add_pd(_mm256_mul_pd(sin1, sin2),
+                                          _mm256_mul_pd(_mm256_mul_pd(cos1, cos2), Cos(delta_lng)));
+        const __m256d distance = _mm256_mul_pd(Acos(arg), radius);
+        _mm256_storeu_pd(distances + i, _mm256_andnot_pd(same, distance));
+    }
+    ComputeDistancesScalar(from + i, to + i, distances + i, count - i);
+}
+
+bool CpuSupportsAvx2() {
+    static const bool supported = __builtin_cpu_supports("avx2");
+    return supported;
+}
+#endif
+} // namespace
+
 double ComputeDistance(Coordinates from, Coordinates to) {
     using namespace std;
     if (from == to) {
         return 0;
     }
-    static const double dr = 3.1415926535 / 180.;
-    return acos(sin(from.lat * dr) * sin(to.lat * dr) + cos(from.lat * dr) * cos(to.lat * dr) * cos(abs(from.lng - to.lng) * dr)) * 6371000;
+    return ArcDistance(sin(from.lat * DR) * sin(to.lat * DR) + cos(from.lat * DR) * cos(to.lat * DR) * cos(abs(from.lng - to.lng) * DR));
+}
+
+PreparedCoordinates PrepareCoordinates(Coordinates coordinates) {
+    const double lat_rad = coordinates.lat * DR;
+    return {lat_rad, coordinates.lng * DR, std::sin(lat_rad), std::cos(lat_rad)};
+}
+
+double ComputeDistance(const PreparedCoordinates &from, const PreparedCoordinates &to) {
+    if (IsSamePoint(from, to)) {
+        return 0;
+    }
+    return ArcDistance(from.sin_lat * to.sin_lat + from.cos_lat * to.cos_lat * std::cos(std::abs(from.lng_rad - to.lng_rad)));
+}
+
+void ComputeDistancesScalar(const PreparedCoordinates *from, const PreparedCoordinates *to, double *distances, size_t count) {
+    for (size_t i = 0; i < count; ++i) {
+        distances[i] = ComputeDistance(from[i], to[i]);
+    }
+}
+
+void ComputeDistances(const PreparedCoordinates *from, const PreparedCoordinates *to, double *distances, size_t count) {
+#ifdef GEO_HAS_AVX2_KERNEL
+    if (CpuSupportsAvx2()) {
+        ComputeDistancesAvx2(from, to, distances, count);
+        return;
+    }
+#endif
+    ComputeDistancesScalar(from, to, distances, count);
+}
+
+bool IsVectorizedDistanceAvailable() {
+#ifdef GEO_HAS_AVX2_KERNEL
+    return CpuSupportsAvx2();
+#else
+    return false;
+#endif
 }
-} // namespace geo
\ No newline at end of file
+} // namespace geo
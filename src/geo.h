@@ -1,6 +1,7 @@
 #pragma once
 
 #include <cmath>
+#include <cstddef>
 
 namespace geo {
 struct Coordinates {
@@ -17,5 +18,28 @@ struct Coordinates {
     }
 };
 
+// Координаты в радианах с заранее посчитанными синусом и косинусом широты.
+// Считаются один раз на остановку, чтобы не повторять sin/cos для каждого отрезка маршрута
+struct PreparedCoordinates {
+    double lat_rad = 0.;
+    double lng_rad = 0.;
+    double sin_lat = 0.;
+    double cos_lat = 1.;
+};
+
 double ComputeDistance(Coordinates from, Coordinates to);
-} // namespace geo
\ No newline at end of file
+
+PreparedCoordinates PrepareCoordinates(Coordinates coordinates);
+
+double ComputeDistance(const PreparedCoordinates &from, const PreparedCoordinates &to);
+
+// Пакетный расчёт расстояний: distances[i] = ComputeDistance(from[i], to[i]).
+// При поддержке процессором AVX2 обрабатывает по четыре пары за итерацию
+void ComputeDistances(const PreparedCoordinates *from, const PreparedCoordinates *to, double *distances, size_t count);
+
+// Скалярный вариант пакетного расчёта, используется как запасной путь и для сверки с AVX2
+void ComputeDistancesScalar(const PreparedCoordinates *from, const PreparedCoordinates *to, double *distances, size_t count);
+
+// true, если ComputeDistances выполняется векторной реализацией
+bool IsVectorizedDistanceAvailable();
+} // namespace geo
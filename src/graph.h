@@ -2,7 +2,9 @@
 
 #include "ranges.h"
 
+#include <algorithm>
 #include <cstdlib>
+#include <string_view>
 #include <vector>
 
 namespace graph {
@@ -12,7 +14,8 @@ using EdgeId = size_t;
 
 template <typename Weight>
 struct Edge {
-    std::string name;
+    // имя остановки или маршрута из таблицы имён каталога
+    std::string_view name;
     size_t span;
     VertexId from;
     VertexId to;
@@ -29,30 +32,88 @@ public:
     DirectedWeightedGraph() = default;
     explicit DirectedWeightedGraph(size_t vertex_count);
     EdgeId AddEdge(const Edge<Weight> &edge);
+    // добавление пачки рёбер с id по порядку; списки смежности выделяются один раз точного размера
+    void AddEdges(std::vector<Edge<Weight>> edges);
+    VertexId AddVertex();
+    // ребро исключается из списков исходящих и входящих рёбер, но его id не переиспользуется
+    void RemoveEdge(EdgeId edge_id);
 
     size_t GetVertexCount() const;
+    // число выданных id рёбер, включая удалённые
     size_t GetEdgeCount() const;
     const Edge<Weight> &GetEdge(EdgeId edge_id) const;
+    bool IsEdgeRemoved(EdgeId edge_id) const;
     IncidentEdgesRange GetIncidentEdges(VertexId vertex) const;
+    // рёбра, входящие в vertex, - для поиска в обратную сторону
+    IncidentEdgesRange GetIncomingEdges(VertexId vertex) const;
 
 private:
     std::vector<Edge<Weight>> edges_;
+    std::vector<bool> removed_edges_;
     std::vector<IncidenceList> incidence_lists_;
+    std::vector<IncidenceList> reverse_incidence_lists_;
 };
 
 template <typename Weight>
 DirectedWeightedGraph<Weight>::DirectedWeightedGraph(size_t vertex_count)
-    : incidence_lists_(vertex_count) {
+    : incidence_lists_(vertex_count)
+    , reverse_incidence_lists_(vertex_count) {
 }
 
 template <typename Weight>
 EdgeId DirectedWeightedGraph<Weight>::AddEdge(const Edge<Weight> &edge) {
     edges_.push_back(edge);
+    removed_edges_.push_back(false);
     const EdgeId id = edges_.size() - 1;
     incidence_lists_.at(edge.from).push_back(id);
+    reverse_incidence_lists_.at(edge.to).push_back(id);
     return id;
 }
 
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::AddEdges(std::vector<Edge<Weight>> edges) {
+    std::vector<size_t> added_degrees(incidence_lists_.size());
+    std::vector<size_t> added_in_degrees(incidence_lists_.size());
+    for (const auto &edge : edges) {
+        ++added_degrees.at(edge.from);
+        ++added_in_degrees.at(edge.to);
+    }
+    for (VertexId vertex = 0; vertex < incidence_lists_.size(); ++vertex) {
+        incidence_lists_[vertex].reserve(incidence_lists_[vertex].size() + added_degrees[vertex]);
+        reverse_incidence_lists_[vertex].reserve(reverse_incidence_lists_[vertex].size() + added_in_degrees[vertex]);
+    }
+    const EdgeId first_edge = edges_.size();
+    for (size_t i = 0; i < edges.size(); ++i) {
+        incidence_lists_[edges[i].from].push_back(first_edge + i);
+        reverse_incidence_lists_[edges[i].to].push_back(first_edge + i);
+    }
+    removed_edges_.resize(removed_edges_.size() + edges.size(), false);
+    if (edges_.empty()) {
+        edges_ = std::move(edges);
+    } else {
+        edges_.insert(edges_.end(), edges.begin(), edges.end());
+    }
+}
+
+template <typename Weight>
+VertexId DirectedWeightedGraph<Weight>::AddVertex() {
+    incidence_lists_.emplace_back();
+    reverse_incidence_lists_.emplace_back();
+    return incidence_lists_.size() - 1;
+}
+
+template <typename Weight>
+void DirectedWeightedGraph<Weight>::RemoveEdge(EdgeId edge_id) {
+    if (removed_edges_.at(edge_id)) {
+        return;
+    }
+    removed_edges_[edge_id] = true;
+    auto &incidence_list = incidence_lists_.at(edges_[edge_id].from);
+    incidence_list.erase(std::find(incidence_list.begin(), incidence_list.end(), edge_id));
+    auto &reverse_incidence_list = reverse_incidence_lists_.at(edges_[edge_id].to);
+    reverse_incidence_list.erase(std::find(reverse_incidence_list.begin(), reverse_incidence_list.end(), edge_id));
+}
+
 template <typename Weight>
 size_t DirectedWeightedGraph<Weight>::GetVertexCount() const {
     return incidence_lists_.size();
@@ -69,9 +130,20 @@ const Edge<Weight> &DirectedWeightedGraph<Weight>::GetEdge(EdgeId edge_id) const
     return edges_.at(edge_id);
 }
 
+template <typename Weight>
+bool DirectedWeightedGraph<Weight>::IsEdgeRemoved(EdgeId edge_id) const {
+    return removed_edges_.at(edge_id);
+}
+
 template <typename Weight>
 typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
 DirectedWeightedGraph<Weight>::GetIncidentEdges(VertexId vertex) const {
     return ranges::AsRange(incidence_lists_.at(vertex));
 }
+
+template <typename Weight>
+typename DirectedWeightedGraph<Weight>::IncidentEdgesRange
+DirectedWeightedGraph<Weight>::GetIncomingEdges(VertexId vertex) const {
+    return ranges::AsRange(reverse_incidence_lists_.at(vertex));
+}
 } // namespace graph
\ No newline at end of file
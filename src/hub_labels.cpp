@@ -0,0 +1,292 @@
+#include "hub_labels.h"
+
+#include <algorithm>
+#include <cstddef>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+namespace graph {
+
+namespace {
+const double INF = std::numeric_limits<double>::infinity();
+// число корней выборки для порядка вершин
+const size_t SAMPLE_ROOTS_COUNT = 32;
+
+const uint32_t NO_EDGE = std::numeric_limits<uint32_t>::max();
+
+struct LabelEntry {
+    uint32_t hub;
+    double distance;
+    uint32_t edge;
+};
+using BuildLabels = std::vector<std::vector<LabelEntry>>;
+
+template <typename Labels>
+Labels Flatten(const BuildLabels &labels) {
+    Labels result;
+    result.offsets.reserve(labels.size() + 1);
+    result.offsets.push_back(0);
+    for (const auto &label : labels) {
+        result.offsets.push_back(result.offsets.back() + label.size());
+    }
+    result.hubs.reserve(result.offsets.back());
+    result.distances.reserve(result.offsets.back());
+    result.edges.reserve(result.offsets.back());
+    for (const auto &label : labels) {
+        for (const auto &entry : label) {
+            result.hubs.push_back(entry.hub);
+            result.distances.push_back(entry.distance);
+            result.edges.push_back(entry.edge);
+        }
+    }
+    return result;
+}
+} // namespace
+
+HubLabels::HubLabels(const DirectedWeightedGraph<double> &graph)
+    : graph_(graph) {
+    const size_t vertex_count = graph.GetVertexCount();
+    if (vertex_count >= NO_EDGE || graph.GetEdgeCount() >= NO_EDGE) {
+        throw std::length_error("Too many vertices or edges for hub labels");
+    }
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+            if (graph.GetEdge(edge_id).weight < 0.) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+        }
+    }
+    // Раньше обрабатываются вершины, через которые проходит больше кратчайших путей: для выборки корней строятся
+    // деревья кратчайших путей, важность вершины - сумма размеров её поддеревьев
+    std::vector<double> importance(vertex_count);
+    {
+        std::vector<double> distances(vertex_count);
+        std::vector<VertexId> parents(vertex_count);
+        std::vector<VertexId> settled;
+        std::vector<double> subtree_sizes(vertex_count);
+        using QueueItem = std::pair<double, VertexId>;
+        std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+        const size_t samples_count = std::min<size_t>(vertex_count, SAMPLE_ROOTS_COUNT);
+        for (size_t sample = 0; sample < samples_count; ++sample) {
+            const VertexId root = sample * vertex_count / samples_count;
+            std::fill(distances.begin(), distances.end(), INF);
+            settled.clear();
+            distances[root] = 0.;
+            parents[root] = root;
+            queue.push({0., root});
+            while (!queue.empty()) {
+                const auto [distance, vertex] = queue.top();
+                queue.pop();
+                if (distances[vertex] < distance) {
+                    continue;
+                }
+                settled.push_back(vertex);
+                for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+                    const auto &edge = graph.GetEdge(edge_id);
+                    if (distance + edge.weight < distances[edge.to]) {
+                        distances[edge.to] = distance + edge.weight;
+                        parents[edge.to] = vertex;
+                        queue.push({distances[edge.to], edge.to});
+                    }
+                }
+            }
+            // поддеревья собираются от дальних вершин к ближним
+            for (const VertexId vertex : settled) {
+                subtree_sizes[vertex] = 1.;
+            }
+            for (auto it = settled.rbegin(); it != settled.rend(); ++it) {
+                importance[*it] += subtree_sizes[*it];
+                if (*it != root) {
+                    subtree_sizes[parents[*it]] += subtree_sizes[*it];
+                }
+            }
+        }
+    }
+    std::vector<VertexId> order(vertex_count);
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        order[vertex] = vertex;
+    }
+    std::stable_sort(order.begin(), order.end(), [&importance](VertexId lhs, VertexId rhs) {
+        return importance[lhs] > importance[rhs];
+    });
+
+    BuildLabels forward(vertex_count);
+    BuildLabels backward(vertex_count);
+    // расстояния между корнем поиска и опорными вершинами его метки, индекс - ранг опорной вершины
+    std::vector<double> root_distances(vertex_count, INF);
+    std::vector<double> distances(vertex_count, INF);
+    // ребро дерева поиска, по которому вершина достигнута
+    std::vector<uint32_t> parent_edges(vertex_count, NO_EDGE);
+    std::vector<VertexId> visited;
+    using QueueItem = std::pair<double, VertexId>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+
+    // Дейкстра из root с отсечением: root_label - метка корня, labels - метки, в которые пишется ранг корня
+    const auto pruned_search = [&](VertexId root, uint32_t rank, const std::vector<LabelEntry> &root_label, BuildLabels &labels,
+                                   bool reverse) {
+        for (const auto &entry : root_label) {
+            root_distances[entry.hub] = entry.distance;
+        }
+        distances[root] = 0.;
+        parent_edges[root] = NO_EDGE;
+        visited.push_back(root);
+        queue.push({0., root});
+        while (!queue.empty()) {
+            const auto [distance, vertex] = queue.top();
+            queue.pop();
+            if (distances[vertex] < distance) {
+                continue;
+            }
+            // Путь через уже обработанные опорные вершины не длиннее: вершина и её поддерево не размечаются.
+            // Поэтому у предка размеченной вершины в дереве поиска тоже есть запись о корне
+            const bool covered = std::any_of(labels[vertex].begin(), labels[vertex].end(), [&](const LabelEntry &entry) {
+                return root_distances[entry.hub] + entry.distance <= distance;
+            });
+            if (covered) {
+                continue;
+            }
+            labels[vertex].push_back({rank, distance, parent_edges[vertex]});
+            const auto relax = [&](VertexId next, EdgeId edge_id, double weight) {
+                const double candidate = distance + weight;
+                if (candidate < distances[next]) {
+                    if (distances[next] == INF) {
+                        visited.push_back(next);
+                    }
+                    distances[next] = candidate;
+                    parent_edges[next] = static_cast<uint32_t>(edge_id);
+                    queue.push({candidate, next});
+                }
+            };
+            if (reverse) {
+                for (const EdgeId edge_id : graph.GetIncomingEdges(vertex)) {
+                    const auto &edge = graph.GetEdge(edge_id);
+                    relax(edge.from, edge_id, edge.weight);
+                }
+            } else {
+                for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+                    const auto &edge = graph.GetEdge(edge_id);
+                    relax(edge.to, edge_id, edge.weight);
+                }
+            }
+        }
+        for (const VertexId vertex : visited) {
+            distances[vertex] = INF;
+        }
+        visited.clear();
+        for (const auto &entry : root_label) {
+            root_distances[entry.hub] = INF;
+        }
+    };
+
+    for (uint32_t rank = 0; rank < vertex_count; ++rank) {
+        const VertexId root = order[rank];
+        // пути root -> v пишутся в обратные метки, пути v -> root - в прямые
+        pruned_search(root, rank, forward[root], backward, false);
+        pruned_search(root, rank, backward[root], forward, true);
+    }
+    forward_ = Flatten<Labels>(forward);
+    backward_ = Flatten<Labels>(backward);
+}
+
+HubLabels::HubLabels(const HubLabels &other, const DirectedWeightedGraph<double> &graph)
+    : graph_(graph),
+      forward_(other.forward_),
+      backward_(other.backward_) {
+}
+
+std::optional<double> HubLabels::GetDistance(VertexId from, VertexId to) const {
+    const auto hub = FindHub(from, to);
+    if (!hub) {
+        return std::nullopt;
+    }
+    return forward_.distances[hub->first] + backward_.distances[hub->second];
+}
+
+std::optional<double> HubLabels::BuildRoute(VertexId from, VertexId to, Router<double>::RouteEdges &edges) const {
+    edges.clear();
+    const auto hub = FindHub(from, to);
+    if (!hub) {
+        return std::nullopt;
+    }
+    const uint32_t hub_rank = forward_.hubs[hub->first];
+    // от начала до опорной вершины по первым рёбрам путей прямых меток
+    for (size_t entry = hub->first; forward_.edges[entry] != NO_EDGE;) {
+        const EdgeId edge_id = forward_.edges[entry];
+        const auto &edge = graph_.GetEdge(edge_id);
+        edges.emplace_back(edge_id, &edge);
+        entry = FindEntry(forward_, edge.to, hub_rank);
+    }
+    // от конца до опорной вершины по последним рёбрам путей обратных меток, затем в порядке поездки
+    const size_t first_back_edge = edges.size();
+    for (size_t entry = hub->second; backward_.edges[entry] != NO_EDGE;) {
+        const EdgeId edge_id = backward_.edges[entry];
+        const auto &edge = graph_.GetEdge(edge_id);
+        edges.emplace_back(edge_id, &edge);
+        entry = FindEntry(backward_, edge.from, hub_rank);
+    }
+    std::reverse(edges.begin() + first_back_edge, edges.end());
+    double weight = 0.;
+    for (const auto &[edge_id, edge] : edges) {
+        weight += edge->weight;
+    }
+    return weight;
+}
+
+std::optional<std::pair<size_t, size_t>> HubLabels::FindHub(VertexId from, VertexId to) const {
+    const size_t vertex_count = forward_.offsets.size() - 1;
+    if (from >= vertex_count || to >= vertex_count) {
+        throw std::out_of_range("Vertex is out of the hub labels");
+    }
+    // слияние упорядоченных по рангу списков
+    size_t i = forward_.offsets[from];
+    const size_t i_end = forward_.offsets[from + 1];
+    size_t j = backward_.offsets[to];
+    const size_t j_end = backward_.offsets[to + 1];
+    double best = INF;
+    std::optional<std::pair<size_t, size_t>> best_entries;
+    while (i < i_end && j < j_end) {
+        const uint32_t hub_from = forward_.hubs[i];
+        const uint32_t hub_to = backward_.hubs[j];
+        if (hub_from == hub_to) {
+            const double distance = forward_.distances[i] + backward_.distances[j];
+            if (distance < best) {
+                best = distance;
+                best_entries = {i, j};
+            }
+            ++i;
+            ++j;
+        } else if (hub_from < hub_to) {
+            ++i;
+        } else {
+            ++j;
+        }
+    }
+    return best_entries;
+}
+
+size_t HubLabels::FindEntry(const Labels &labels, VertexId vertex, uint32_t hub_rank) {
+    const auto begin = labels.hubs.begin() + static_cast<std::ptrdiff_t>(labels.offsets[vertex]);
+    const auto end = labels.hubs.begin() + static_cast<std::ptrdiff_t>(labels.offsets[vertex + 1]);
+    const auto pos = std::lower_bound(begin, end, hub_rank);
+    if (pos == end || *pos != hub_rank) {
+        throw std::logic_error("Hub labels are inconsistent");
+    }
+    return static_cast<size_t>(pos - labels.hubs.begin());
+}
+
+size_t HubLabels::GetEntriesCount() const {
+    return forward_.hubs.size() + backward_.hubs.size();
+}
+
+size_t HubLabels::GetMemoryBytes() const {
+    const auto bytes = [](const Labels &labels) {
+        return labels.offsets.size() * sizeof(size_t) + labels.hubs.size() * sizeof(uint32_t) + labels.distances.size() * sizeof(double)
+               + labels.edges.size() * sizeof(uint32_t);
+    };
+    return bytes(forward_) + bytes(backward_);
+}
+
+} // namespace graph
@@ -0,0 +1,68 @@
+#pragma once
+
+#include "graph.h"
+#include "router.h"
+
+#include <cstddef>
+#include <cstdint>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Двухточечная разметка (hub labeling) для запросов времени в пути.
+// У каждой вершины две метки - списки пар (опорная вершина, расстояние): до опорных вершин (прямая метка)
+// и от них (обратная). Кратчайший путь s -> t проходит через опорную вершину из прямой метки s и обратной метки t,
+// поэтому расстояние - минимум суммы по общим опорным вершинам, найденный слиянием двух упорядоченных списков.
+// Метки строятся отсечением (pruned landmark labeling): вершины обходятся по убыванию степени, из каждой
+// запускается Дейкстра в обе стороны, и вершина не получает метку, если уже построенные метки дают путь не длиннее
+class HubLabels {
+public:
+    explicit HubLabels(const DirectedWeightedGraph<double> &graph);
+
+    // те же метки для копии графа (с теми же вершинами и рёбрами)
+    HubLabels(const HubLabels &other, const DirectedWeightedGraph<double> &graph);
+
+    HubLabels(const HubLabels &) = delete;
+    HubLabels &operator=(const HubLabels &) = delete;
+
+    // время в пути, std::nullopt если маршрута нет
+    std::optional<double> GetDistance(VertexId from, VertexId to) const;
+
+    // Восстановление маршрута через лучшую общую опорную вершину по рёбрам, сохранённым в записях меток.
+    // Рёбра пишутся в edges в порядке поездки, возвращается сумма их весов.
+    // При равных по времени вариантах маршрут может отличаться от маршрута таблицы
+    std::optional<double> BuildRoute(VertexId from, VertexId to, Router<double>::RouteEdges &edges) const;
+
+    // общее число записей в метках всех вершин
+    size_t GetEntriesCount() const;
+
+    // память меток, байт
+    size_t GetMemoryBytes() const;
+
+private:
+    // Метки всех вершин подряд: записи вершины v - [offsets[v], offsets[v + 1]), по возрастанию ранга опорной вершины.
+    // edges - ребро пути к опорной вершине, смежное с v (первое в прямой метке, последнее в обратной);
+    // у его другого конца есть запись о той же опорной вершине
+    struct Labels {
+        std::vector<size_t> offsets;
+        std::vector<uint32_t> hubs;
+        std::vector<double> distances;
+        std::vector<uint32_t> edges;
+    };
+
+    // индексы записей лучшей общей опорной вершины в forward_ и backward_, std::nullopt если её нет
+    std::optional<std::pair<size_t, size_t>> FindHub(VertexId from, VertexId to) const;
+
+    // индекс записи об опорной вершине hub_rank в метке vertex
+    static size_t FindEntry(const Labels &labels, VertexId vertex, uint32_t hub_rank);
+
+    const DirectedWeightedGraph<double> &graph_;
+    // расстояния до опорных вершин
+    Labels forward_;
+    // расстояния от опорных вершин
+    Labels backward_;
+};
+
+} // namespace graph
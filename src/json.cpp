@@ -355,13 +355,22 @@ Document Load(istream &input) {
 
 // Контекст вывода, хранит ссылку на поток вывода и текущий отсуп
 void PrintContext::PrintIndent() const {
+    if (compact) {
+        return;
+    }
     for (int i = 0; i < indent; ++i) {
         out.put(' ');
     }
 }
 
+void PrintContext::PrintLineBreak() const {
+    if (!compact) {
+        out.put('\n');
+    }
+}
+
 PrintContext PrintContext::Indented() const {
-    return {out, indent_step, indent_step + indent};
+    return {out, indent_step, indent_step + indent, compact};
 }
 
 void Print(const Document &doc, std::ostream &output) {
@@ -371,6 +380,11 @@ void Print(const Document &doc, std::ostream &output) {
     PrintNode(doc.GetRoot(), ctx);
 }
 
+void PrintCompact(const Document &doc, std::ostream &output) {
+    PrintContext ctx(output, 0, 0, true);
+    PrintNode(doc.GetRoot(), ctx);
+}
+
 void PrintValue(const std::string &str, const PrintContext &ctx) {
     ctx.out << "\"";
     for (const auto &c : str) {
@@ -398,16 +412,18 @@ void PrintValue(const std::nullptr_t&, const PrintContext &ctx) {
 void PrintValue(const Array& array, const PrintContext &ctx) {
     auto ctx_a = ctx.Indented();
     bool is_first = true;
-    ctx.out << "["s << '\n';
+    ctx.out << "["s;
+    ctx.PrintLineBreak();
     for (const auto &item : array) {
         if (!is_first) {
-            ctx.out << "," << '\n';
+            ctx.out << ",";
+            ctx.PrintLineBreak();
         }
         ctx_a.PrintIndent();
         PrintNode(item, ctx_a);
         is_first = false;
     }
-    ctx.out << '\n';
+    ctx.PrintLineBreak();
     ctx.PrintIndent();
     ctx.out << "]"s;
 }
@@ -421,14 +437,14 @@ void PrintValue(const Dict& dict, const PrintContext &ctx) {
         if (!is_first) {
             ctx.out << ","s;
         }
-        ctx.out << '\n';
+        ctx.PrintLineBreak();
         ctx_a.PrintIndent();
         ctx.out << "\""s;
-        ctx.out << item.first << "\": "s;
+        ctx.out << item.first << (ctx.compact ? "\":"s : "\": "s);
         PrintNode(item.second, ctx_a);
         is_first = false;
     }
-    ctx.out << '\n';
+    ctx.PrintLineBreak();
     ctx.PrintIndent();
     ctx.out << "}"s;
 }
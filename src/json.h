@@ -77,19 +77,27 @@ Document Load(std::istream &input);
 
 // Контекст вывода, хранит ссылку на поток вывода и текущий отсуп
  struct PrintContext {
-    PrintContext(std::ostream& output, int step, int ind) : out(output), indent_step(step), indent(ind) {}
+    PrintContext(std::ostream& output, int step, int ind, bool is_compact = false)
+        : out(output), indent_step(step), indent(ind), compact(is_compact) {}
     std::ostream& out;
     int indent_step = 4;
     int indent = 0;
+    // компактный вывод в одну строку, без переносов и отступов
+    bool compact = false;
 
     void PrintIndent() const;
 
+    void PrintLineBreak() const;
+
     // Возвращает новый контекст вывода с увеличенным смещением
     PrintContext Indented() const;
 }; 
 
 void Print(const Document &doc, std::ostream &out);
 
+// Вывод документа одной строкой (для построчного обмена документами)
+void PrintCompact(const Document &doc, std::ostream &out);
+
 void PrintNode(const Node &node, const PrintContext& ctx);
 
 inline void PrintValue(const std::string &str, const PrintContext& ctx);
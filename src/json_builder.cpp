@@ -9,8 +9,11 @@ namespace json {
 
 Builder::Builder()
     : root_()
-    , nodes_stack_{&root_}
-{}
+{
+    // глубина обычного ответа невелика: стек выделяется один раз
+    nodes_stack_.reserve(4);
+    nodes_stack_.push_back(&root_);
+}
 
 Node Builder::Build() {
     if (!nodes_stack_.empty()) {
@@ -1,16 +1,27 @@
 #include <algorithm>
+#include <chrono>
 #include <set>
 #include <sstream>
+#include <stdexcept>
+#include <string>
 #include <vector>
 
 #include "json_builder.h"
 #include "json_reader.h"
 #include "map_renderer.h"
 
+domain::BusSchedule ParseBusSchedule(const json::Node &schedule_node) {
+    const auto &schedule = schedule_node.AsDict();
+    return {schedule.at("first_departure").AsDouble(), schedule.at("last_departure").AsDouble(), schedule.at("headway").AsDouble()};
+}
+
 void FillBusesAndStops(TransportCatalogue &db, const std::vector<json::Node> &array_copy) {
     for (const auto &item : array_copy) {
         if (item.AsDict().at("type").AsString() == "Stop") {
             db.AddStop(item.AsDict().at("name").AsString(), {item.AsDict().at("latitude").AsDouble(), item.AsDict().at("longitude").AsDouble()});
+            if (item.AsDict().count("transfer_time")) {
+                db.SetTransferTime(item.AsDict().at("name").AsString(), item.AsDict().at("transfer_time").AsDouble());
+            }
         } else {
             std::vector<std::string_view> string_vec;
             for (const auto &node1 : item.AsDict().at("stops").AsArray()) {
@@ -20,6 +31,9 @@ void FillBusesAndStops(TransportCatalogue &db, const std::vector<json::Node> &ar
                 string_vec.insert(string_vec.end(), std::next(string_vec.rbegin()), string_vec.rend());
             }
             db.AddBus(item.AsDict().at("name").AsString(), string_vec, item.AsDict().at("is_roundtrip").AsBool());
+            if (item.AsDict().count("schedule")) {
+                db.SetBusSchedule(item.AsDict().at("name").AsString(), ParseBusSchedule(item.AsDict().at("schedule")));
+            }
         }
     }
 }
@@ -49,9 +63,48 @@ void LoadCatalogue(TransportCatalogue &db, const std::vector<json::Node> &base_r
     }
     FillBusesAndStops(db, array_copy);
     FillRoadDistances(db, array_copy);
+    db.RefreshStatistics();
+}
+
+void UpdateCatalogue(TransportCatalogue &db, const std::vector<json::Node> &update_req) {
+    // сначала новые остановки, чтобы на них могли ссылаться маршруты и расстояния
+    for (const auto &item : update_req) {
+        const auto &dict = item.AsDict();
+        if (dict.at("type").AsString() == "Stop" && !db.FindStop(dict.at("name").AsString())) {
+            db.AddStop(dict.at("name").AsString(), {dict.at("latitude").AsDouble(), dict.at("longitude").AsDouble()});
+        }
+        if (dict.at("type").AsString() == "Stop" && dict.count("transfer_time")) {
+            db.SetTransferTime(dict.at("name").AsString(), dict.at("transfer_time").AsDouble());
+        }
+    }
+    FillRoadDistances(db, update_req);
+    for (const auto &item : update_req) {
+        const auto &dict = item.AsDict();
+        if (dict.at("type").AsString() != "Bus") {
+            continue;
+        }
+        if (dict.count("remove") && dict.at("remove").AsBool()) {
+            db.RemoveBus(dict.at("name").AsString());
+            continue;
+        }
+        std::vector<std::string_view> string_vec;
+        for (const auto &node1 : dict.at("stops").AsArray()) {
+            string_vec.emplace_back(node1.AsString());
+        }
+        if (!dict.at("is_roundtrip").AsBool()) {
+            string_vec.insert(string_vec.end(), std::next(string_vec.rbegin()), string_vec.rend());
+        }
+        db.UpdateBus(dict.at("name").AsString(), string_vec, dict.at("is_roundtrip").AsBool());
+        if (dict.count("schedule")) {
+            db.SetBusSchedule(dict.at("name").AsString(), ParseBusSchedule(dict.at("schedule")));
+        }
+    }
+    db.RefreshStatistics();
 }
 
 void MakeSvg(std::ostream &out, const RequestHandler &req_handler, MapRenderer &renderer) {
+    // отрисовщик может использоваться для нескольких запросов Map подряд
+    renderer.Clear();
     StopPointsSetter(req_handler, renderer);
 
     auto polyline_set = MakePolylineMap(renderer);
@@ -67,65 +120,212 @@ void MakeSvg(std::ostream &out, const RequestHandler &req_handler, MapRenderer &
     renderer.DocRender(out);
 }
 
-json::Document GetReqsResults(const RequestHandler &req_handler, const std::vector<json::Node> &base_req, MapRenderer &renderer) {
+namespace {
+// Предел поездок для вариантов с пересадками: max_transfers + 1, 0 - без ограничения.
+// Отрицательное число пересадок - ошибка запроса; большое равносильно отсутствию ограничения,
+// поиск всё равно останавливается, когда маршруты перестают улучшаться
+size_t ParseMaxRides(const json::Dict &req) {
+    if (!req.count("max_transfers")) {
+        return 0;
+    }
+    const int max_transfers = req.at("max_transfers").AsInt();
+    if (max_transfers < 0) {
+        throw std::invalid_argument("max_transfers should be non-negative: " + std::to_string(max_transfers));
+    }
+    return static_cast<size_t>(max_transfers) + 1;
+}
+} // namespace
+
+json::Node GetReqResult(const RequestHandler &req_handler, const json::Node &req, MapRenderer &renderer) {
     json::Node tmp_node;
+    auto req_id = req.AsDict().at("id").AsInt();
+    if (req.AsDict().at("type").AsString() == "Stop") {
+        // формирование структуры статистики остановок и создание по нему json-объекта
+        domain::StopStat stop_stat = req_handler.GetBusesByStop(req.AsDict().at("name").AsString());
+        tmp_node = StopStatLoad(std::move(stop_stat), req_id);
+    } else if (req.AsDict().at("type").AsString() == "Bus") {
+        // формирование структуры статистики маршрутов и создание по нему json-объекта
+        domain::BusStat bus_stat = req_handler.GetBusStat(req.AsDict().at("name").AsString());
+        tmp_node = BusStatLoad(std::move(bus_stat), req_id);
+    } else if (req.AsDict().at("type").AsString() == "Map") {
+        // формирование svg-объекта в формате xml и передача их в json-объект
+        std::ostringstream ostr;
+        MakeSvg(ostr, req_handler, renderer);
+        auto nod = ostr.str();
+        tmp_node = json::Builder{}.StartDict().Key("map").Value(nod).Key("request_id").Value(req_id).EndDict().Build();
+    } else if (req.AsDict().at("type").AsString() == "Route") {
+        // формирование ответа по маршруту
+        std::string_view from = req.AsDict().at("from").AsString();
+        std::string_view to = req.AsDict().at("to").AsString();
+        // варианты с разным числом пересадок или с временем отправления - поездка по расписаниям
+        if (req.AsDict().count("pareto") && req.AsDict().at("pareto").AsBool()) {
+            tmp_node = ParetoRoutesToNode(req_handler.GetParetoRoutes(from, to, ParseMaxRides(req.AsDict())), req_id);
+        } else if (req.AsDict().count("time_only") && req.AsDict().at("time_only").AsBool()) {
+            tmp_node = RouteTimeToNode(req_handler.GetRouteTime(from, to), req_id);
+        } else if (req.AsDict().count("departure_time")) {
+            const auto journey = req_handler.GetJourney(from, to, req.AsDict().at("departure_time").AsDouble());
+            tmp_node = JourneyToNode(journey, req_id, req_handler);
+        } else {
+            // буфер рёбер переиспользуется между запросами потока
+            thread_local graph::Router<double>::RouteEdges route_edges;
+            const auto total_time = req_handler.GetOptimalRoute(from, to, route_edges);
+            tmp_node = RouteToNode(total_time, route_edges, req_id);
+        }
+    } else if (req.AsDict().at("type").AsString() == "Matrix") {
+        // только время в пути для всех пар, маршруты не восстанавливаются
+        const auto to_names = [](const json::Array &stops) {
+            std::vector<std::string_view> names;
+            names.reserve(stops.size());
+            for (const auto &stop : stops) {
+                names.push_back(stop.AsString());
+            }
+            return names;
+        };
+        const auto times = req_handler.GetTravelTimes(to_names(req.AsDict().at("origins").AsArray()),
+                                                      to_names(req.AsDict().at("destinations").AsArray()));
+        tmp_node = MatrixToNode(times, req_id);
+    }
+    return tmp_node;
+}
+
+namespace {
+// запрос Route без вариантов с пересадками, только времени и отправления по расписанию
+bool IsPlainRouteRequest(const json::Dict &req) {
+    return req.at("type").AsString() == "Route" && !(req.count("pareto") && req.at("pareto").AsBool())
+           && !(req.count("time_only") && req.at("time_only").AsBool()) && !req.count("departure_time");
+}
+} // namespace
+
+json::Document GetReqsResults(const RequestHandler &req_handler, const std::vector<json::Node> &base_req, MapRenderer &renderer,
+                              profile::Profiler *profiler) {
+    const auto elapsed_us = [](std::chrono::steady_clock::time_point start) {
+        return std::chrono::duration<double, std::micro>(std::chrono::steady_clock::now() - start).count();
+    };
+    // Обычные запросы Route считаются заранее одним пакетом: запросы с общей исходной остановкой
+    // обходятся одним поиском, а ответы встают на места запросов
+    std::vector<size_t> route_requests;
+    std::vector<std::pair<std::string_view, std::string_view>> route_pairs;
+    for (size_t i = 0; i < base_req.size(); ++i) {
+        const auto &req = base_req[i].AsDict();
+        if (IsPlainRouteRequest(req)) {
+            route_requests.push_back(i);
+            route_pairs.emplace_back(req.at("from").AsString(), req.at("to").AsString());
+        }
+    }
+    const auto batch_start = std::chrono::steady_clock::now();
+    const auto routes = req_handler.GetOptimalRoutes(route_pairs);
+    const double route_share_us = route_requests.empty() ? 0. : elapsed_us(batch_start) / static_cast<double>(route_requests.size());
+
     json::Array res_array;
-    for (auto &req : base_req) {
-        auto req_id = req.AsDict().at("id").AsInt();
-        if (req.AsDict().at("type").AsString() == "Stop") {
-            // формирование структуры статистики остановок и создание по нему json-объекта
-            domain::StopStat stop_stat = req_handler.GetBusesByStop(req.AsDict().at("name").AsString());
-            tmp_node = StopStatLoad(std::move(stop_stat), req_id);
-        } else if (req.AsDict().at("type").AsString() == "Bus") {
-            // формирование структуры статистики маршрутов и создание по нему json-объекта
-            domain::BusStat bus_stat = req_handler.GetBusStat(req.AsDict().at("name").AsString());
-            tmp_node = BusStatLoad(std::move(bus_stat), req_id);
-        } else if (req.AsDict().at("type").AsString() == "Map") {
-            // формирование svg-объекта в формате xml и передача их в json-объект
-            std::ostringstream ostr;
-            MakeSvg(ostr, req_handler, renderer);
-            auto nod = ostr.str();
-            tmp_node = json::Builder{}.StartDict().Key("map").Value(nod).Key("request_id").Value(req_id).EndDict().Build();
-        } else if (req.AsDict().at("type").AsString() == "Route") {
-            // формирование ответа по маршруту
-            std::string_view from = req.AsDict().at("from").AsString();
-            std::string_view to = req.AsDict().at("to").AsString();
-            auto route_data = req_handler.GetOptimalRoute(from, to);
-            tmp_node = RouteToNode(std::move(route_data), req_id);
-        }
-        res_array.push_back(tmp_node);
+    res_array.reserve(base_req.size());
+    size_t next_route = 0;
+    for (size_t i = 0; i < base_req.size(); ++i) {
+        const auto start = std::chrono::steady_clock::now();
+        double request_us = 0.;
+        if (next_route < route_requests.size() && route_requests[next_route] == i) {
+            const auto &route = routes[next_route++];
+            const auto req_id = base_req[i].AsDict().at("id").AsInt();
+            res_array.push_back(route ? RouteToNode(route->weight, route->edges, req_id) : RouteToNode(std::nullopt, {}, req_id));
+            request_us = route_share_us;
+        } else {
+            res_array.push_back(GetReqResult(req_handler, base_req[i], renderer));
+        }
+        if (profiler) {
+            profiler->AddRequest(base_req[i].AsDict().at("type").AsString(), request_us + elapsed_us(start));
+        }
     }
     json::Document result_doc(std::move(res_array));
     return result_doc;
 }
 
-const json::Node RouteToNode(const std::optional<graph::Router<double>::RouteInfo> &route_data, const int req_id) {
+// Словари элементов собираются без Builder: его стек узлов - лишнее выделение памяти на каждый элемент,
+// и память элемента - только узлы его словаря (и имя длиннее буфера короткой строки)
+json::Array RouteItemsToNode(const graph::Router<double>::RouteEdges &edges) {
+    json::Array route_list;
+    route_list.reserve(edges.size());
+    for (const auto &edge : edges) {
+        const auto &edge_item = *edge.second;
+        json::Dict item;
+        if (edge_item.span == 0) {
+            item.emplace("stop_name", std::string(edge_item.name));
+            item.emplace("time", edge_item.weight);
+            item.emplace("type", std::string("Wait"));
+        } else {
+            item.emplace("bus", std::string(edge_item.name));
+            item.emplace("span_count", static_cast<int>(edge_item.span));
+            item.emplace("time", edge_item.weight);
+            item.emplace("type", std::string("Bus"));
+        }
+        route_list.emplace_back(std::move(item));
+    }
+    return route_list;
+}
+
+json::Node RouteToNode(const std::optional<double> &total_time, const graph::Router<double>::RouteEdges &edges, const int req_id) {
     json::Node result;
 
-    if (!route_data.has_value()) {
+    if (!total_time.has_value()) {
         result = json::Builder{}.StartDict().Key("error_message").Value("not found").Key("request_id").Value(req_id).EndDict().Build();
     } else {
-        json::Array route_list;
-        route_list.reserve(route_data.value().edges.size());
-        double total_time = 0.;
-        for (const auto &edge : route_data.value().edges) {
-            // const auto edge_map = req_handler.GetRouterGraph().GetEdge(edge);
-            // std::cout << *;
-            auto edge_item = *edge.second;
-            if (edge_item.span == 0) {
-                route_list.emplace_back(json::Node(json::Builder{}.StartDict().Key("stop_name").Value(edge_item.name).Key("time").Value(edge_item.weight).Key("type").Value("Wait").EndDict().Build()));
-                total_time += edge_item.weight;
-            } else {
-                route_list.emplace_back(json::Node(json::Builder{}.StartDict().Key("bus").Value(edge_item.name).Key("span_count").Value(static_cast<int>(edge_item.span)).Key("time").Value(edge_item.weight).Key("type").Value("Bus").EndDict().Build()));
-                total_time += edge_item.weight;
-            }
-        }
-        result = json::Builder{}.StartDict().Key("items").Value(route_list).Key("request_id").Value(req_id).Key("total_time").Value(total_time).EndDict().Build();
+        result = json::Builder{}.StartDict().Key("items").Value(RouteItemsToNode(edges)).Key("request_id").Value(req_id).Key("total_time").Value(*total_time).EndDict().Build();
     }
     return result;
 }
 
-const json::Node BusStatLoad(const domain::BusStat bus_stat, const int req_id) {
+json::Node RouteTimeToNode(const std::optional<double> &total_time, const int req_id) {
+    if (!total_time.has_value()) {
+        return json::Builder{}.StartDict().Key("error_message").Value("not found").Key("request_id").Value(req_id).EndDict().Build();
+    }
+    return json::Builder{}.StartDict().Key("request_id").Value(req_id).Key("total_time").Value(*total_time).EndDict().Build();
+}
+
+json::Node ParetoRoutesToNode(const std::vector<graph::Router<double>::RouteInfo> &routes, const int req_id) {
+    if (routes.empty()) {
+        return json::Builder{}.StartDict().Key("error_message").Value("not found").Key("request_id").Value(req_id).EndDict().Build();
+    }
+    json::Array routes_list;
+    routes_list.reserve(routes.size());
+    for (const auto &route : routes) {
+        const auto rides = std::count_if(route.edges.begin(), route.edges.end(), [](const auto &edge) {
+            return edge.second->span > 0;
+        });
+        routes_list.emplace_back(json::Node(json::Builder{}.StartDict().Key("items").Value(RouteItemsToNode(route.edges)).Key("total_time").Value(route.weight).Key("transfers").Value(static_cast<int>(std::max<std::ptrdiff_t>(rides - 1, 0))).EndDict().Build()));
+    }
+    return json::Builder{}.StartDict().Key("request_id").Value(req_id).Key("routes").Value(std::move(routes_list)).EndDict().Build();
+}
+
+json::Node JourneyToNode(const std::optional<router::TimetableRouter::Journey> &journey, const int req_id,
+                               const RequestHandler &req_handler) {
+    if (!journey) {
+        return json::Builder{}.StartDict().Key("error_message").Value("not found").Key("request_id").Value(req_id).EndDict().Build();
+    }
+    json::Array route_list;
+    route_list.reserve(2 * journey->legs.size());
+    // ожидание перед каждой поездкой - от прибытия на остановку (или времени отправления) до отправления рейса
+    double time = journey->departure_time;
+    for (const auto &leg : journey->legs) {
+        route_list.emplace_back(json::Node(json::Builder{}.StartDict().Key("stop_name").Value(std::string(req_handler.GetStopName(leg.from))).Key("time").Value(leg.departure_time - time).Key("type").Value("Wait").EndDict().Build()));
+        route_list.emplace_back(json::Node(json::Builder{}.StartDict().Key("bus").Value(std::string(leg.bus)).Key("span_count").Value(static_cast<int>(leg.span)).Key("time").Value(leg.arrival_time - leg.departure_time).Key("type").Value("Bus").EndDict().Build()));
+        time = leg.arrival_time;
+    }
+    return json::Builder{}.StartDict().Key("arrival_time").Value(journey->arrival_time).Key("items").Value(route_list).Key("request_id").Value(req_id).Key("total_time").Value(journey->arrival_time - journey->departure_time).EndDict().Build();
+}
+
+json::Node MatrixToNode(const std::vector<std::vector<std::optional<double>>> &times, const int req_id) {
+    json::Array rows;
+    rows.reserve(times.size());
+    for (const auto &times_row : times) {
+        json::Array row;
+        row.reserve(times_row.size());
+        for (const auto &time : times_row) {
+            row.push_back(time ? json::Node(*time) : json::Node(nullptr));
+        }
+        rows.push_back(std::move(row));
+    }
+    return json::Builder{}.StartDict().Key("request_id").Value(req_id).Key("times").Value(std::move(rows)).EndDict().Build();
+}
+
+json::Node BusStatLoad(const domain::BusStat bus_stat, const int req_id) {
     json::Node result;
     if (!bus_stat) {
         result = json::Builder{}.StartDict().Key("error_message").Value("not found").Key("request_id").Value(req_id).EndDict().Build();
@@ -135,20 +335,47 @@ const json::Node BusStatLoad(const domain::BusStat bus_stat, const int req_id) {
     return result;
 }
 
-const json::Node StopStatLoad(const domain::StopStat stop_stat, const int req_id) {
+json::Node StopStatLoad(const domain::StopStat stop_stat, const int req_id) {
     json::Node result;
     json::Array tmp_array;
     if (!stop_stat) {
         result = json::Builder{}.StartDict().Key("error_message").Value("not found").Key("request_id").Value(req_id).EndDict().Build();
     } else {
+        tmp_array.reserve(stop_stat.bus_routes.size());
         for (const auto *bus : stop_stat.bus_routes) {
-            tmp_array.push_back(bus->bus_route);
+            tmp_array.push_back(std::string(bus->bus_route));
         }
-        result = json::Builder{}.StartDict().Key("request_id").Value(req_id).Key("buses").Value(tmp_array).EndDict().Build();
+        result = json::Builder{}.StartDict().Key("request_id").Value(req_id).Key("buses").Value(std::move(tmp_array)).EndDict().Build();
     }
     return result;
 }
 
+void FillPrecomputeSettings(const json::Dict &attrs, router::PrecomputeSettings &settings) {
+    if (attrs.count("routing_table_memory_limit_mb")) {
+        settings.memory_limit = static_cast<size_t>(attrs.at("routing_table_memory_limit_mb").AsDouble() * 1024. * 1024.);
+    }
+    if (attrs.count("routing_table_fallback")) {
+        settings.fallback = attrs.at("routing_table_fallback").AsBool();
+    }
+    if (attrs.count("hub_labels")) {
+        settings.hub_labels = attrs.at("hub_labels").AsBool();
+    }
+    if (attrs.count("route_search")) {
+        const auto &search = attrs.at("route_search").AsString();
+        if (search == "dijkstra") {
+            settings.search = router::RouteSearch::DIJKSTRA;
+        } else if (search == "astar") {
+            settings.search = router::RouteSearch::GEOMETRIC_A_STAR;
+        } else if (search == "alt") {
+            settings.search = router::RouteSearch::ALT;
+        } else if (search == "bidirectional") {
+            settings.search = router::RouteSearch::BIDIRECTIONAL;
+        } else {
+            throw std::invalid_argument("Unknown route search: " + search);
+        }
+    }
+}
+
 void FillRenderSets(const json::Node &render_node, RenderSets &render_sets) {
     json::Dict attrs = render_node.AsDict();
     render_sets.width = attrs.at("width").AsDouble();
@@ -195,23 +422,37 @@ void FillRenderSets(const json::Node &render_node, RenderSets &render_sets) {
 }
 
 void StopPointsSetter(const RequestHandler &req_handler, MapRenderer &renderer) {
-    std::unordered_map<std::string_view, domain::Bus *> buses = req_handler.GetAllBusRoutes();
-    std::vector<geo::Coordinates> coordinate_pool;
+    const auto &buses = req_handler.GetAllBusRoutes();
+    const auto &stop_lats = req_handler.GetStopLatitudes();
+    const auto &stop_lngs = req_handler.GetStopLongitudes();
+    // на карту попадают только остановки, через которые проходят маршруты
+    std::vector<bool> is_on_route(stop_lats.size(), false);
     for (const auto &bus : buses) {
         for (const auto &stop : (*bus.second).stops) {
-            coordinate_pool.emplace_back((*stop).coordinate);
+            is_on_route[stop->id] = true;
+        }
+    }
+    std::vector<double> lat_pool;
+    std::vector<double> lng_pool;
+    for (size_t stop_id = 0; stop_id < stop_lats.size(); ++stop_id) {
+        if (is_on_route[stop_id]) {
+            lat_pool.push_back(stop_lats[stop_id]);
+            lng_pool.push_back(stop_lngs[stop_id]);
         }
     }
-    std::vector<svg::Polyline> result;
     // создание объекта для перевода географических координат в точки на плоскости
-    SphereProjector point_mapper(coordinate_pool.begin(), coordinate_pool.end(), renderer.GetSets().width, renderer.GetSets().height, renderer.GetSets().padding);
+    SphereProjector point_mapper(lat_pool.begin(), lat_pool.end(), lng_pool.begin(), lng_pool.end(),
+                                 renderer.GetSets().width, renderer.GetSets().height, renderer.GetSets().padding);
+    // проекция всех остановок одним проходом по массивам координат, индекс - id остановки
+    std::vector<svg::Point> stop_points;
+    point_mapper.Project(stop_lats, stop_lngs, stop_points);
     std::map sorted_routes(buses.begin(), buses.end());
     StopItem uniq_stops;
     for (const auto &bus : sorted_routes) {
         std::vector<std::pair<std::string_view, svg::Point>> tmp_points;
         for (const auto &stop : (*bus.second).stops) {
-            tmp_points.push_back({(*stop).name, point_mapper((*stop).coordinate)});
-            uniq_stops[tmp_points.back().first] = std::move(tmp_points.back().second);
+            tmp_points.push_back({(*stop).name, stop_points[stop->id]});
+            uniq_stops[tmp_points.back().first] = tmp_points.back().second;
         }
         renderer.SetStopPoint({bus.first, tmp_points, bus.second->is_roundtrip});
         renderer.SetUniqStop(uniq_stops);
@@ -4,27 +4,42 @@
 
 #include "json.h"
 #include "map_renderer.h"
+#include "profiler.h"
 #include "request_handler.h"
 #include "transport_catalogue.h"
 
 // форматирование статистики маршрутов в json
-const json::Node BusStatLoad(const domain::BusStat bus_stat, const int req_id);
+json::Node BusStatLoad(const domain::BusStat bus_stat, const int req_id);
 // форматирование статистики остановок в json
-const json::Node StopStatLoad(const domain::StopStat stop_stat, const int req_id);
+json::Node StopStatLoad(const domain::StopStat stop_stat, const int req_id);
 // перевод координат остановок в Point
 void StopPointsSetter(const RequestHandler &req_handler, MapRenderer &renderer);
+// расписание маршрута {"first_departure": ..., "last_departure": ..., "headway": ...}, минуты
+domain::BusSchedule ParseBusSchedule(const json::Node &schedule_node);
 // заполнение остановок и маршрутов в каталог
 void FillBusesAndStops(TransportCatalogue &db, const std::vector<json::Node> &array_copy);
 // заполнение расстояний в каталоге
 void FillRoadDistances(TransportCatalogue &db, const std::vector<json::Node> &array_copy);
 // загрузка данных в справочник
 void LoadCatalogue(TransportCatalogue &db, const std::vector<json::Node> &base_req);
-// получение документа по запросам
-json::Document GetReqsResults(const RequestHandler &req_handler, const std::vector<json::Node> &base_req, MapRenderer &renderer);
+// изменение загруженного справочника запросами в формате base_requests: новые остановки добавляются,
+// расстояния перезаписываются, маршрут заменяется целиком, {"type": "Bus", "name": ..., "remove": true} удаляет маршрут
+void UpdateCatalogue(TransportCatalogue &db, const std::vector<json::Node> &update_req);
+// ответ на один запрос из stat_requests
+json::Node GetReqResult(const RequestHandler &req_handler, const json::Node &req, MapRenderer &renderer);
+// Получение документа по запросам. С profiler задержка каждого запроса добавляется в его гистограмму по типу;
+// обычные запросы Route считаются одним пакетом, и каждому из них засчитывается равная доля времени пакета
+json::Document GetReqsResults(const RequestHandler &req_handler, const std::vector<json::Node> &base_req, MapRenderer &renderer,
+                              profile::Profiler *profiler = nullptr);
 
 // заполнение атрибутами отрисовки
 void FillRenderSets(const json::Node &render_node, RenderSets &render_sets);
 
+// ограничения предрасчёта таблицы маршрутов из routing_settings:
+// "routing_table_memory_limit_mb" (0 или нет ключа - без ограничения), "routing_table_fallback" (по умолчанию true)
+// и "hub_labels" (по умолчанию false)
+void FillPrecomputeSettings(const json::Dict &attrs, router::PrecomputeSettings &settings);
+
 // создание объектов ломаных
 std::vector<svg::Polyline> MakePolylineMap(const MapRenderer &renderer);
 // отрисовка названий маршрутов
@@ -43,4 +58,18 @@ std::vector<svg::Circle> SetDots(const MapRenderer &renderer);
 // функция для вывода в поток объектов svg
 void MakeSvg(std::ostream &out, const RequestHandler &req_handler, MapRenderer &renderer);
 
-const json::Node RouteToNode(const std::optional<graph::Router<double>::RouteInfo>& route_data, const int req_id);
\ No newline at end of file
+// элементы маршрута Wait и Bus в порядке поездки
+json::Array RouteItemsToNode(const graph::Router<double>::RouteEdges &edges);
+// ответ на запрос Route с "pareto": true - маршруты по возрастанию числа пересадок, каждый следующий быстрее
+json::Node ParetoRoutesToNode(const std::vector<graph::Router<double>::RouteInfo> &routes, const int req_id);
+// ответ на запрос Route с "time_only": только время маршрута, без рёбер
+json::Node RouteTimeToNode(const std::optional<double> &total_time, const int req_id);
+// ответ на запрос Route: total_time - время маршрута (std::nullopt если маршрута нет), edges - его рёбра в порядке поездки
+json::Node RouteToNode(const std::optional<double> &total_time, const graph::Router<double>::RouteEdges &edges, const int req_id);
+
+// ответ на запрос Route с departure_time: ожидания и поездки по расписанию, arrival_time - время прибытия
+json::Node JourneyToNode(const std::optional<router::TimetableRouter::Journey> &journey, const int req_id,
+                               const RequestHandler &req_handler);
+
+// матрица времени в пути: строки - исходные остановки, null для неизвестной остановки или недостижимой пары
+json::Node MatrixToNode(const std::vector<std::vector<std::optional<double>>> &times, const int req_id);
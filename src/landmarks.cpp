@@ -0,0 +1,148 @@
+#include "landmarks.h"
+
+#include <algorithm>
+#include <functional>
+#include <limits>
+#include <queue>
+#include <stdexcept>
+#include <utility>
+
+namespace graph {
+
+namespace {
+const double INF = std::numeric_limits<double>::infinity();
+
+// Дейкстра из root по исходящим рёбрам (или по входящим при reverse); distances - результат
+void ComputeDistances(const DirectedWeightedGraph<double> &graph, VertexId root, bool reverse, std::vector<double> &distances) {
+    std::fill(distances.begin(), distances.end(), INF);
+    using QueueItem = std::pair<double, VertexId>;
+    std::priority_queue<QueueItem, std::vector<QueueItem>, std::greater<QueueItem>> queue;
+    distances[root] = 0.;
+    queue.push({0., root});
+    while (!queue.empty()) {
+        const auto [distance, vertex] = queue.top();
+        queue.pop();
+        if (distances[vertex] < distance) {
+            continue;
+        }
+        const auto relax = [&](VertexId next, double weight) {
+            if (distance + weight < distances[next]) {
+                distances[next] = distance + weight;
+                queue.push({distances[next], next});
+            }
+        };
+        if (reverse) {
+            for (const EdgeId edge_id : graph.GetIncomingEdges(vertex)) {
+                const auto &edge = graph.GetEdge(edge_id);
+                relax(edge.from, edge.weight);
+            }
+        } else {
+            for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+                const auto &edge = graph.GetEdge(edge_id);
+                relax(edge.to, edge.weight);
+            }
+        }
+    }
+}
+} // namespace
+
+Landmarks::Landmarks(const DirectedWeightedGraph<double> &graph, size_t landmarks_count) {
+    const size_t vertex_count = graph.GetVertexCount();
+    landmarks_count = std::min(landmarks_count, vertex_count);
+    // обход начинается с вершины с наибольшим числом исходящих рёбер, чтобы не попасть в изолированную остановку
+    VertexId start = 0;
+    size_t max_degree = 0;
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        size_t degree = 0;
+        for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
+            const auto &edge = graph.GetEdge(edge_id);
+            if (edge.weight < 0.) {
+                throw std::domain_error("Edges' weights should be non-negative");
+            }
+            ++degree;
+        }
+        if (degree > max_degree) {
+            max_degree = degree;
+            start = vertex;
+        }
+    }
+    if (landmarks_count == 0) {
+        return;
+    }
+
+    // первый ориентир - самая далёкая достижимая вершина от начальной
+    std::vector<double> forward(vertex_count);
+    ComputeDistances(graph, start, false, forward);
+    VertexId next = start;
+    for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+        if (forward[vertex] != INF && forward[vertex] > forward[next]) {
+            next = vertex;
+        }
+    }
+    // Удалённость вершины от выбранных ориентиров - минимум суммы расстояний туда и обратно. Следующий ориентир -
+    // самая удалённая вершина, связанная с ориентирами в обе стороны; ориентиров меньше, если таких не осталось
+    std::vector<double> remoteness(vertex_count, INF);
+    std::vector<std::vector<double>> landmark_forward;
+    std::vector<std::vector<double>> landmark_backward;
+    while (landmarks_.size() < landmarks_count) {
+        landmarks_.push_back(next);
+        auto &distances_from = landmark_forward.emplace_back(vertex_count);
+        auto &distances_to = landmark_backward.emplace_back(vertex_count);
+        ComputeDistances(graph, next, false, distances_from);
+        ComputeDistances(graph, next, true, distances_to);
+        double max_remoteness = 0.;
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            remoteness[vertex] = std::min(remoteness[vertex], distances_from[vertex] + distances_to[vertex]);
+            if (remoteness[vertex] != INF && remoteness[vertex] > max_remoteness) {
+                max_remoteness = remoteness[vertex];
+                next = vertex;
+            }
+        }
+        if (max_remoteness == 0.) {
+            break;
+        }
+    }
+
+    const size_t count = landmarks_.size();
+    from_landmarks_.resize(vertex_count * count);
+    to_landmarks_.resize(vertex_count * count);
+    for (size_t index = 0; index < count; ++index) {
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            from_landmarks_[vertex * count + index] = landmark_forward[index][vertex];
+            to_landmarks_[vertex * count + index] = landmark_backward[index][vertex];
+        }
+    }
+}
+
+double Landmarks::GetLowerBound(VertexId from, VertexId to) const {
+    const size_t count = landmarks_.size();
+    const double *from_row = from_landmarks_.data() + from * count;
+    const double *to_row = from_landmarks_.data() + to * count;
+    const double *from_back_row = to_landmarks_.data() + from * count;
+    const double *to_back_row = to_landmarks_.data() + to * count;
+    double bound = 0.;
+    for (size_t i = 0; i < count; ++i) {
+        // from достижима из ориентира, а to нет, или из to ориентир достижим, а из from нет: пути from -> to нет.
+        // В остальных случаях разности с бесконечностью оценки не дают
+        if ((from_row[i] != INF && to_row[i] == INF) || (from_back_row[i] == INF && to_back_row[i] != INF)) {
+            return INF;
+        }
+        if (from_row[i] != INF) {
+            bound = std::max(bound, to_row[i] - from_row[i]);
+        }
+        if (to_back_row[i] != INF) {
+            bound = std::max(bound, from_back_row[i] - to_back_row[i]);
+        }
+    }
+    return bound;
+}
+
+const std::vector<VertexId> &Landmarks::GetLandmarks() const {
+    return landmarks_;
+}
+
+size_t Landmarks::GetMemoryBytes() const {
+    return (from_landmarks_.size() + to_landmarks_.size()) * sizeof(double) + landmarks_.size() * sizeof(VertexId);
+}
+
+} // namespace graph
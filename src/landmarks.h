@@ -0,0 +1,38 @@
+#pragma once
+
+#include "graph.h"
+
+#include <cstddef>
+#include <vector>
+
+namespace graph {
+
+// Нижние оценки расстояний по ориентирам для поиска A* (ALT: A*, landmarks, triangle inequality).
+// Для каждого ориентира L хранятся расстояния d(L, v) и d(v, L) до всех вершин; по неравенству треугольника
+// d(v, t) >= d(L, t) - d(L, v) и d(v, t) >= d(v, L) - d(t, L), оценка - максимум по ориентирам.
+// Такая оценка согласована, поэтому A* с ней находит кратчайший путь. Ориентиры выбираются по очереди
+// как самые удалённые от уже выбранных, чтобы они лежали по краям графа и давали точные оценки;
+// их меньше landmarks_count, если не осталось вершин, связанных с ориентирами в обе стороны
+class Landmarks {
+public:
+    static const size_t DEFAULT_COUNT = 8;
+
+    explicit Landmarks(const DirectedWeightedGraph<double> &graph, size_t landmarks_count = DEFAULT_COUNT);
+
+    // нижняя оценка расстояния from -> to: 0 если ориентиры её не дают, бесконечность если пути заведомо нет
+    double GetLowerBound(VertexId from, VertexId to) const;
+
+    const std::vector<VertexId> &GetLandmarks() const;
+
+    // память расстояний, байт
+    size_t GetMemoryBytes() const;
+
+private:
+    std::vector<VertexId> landmarks_;
+    // d(L_i, v) в from_landmarks_[v * число ориентиров + i], бесконечность - недостижимо
+    std::vector<double> from_landmarks_;
+    // d(v, L_i) в той же раскладке
+    std::vector<double> to_landmarks_;
+};
+
+} // namespace graph
@@ -1,40 +1,259 @@
 #include "json_builder.h"
 #include <iostream>
 
+#include <chrono>
+#include <cstdlib>
 #include <fstream>
 #include <iostream>
 #include <sstream>
+#include <stdexcept>
 #include <string>
+#include <string_view>
 
 #include "json_reader.h"
 #include "map_renderer.h"
+#include "profiler.h"
 #include "request_handler.h"
+#include "request_server.h"
+#include "serialization.h"
 
 using namespace std;
 
-int main() {
+namespace {
+
+// число ответов Route в кеше сервера по умолчанию
+const size_t DEFAULT_ROUTE_CACHE_CAPACITY = 4096;
+
+// Ограничения предрасчёта таблицы маршрутов из routing_settings. Ход долгого расчёта выводится в stderr
+// раз в пять секунд, чтобы долгий запуск можно было отличить от зависшего
+router::PrecomputeSettings MakePrecomputeSettings(const json::Dict &routing_node) {
+    router::PrecomputeSettings settings;
+    FillPrecomputeSettings(routing_node, settings);
+    const auto start = std::chrono::steady_clock::now();
+    auto last_report = start;
+    settings.progress = [start, last_report](size_t done, size_t total) mutable {
+        const auto now = std::chrono::steady_clock::now();
+        if (now - last_report < std::chrono::seconds(5)) {
+            return;
+        }
+        last_report = now;
+        const std::chrono::duration<double> elapsed = now - start;
+        const double part = static_cast<double>(done) / static_cast<double>(total);
+        std::cerr << "routing table: "sv << static_cast<int>(part * 100.) << "%, "sv << static_cast<int>(elapsed.count()) << " s elapsed, ~"sv
+                  << static_cast<int>(elapsed.count() / part - elapsed.count()) << " s left"sv << std::endl;
+    };
+    return settings;
+}
+
+// Ответы на stat_requests по готовой базе. Профилирование замеряет каждый запрос и не меняет способ ответа:
+// обычные запросы Route и с ним считаются одним пакетом
+void PrintReqsResults(const TransportCatalogue &catalogue, router::TransportRouter &router, const RenderSets &render_sets,
+                      const json::Array &base_req, profile::Profiler &profiler) {
     std::ostringstream out;
-    TransportCatalogue catalogue;
+    RequestHandler req_handler(catalogue, router);
+    MapRenderer renderer(render_sets);
+
+    json::Document doc{nullptr};
+    {
+        const auto phase = profiler.StartPhase("requests"s);
+        doc = GetReqsResults(req_handler, base_req, renderer, profiler.IsEnabled() ? &profiler : nullptr);
+    }
+    const auto phase = profiler.StartPhase("print"s);
+    json::Print(doc, out);
 
-    const auto json = json::Load(std::cin);
+    std::cout << out.str();
+}
+
+// путь к файлу снимка из serialization_settings
+std::string GetSnapshotPath(const json::Document &json) {
+    return json.GetRoot().AsDict().at("serialization_settings"s).AsDict().at("file"s).AsString();
+}
+
+// "verify_routing_table": true в serialization_settings - проверка ячеек таблицы маршрутов при загрузке снимка
+bool GetSnapshotVerifyTable(const json::Document &json) {
+    const auto &settings = json.GetRoot().AsDict().at("serialization_settings"s).AsDict();
+    return settings.count("verify_routing_table"s) && settings.at("verify_routing_table"s).AsBool();
+}
+
+// однократная обработка: база строится и используется в одном процессе
+void ProcessAll(const json::Document &json, profile::Profiler &profiler) {
+    TransportCatalogue catalogue;
     auto base_data = json.GetRoot().AsDict().at("base_requests"s).AsArray();      // вектор для заполнения базы
     auto base_req = json.GetRoot().AsDict().at("stat_requests"s).AsArray();       // вектор с запросами, в ответ на него возвращается статистика
     auto render_node = json.GetRoot().AsDict().at("render_settings"s).AsDict();   // свойства для отрисовки
     auto routing_node = json.GetRoot().AsDict().at("routing_settings"s).AsDict(); // свойство ожидания и скорости движения
-                                                   
-    LoadCatalogue(catalogue, base_data);
-    // передаем в класс построения маршрута константную ссылку на каталог и мапу сеттингов
 
-    router::TransportRouter router(catalogue, routing_node.at("bus_wait_time").AsInt(), routing_node.at("bus_velocity").AsDouble());
+    {
+        const auto phase = profiler.StartPhase("catalogue"s);
+        LoadCatalogue(catalogue, base_data);
+    }
+    // передаем в класс построения маршрута константную ссылку на каталог и мапу сеттингов
+    auto router_phase = profiler.StartPhase("router"s);
+    router::TransportRouter router(catalogue, routing_node.at("bus_wait_time").AsInt(), routing_node.at("bus_velocity").AsDouble(),
+                                   MakePrecomputeSettings(routing_node));
+    router_phase.Stop();
 
-    RequestHandler req_handler(catalogue, router);
     RenderSets render_sets;
     FillRenderSets(render_node, render_sets);
 
-    MapRenderer renderer(render_sets);
+    PrintReqsResults(catalogue, router, render_sets, base_req, profiler);
+}
 
-    json::Document doc = GetReqsResults(req_handler, base_req, renderer);
-    json::Print(doc, out);
+// make_base: построение базы и сохранение её снимка
+void MakeBase(const json::Document &json, profile::Profiler &profiler) {
+    TransportCatalogue catalogue;
+    {
+        const auto phase = profiler.StartPhase("catalogue"s);
+        LoadCatalogue(catalogue, json.GetRoot().AsDict().at("base_requests"s).AsArray());
+    }
+    const auto &routing_node = json.GetRoot().AsDict().at("routing_settings"s).AsDict();
+    auto router_phase = profiler.StartPhase("router"s);
+    router::TransportRouter router(catalogue, routing_node.at("bus_wait_time").AsInt(), routing_node.at("bus_velocity").AsDouble(),
+                                   MakePrecomputeSettings(routing_node));
+    router_phase.Stop();
+    RenderSets render_sets;
+    FillRenderSets(json.GetRoot().AsDict().at("render_settings"s), render_sets);
 
-    std::cout << out.str();
+    const auto phase = profiler.StartPhase("save snapshot"s);
+    serialization::SaveSnapshot(GetSnapshotPath(json), catalogue, router, render_sets);
+}
+
+// process_requests: база загружается из снимка, без разбора base_requests и расчёта маршрутов
+void ProcessRequests(const json::Document &json, profile::Profiler &profiler) {
+    auto load_phase = profiler.StartPhase("load snapshot"s);
+    const auto base = serialization::LoadSnapshot(GetSnapshotPath(json), GetSnapshotVerifyTable(json));
+    load_phase.Stop();
+    PrintReqsResults(base->catalogue, *base->router, base->render_sets, json.GetRoot().AsDict().at("stat_requests"s).AsArray(), profiler);
+}
+
+// serve: база строится один раз по первой строке входа (base_requests или serialization_settings),
+// затем каждая следующая строка - документ stat_requests или update_requests, ответ - одна строка JSON.
+// Перцентили задержек по типам запросов выводятся в stderr по окончании входа
+void Serve(profile::Profiler &profiler) {
+    auto parse_phase = profiler.StartPhase("parse"s);
+    std::string base_frame;
+    std::getline(std::cin, base_frame);
+    std::istringstream base_input(base_frame);
+    const auto json = json::Load(base_input);
+    const auto &root = json.GetRoot().AsDict();
+    parse_phase.Stop();
+
+    std::unique_ptr<serialization::TransportBase> base;
+    if (root.count("base_requests"s)) {
+        base = std::make_unique<serialization::TransportBase>();
+        {
+            const auto phase = profiler.StartPhase("catalogue"s);
+            LoadCatalogue(base->catalogue, root.at("base_requests"s).AsArray());
+        }
+        const auto &routing_node = root.at("routing_settings"s).AsDict();
+        const auto phase = profiler.StartPhase("router"s);
+        base->router = std::make_unique<router::TransportRouter>(base->catalogue, routing_node.at("bus_wait_time").AsInt(),
+                                                                 routing_node.at("bus_velocity").AsDouble(),
+                                                                 MakePrecomputeSettings(routing_node));
+        FillRenderSets(root.at("render_settings"s), base->render_sets);
+    } else {
+        const auto phase = profiler.StartPhase("load snapshot"s);
+        base = serialization::LoadSnapshot(GetSnapshotPath(json), GetSnapshotVerifyTable(json));
+    }
+
+    // кеш ответов Route: "serve_settings": {"route_cache_capacity": N} в первой строке, 0 отключает кеш
+    size_t route_cache_capacity = DEFAULT_ROUTE_CACHE_CAPACITY;
+    if (root.count("serve_settings"s) && root.at("serve_settings"s).AsDict().count("route_cache_capacity"s)) {
+        const int capacity = root.at("serve_settings"s).AsDict().at("route_cache_capacity"s).AsInt();
+        if (capacity < 0) {
+            throw std::invalid_argument("route_cache_capacity should be non-negative: "s + std::to_string(capacity));
+        }
+        route_cache_capacity = static_cast<size_t>(capacity);
+    }
+    std::unique_ptr<server::RouteCache> route_cache;
+    if (route_cache_capacity > 0) {
+        route_cache = std::make_unique<server::RouteCache>(route_cache_capacity);
+    }
+
+    server::VersionedBase versions(std::move(base));
+    server::RequestServer request_server(versions);
+    request_server.SetRouteCache(route_cache.get());
+    request_server.SetProfiler(&profiler);
+    {
+        const auto phase = profiler.StartPhase("serve"s);
+        request_server.Serve(std::cin, std::cout);
+    }
+    request_server.PrintLatencyReport(std::cerr);
+    if (route_cache) {
+        const auto stats = route_cache->GetStats();
+        std::cerr << "route cache: "sv << stats.hits << " hits, "sv << stats.misses << " misses, "sv << stats.size << " entries"sv << std::endl;
+    }
+}
+
+// Профилирование: --profile выводит отчёт по этапам и запросам в stderr, --profile=FILE записывает его в FILE
+// в формате JSON. Без флага то же включает переменная окружения TRANSPORT_CATALOGUE_PROFILE: 1 - stderr, иначе путь к файлу
+struct ProfileSettings {
+    bool enabled = false;
+    std::string path;
+};
+
+ProfileSettings GetEnvProfileSettings() {
+    const char *value = std::getenv("TRANSPORT_CATALOGUE_PROFILE");
+    if (!value || value == "0"sv || value == ""sv) {
+        return {};
+    }
+    return {true, value == "1"sv ? ""s : std::string(value)};
+}
+
+void PrintProfile(const profile::Profiler &profiler, const ProfileSettings &settings) {
+    if (settings.path.empty()) {
+        profiler.PrintReport(std::cerr);
+        return;
+    }
+    std::ofstream output(settings.path);
+    if (!output) {
+        std::cerr << "Cannot write profile to "sv << settings.path << std::endl;
+        return;
+    }
+    profiler.PrintJson(output);
+}
+
+} // namespace
+
+int main(int argc, char *argv[]) {
+    std::string_view mode;
+    ProfileSettings profile_settings = GetEnvProfileSettings();
+    for (int i = 1; i < argc; ++i) {
+        const std::string_view arg = argv[i];
+        if (arg == "--profile"sv) {
+            profile_settings = {true, ""s};
+        } else if (arg.substr(0, "--profile="sv.size()) == "--profile="sv) {
+            profile_settings = {true, std::string(arg.substr("--profile="sv.size()))};
+        } else if (mode.empty()) {
+            mode = arg;
+        } else {
+            mode = "?"sv;
+        }
+    }
+    if (!mode.empty() && mode != "make_base"sv && mode != "process_requests"sv && mode != "serve"sv) {
+        std::cerr << "Usage: transport_catalogue [make_base|process_requests|serve] [--profile[=FILE]]"sv << std::endl;
+        return 1;
+    }
+    profile::Profiler profiler;
+    if (profile_settings.enabled) {
+        profiler.Enable();
+    }
+
+    if (mode == "serve"sv) {
+        Serve(profiler);
+    } else {
+        auto parse_phase = profiler.StartPhase("parse"s);
+        const auto json = json::Load(std::cin);
+        parse_phase.Stop();
+        if (mode == "make_base"sv) {
+            MakeBase(json, profiler);
+        } else if (mode == "process_requests"sv) {
+            ProcessRequests(json, profiler);
+        } else {
+            ProcessAll(json, profiler);
+        }
+    }
+    if (profile_settings.enabled) {
+        PrintProfile(profiler, profile_settings);
+    }
 }
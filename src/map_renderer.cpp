@@ -32,9 +32,8 @@ void MapRenderer::MakeRenderBusName(std::vector<svg::Text> &result, const StopTo
         point.push_back(stop_point.point.at(point_num / 2).second);
     }
     for (const auto &pnt : point) {
-        std::string str(stop_point.bus);
         text1.SetPosition(pnt)
-            .SetData(str)
+            .SetData(stop_point.bus)
             .SetFillColor(render_sets_.underlayer_color)
             .SetStrokeColor(render_sets_.underlayer_color)
             .SetStrokeWidth(render_sets_.underlayer_width)
@@ -46,7 +45,7 @@ void MapRenderer::MakeRenderBusName(std::vector<svg::Text> &result, const StopTo
             .SetFontFamily("Verdana");
         result.push_back(text1);
         text2.SetPosition(pnt)
-            .SetData(str)
+            .SetData(stop_point.bus)
             .SetFillColor(render_sets_.color_palette.at(pallet_num % pallet_size))
             .SetOffset(render_sets_.bus_label_offset)
             .SetFontSize(static_cast<uint32_t>(render_sets_.bus_label_font_size))
@@ -59,7 +58,6 @@ void MapRenderer::MakeRenderBusName(std::vector<svg::Text> &result, const StopTo
 void MapRenderer::MakeRenderStopName(std::vector<svg::Text> &result) const {
     svg::Text text1, text2;
     for (const auto &item : unique_stops_) {
-        std::string str(item.first);
         text1.SetPosition((item.second))
             .SetOffset(render_sets_.stop_label_offset)
             .SetFontSize(static_cast<uint32_t>(render_sets_.stop_label_font_size))
@@ -69,14 +67,14 @@ void MapRenderer::MakeRenderStopName(std::vector<svg::Text> &result) const {
             .SetStrokeWidth(render_sets_.underlayer_width)
             .SetStrokeLineCap(svg::StrokeLineCap::ROUND)
             .SetStrokeLineJoin(svg::StrokeLineJoin::ROUND)
-            .SetData(str);
+            .SetData(item.first);
         result.push_back(text1);
         text2.SetPosition((item.second))
             .SetOffset(render_sets_.stop_label_offset)
             .SetFontSize(static_cast<uint32_t>(render_sets_.stop_label_font_size))
             .SetFontFamily("Verdana")
             .SetFillColor("black")
-            .SetData(str);
+            .SetData(item.first);
         result.push_back(text2);
     }
 }
@@ -116,3 +114,9 @@ void MapRenderer::DocRender(std::ostream &out) const {
 void MapRenderer::SetUniqStop(const StopItem stop_item) {
     unique_stops_ = std::move(stop_item);
 }
+
+void MapRenderer::Clear() {
+    stop_points_.clear();
+    unique_stops_.clear();
+    doc_.Clear();
+}
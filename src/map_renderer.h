@@ -6,6 +6,7 @@
 #include <algorithm>
 #include <cstdlib>
 #include <iostream>
+#include <map>
 #include <optional>
 #include <utility>
 #include <vector>
@@ -32,15 +33,50 @@ public:
         const auto [left_it, right_it] = std::minmax_element(
             points_begin, points_end,
             [](auto lhs, auto rhs) { return lhs.lng < rhs.lng; });
-        min_lon_ = left_it->lng;
-        const double max_lon = right_it->lng;
 
         // Находим точки с минимальной и максимальной широтой
         const auto [bottom_it, top_it] = std::minmax_element(
             points_begin, points_end,
             [](auto lhs, auto rhs) { return lhs.lat < rhs.lat; });
-        const double min_lat = bottom_it->lat;
-        max_lat_ = top_it->lat;
+
+        SetBounds(left_it->lng, right_it->lng, bottom_it->lat, top_it->lat, max_width, max_height, padding);
+    }
+
+    // Вариант для координат, хранящихся по столбцам: широты и долготы в отдельных непрерывных массивах
+    template <typename ValueInputIt>
+    SphereProjector(ValueInputIt lat_begin, ValueInputIt lat_end, ValueInputIt lng_begin, ValueInputIt lng_end,
+                    double max_width, double max_height, double padding)
+        : padding_(padding) //
+    {
+        if (lat_begin == lat_end || lng_begin == lng_end) {
+            return;
+        }
+        const auto [bottom_it, top_it] = std::minmax_element(lat_begin, lat_end);
+        const auto [left_it, right_it] = std::minmax_element(lng_begin, lng_end);
+        SetBounds(*left_it, *right_it, *bottom_it, *top_it, max_width, max_height, padding);
+    }
+
+    // Проецирует широту и долготу в координаты внутри SVG-изображения
+    svg::Point operator()(geo::Coordinates coords) const {
+        return {
+            (coords.lng - min_lon_) * zoom_coeff_ + padding_,
+            (max_lat_ - coords.lat) * zoom_coeff_ + padding_};
+    }
+
+    // Проецирует массивы широт и долгот одним проходом, points[i] - проекция i-й пары
+    void Project(const std::vector<double> &lats, const std::vector<double> &lngs, std::vector<svg::Point> &points) const {
+        points.resize(lats.size());
+        for (size_t i = 0; i < lats.size(); ++i) {
+            points[i] = {(lngs[i] - min_lon_) * zoom_coeff_ + padding_,
+                         (max_lat_ - lats[i]) * zoom_coeff_ + padding_};
+        }
+    }
+
+private:
+    void SetBounds(double min_lon, double max_lon, double min_lat, double max_lat,
+                   double max_width, double max_height, double padding) {
+        min_lon_ = min_lon;
+        max_lat_ = max_lat;
 
         // Вычисляем коэффициент масштабирования вдоль координаты x
         std::optional<double> width_zoom;
@@ -67,14 +103,6 @@ public:
         }
     }
 
-    // Проецирует широту и долготу в координаты внутри SVG-изображения
-    svg::Point operator()(geo::Coordinates coords) const {
-        return {
-            (coords.lng - min_lon_) * zoom_coeff_ + padding_,
-            (max_lat_ - coords.lat) * zoom_coeff_ + padding_};
-    }
-
-private:
     double padding_;
     double min_lon_ = 0.;
     double max_lat_ = 0.;
@@ -175,6 +203,9 @@ public:
     // получение уникальных остановок
     void SetUniqStop(const StopItem stop_item);
 
+    // сброс точек и svg-документа перед повторной отрисовкой карты
+    void Clear();
+
 private:
     RenderSets render_sets_;
     std::vector<StopToPoint> stop_points_;
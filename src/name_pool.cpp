@@ -0,0 +1,73 @@
+#include "name_pool.h"
+
+#include <cstring>
+
+namespace domain {
+
+NameId NamePool::Intern(std::string_view name) {
+    ++intern_calls_;
+    requested_bytes_ += name.size();
+    if (auto name_pos = index_.find(name); name_pos != index_.end()) {
+        return name_pos->second;
+    }
+    const auto id = static_cast<NameId>(names_.size());
+    names_.push_back(CopyToArena(name));
+    index_.emplace(names_.back(), id);
+    return id;
+}
+
+std::optional<NameId> NamePool::Find(std::string_view name) const {
+    if (auto name_pos = index_.find(name); name_pos != index_.end()) {
+        return name_pos->second;
+    }
+    return std::nullopt;
+}
+
+std::string_view NamePool::GetName(NameId id) const {
+    return names_[id];
+}
+
+size_t NamePool::GetNameCount() const {
+    return names_.size();
+}
+
+NamePool::MemoryUsage NamePool::GetMemoryUsage() const {
+    MemoryUsage usage;
+    usage.names_count = names_.size();
+    usage.intern_calls = intern_calls_;
+    usage.requested_bytes = requested_bytes_;
+    usage.arena_bytes = arena_bytes_;
+    usage.used_bytes = used_bytes_;
+    // элемент списка индекса: ключ, значение, хеш и указатель на следующий, плюс корзина
+    usage.index_bytes = index_.size() * (sizeof(std::string_view) + sizeof(NameId) + 2 * sizeof(void *))
+                        + index_.bucket_count() * sizeof(void *)
+                        + names_.capacity() * sizeof(std::string_view);
+    return usage;
+}
+
+std::string_view NamePool::CopyToArena(std::string_view name) {
+    if (name.empty()) {
+        return {};
+    }
+    char *data = nullptr;
+    if (name.size() > BLOCK_SIZE) {
+        // имя длиннее блока получает собственный блок, текущий блок продолжает заполняться
+        large_blocks_.push_back(std::make_unique<char[]>(name.size()));
+        arena_bytes_ += name.size();
+        data = large_blocks_.back().get();
+    } else {
+        if (block_capacity_ - block_used_ < name.size()) {
+            blocks_.push_back(std::make_unique<char[]>(BLOCK_SIZE));
+            arena_bytes_ += BLOCK_SIZE;
+            block_used_ = 0;
+            block_capacity_ = BLOCK_SIZE;
+        }
+        data = blocks_.back().get() + block_used_;
+        block_used_ += name.size();
+    }
+    std::memcpy(data, name.data(), name.size());
+    used_bytes_ += name.size();
+    return {data, name.size()};
+}
+
+} // namespace domain
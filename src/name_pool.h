@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <optional>
+#include <string_view>
+#include <unordered_map>
+#include <vector>
+
+namespace domain {
+
+using NameId = uint32_t;
+
+// Таблица интернированных имён остановок и маршрутов.
+// Каждое уникальное имя хранится один раз в арене, остальные подсистемы
+// держат string_view на неё или NameId. Арена состоит из крупных блоков,
+// имена внутри блоков не перемещаются, поэтому string_view остаются валидными
+// всё время жизни пула, даже при добавлении новых имён
+class NamePool {
+public:
+    // статистика использования памяти
+    struct MemoryUsage {
+        size_t names_count = 0;
+        size_t intern_calls = 0;     // сколько раз имена запрашивались на интернирование
+        size_t requested_bytes = 0;  // суммарная длина запрошенных имён, включая повторы
+        size_t arena_bytes = 0;      // выделено под арену
+        size_t used_bytes = 0;       // занято в арене
+        size_t index_bytes = 0;      // приблизительный размер индекса имён
+    };
+
+    NamePool() = default;
+    NamePool(const NamePool &) = delete;
+    NamePool &operator=(const NamePool &) = delete;
+    NamePool(NamePool &&) = default;
+    NamePool &operator=(NamePool &&) = default;
+
+    // возвращает id имени, добавляя его в пул при первом обращении
+    NameId Intern(std::string_view name);
+
+    std::optional<NameId> Find(std::string_view name) const;
+
+    std::string_view GetName(NameId id) const;
+
+    size_t GetNameCount() const;
+
+    MemoryUsage GetMemoryUsage() const;
+
+private:
+    static constexpr size_t BLOCK_SIZE = 64 * 1024;
+
+    std::vector<std::unique_ptr<char[]>> blocks_;
+    std::vector<std::unique_ptr<char[]>> large_blocks_;
+    size_t block_used_ = 0;
+    size_t block_capacity_ = 0;
+    size_t arena_bytes_ = 0;
+    size_t used_bytes_ = 0;
+    size_t intern_calls_ = 0;
+    size_t requested_bytes_ = 0;
+    std::vector<std::string_view> names_;
+    std::unordered_map<std::string_view, NameId> index_;
+
+    std::string_view CopyToArena(std::string_view name);
+};
+
+} // namespace domain
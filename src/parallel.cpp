@@ -0,0 +1,119 @@
+#include "parallel.h"
+
+#include <condition_variable>
+#include <cstdint>
+#include <exception>
+#include <mutex>
+#include <vector>
+
+namespace parallel {
+
+namespace {
+
+// Потоки создаются при первом вызове с большим числом потоков, чем есть, и ждут заданий до конца процесса.
+// Задание выполняют потоки с номерами меньше active_workers_
+class WorkerPool {
+public:
+    ~WorkerPool() {
+        {
+            std::lock_guard lock(mutex_);
+            stop_ = true;
+        }
+        wake_.notify_all();
+        for (auto &thread : threads_) {
+            thread.join();
+        }
+    }
+
+    // false - пул занят, задание не запускалось
+    bool TryRun(size_t workers_count, void (*task)(void *), void *context) {
+        if (busy_.exchange(true)) {
+            return false;
+        }
+        {
+            std::lock_guard lock(mutex_);
+            while (threads_.size() < workers_count) {
+                threads_.emplace_back(&WorkerPool::WorkerLoop, this, threads_.size());
+            }
+            task_ = task;
+            context_ = context;
+            active_workers_ = workers_count;
+            pending_ = workers_count;
+            ++generation_;
+        }
+        wake_.notify_all();
+
+        // задание ссылается на стек вызывающего, поэтому потоки пула дожидаются и при исключении
+        std::exception_ptr error;
+        try {
+            task(context);
+        } catch (...) {
+            error = std::current_exception();
+        }
+        {
+            std::unique_lock lock(mutex_);
+            done_.wait(lock, [this] { return pending_ == 0; });
+        }
+        busy_ = false;
+        if (error) {
+            std::rethrow_exception(error);
+        }
+        return true;
+    }
+
+private:
+    void WorkerLoop(size_t index) {
+        uint64_t done_generation = 0;
+        std::unique_lock lock(mutex_);
+        while (true) {
+            wake_.wait(lock, [&] { return stop_ || (generation_ != done_generation && index < active_workers_); });
+            if (stop_) {
+                return;
+            }
+            done_generation = generation_;
+            const auto task = task_;
+            void *context = context_;
+            lock.unlock();
+            task(context);
+            lock.lock();
+            if (--pending_ == 0) {
+                done_.notify_all();
+            }
+        }
+    }
+
+    std::atomic<bool> busy_{false};
+    std::mutex mutex_;
+    std::condition_variable wake_;
+    std::condition_variable done_;
+    std::vector<std::thread> threads_;
+    void (*task_)(void *) = nullptr;
+    void *context_ = nullptr;
+    size_t active_workers_ = 0;
+    size_t pending_ = 0;
+    uint64_t generation_ = 0;
+    bool stop_ = false;
+};
+
+WorkerPool &GetWorkerPool() {
+    static WorkerPool pool;
+    return pool;
+}
+
+} // namespace
+
+void RunOnWorkers(size_t workers_count, void (*task)(void *), void *context) {
+    if (GetWorkerPool().TryRun(workers_count, task, context)) {
+        return;
+    }
+    std::vector<std::thread> workers;
+    for (size_t i = 0; i < workers_count; ++i) {
+        workers.emplace_back(task, context);
+    }
+    task(context);
+    for (auto &worker : workers) {
+        worker.join();
+    }
+}
+
+} // namespace parallel
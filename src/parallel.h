@@ -0,0 +1,42 @@
+#pragma once
+
+#include <algorithm>
+#include <atomic>
+#include <cstddef>
+#include <thread>
+
+namespace parallel {
+
+// 0 означает «по числу ядер»
+inline size_t ResolveThreadsCount(size_t threads_count) {
+    return threads_count == 0 ? std::max(1u, std::thread::hardware_concurrency()) : threads_count;
+}
+
+// Выполняет task(context) в workers_count потоках общего пула и в вызывающем потоке и возвращается, когда
+// закончат все. Потоки пула живут до конца процесса, поэтому thread_local данные заданий (рабочие массивы
+// поисков) переживают вызов. Вложенный вызов или вызов, пока пул занят другим потоком, выполняется
+// во временных потоках
+void RunOnWorkers(size_t workers_count, void (*task)(void *), void *context);
+
+// Выполняет func(0) ... func(count - 1) в threads_count потоках (включая вызывающий),
+// задания раздаются по одному, поэтому задания разной длины распределяются равномерно
+template <typename Func>
+void ParallelFor(size_t count, size_t threads_count, Func func) {
+    threads_count = std::min(ResolveThreadsCount(threads_count), count);
+    if (threads_count <= 1) {
+        for (size_t i = 0; i < count; ++i) {
+            func(i);
+        }
+        return;
+    }
+    std::atomic<size_t> next{0};
+    auto work = [&] {
+        for (size_t i = next++; i < count; i = next++) {
+            func(i);
+        }
+    };
+    using Work = decltype(work);
+    RunOnWorkers(threads_count - 1, [](void *context) { (*static_cast<Work *>(context))(); }, &work);
+}
+
+} // namespace parallel
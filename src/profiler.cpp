@@ -0,0 +1,280 @@
+#include "profiler.h"
+
+#include <algorithm>
+#include <atomic>
+#include <cmath>
+#include <cstdlib>
+#include <iomanip>
+#include <limits>
+#include <new>
+
+#include "json.h"
+
+#if defined(__unix__) || defined(__APPLE__)
+#include <sys/resource.h>
+#endif
+
+namespace profile {
+
+namespace {
+std::atomic<int> allocation_counting{0};
+std::atomic<uint64_t> allocations_count{0};
+std::atomic<uint64_t> allocated_bytes{0};
+// без динамической инициализации, поэтому доступен из operator new в любой момент жизни потока
+thread_local AllocationCounters thread_allocations;
+
+void *Allocate(std::size_t size) {
+    if (allocation_counting.load(std::memory_order_relaxed) > 0) {
+        allocations_count.fetch_add(1, std::memory_order_relaxed);
+        allocated_bytes.fetch_add(size, std::memory_order_relaxed);
+        ++thread_allocations.count;
+        thread_allocations.bytes += size;
+    }
+    // malloc(0) может вернуть nullptr, а operator new обязан вернуть уникальный адрес
+    if (void *ptr = std::malloc(size ? size : 1)) {
+        return ptr;
+    }
+    throw std::bad_alloc();
+}
+
+// json::Node хранит целые в int, большие счётчики выводятся как double
+json::Node CountToNode(uint64_t count) {
+    if (count <= static_cast<uint64_t>(std::numeric_limits<int>::max())) {
+        return json::Node(static_cast<int>(count));
+    }
+    return json::Node(static_cast<double>(count));
+}
+} // namespace
+
+void EnableAllocationCounting(bool enabled) {
+    allocation_counting.fetch_add(enabled ? 1 : -1, std::memory_order_relaxed);
+}
+
+AllocationCounters GetAllocationCounters() {
+    return {allocations_count.load(std::memory_order_relaxed), allocated_bytes.load(std::memory_order_relaxed)};
+}
+
+AllocationCounters GetThreadAllocationCounters() {
+    return thread_allocations;
+}
+
+AllocationScope::AllocationScope() {
+    EnableAllocationCounting(true);
+    start_ = GetThreadAllocationCounters();
+}
+
+AllocationScope::~AllocationScope() {
+    EnableAllocationCounting(false);
+}
+
+AllocationCounters AllocationScope::GetCounters() const {
+    const auto counters = GetThreadAllocationCounters();
+    return {counters.count - start_.count, counters.bytes - start_.bytes};
+}
+
+size_t GetPeakRssKb() {
+#if defined(__unix__) || defined(__APPLE__)
+    rusage usage{};
+    if (getrusage(RUSAGE_SELF, &usage) != 0) {
+        return 0;
+    }
+#if defined(__APPLE__)
+    // на macOS ru_maxrss в байтах
+    return static_cast<size_t>(usage.ru_maxrss) / 1024;
+#else
+    return static_cast<size_t>(usage.ru_maxrss);
+#endif
+#else
+    return 0;
+#endif
+}
+
+void LatencyHistogram::Add(double microseconds) {
+    size_t bucket = 0;
+    if (microseconds >= 1.) {
+        bucket = std::min(BUCKETS_COUNT - 1, static_cast<size_t>(std::log2(microseconds)) + 1);
+    }
+    ++buckets_[bucket];
+    ++count_;
+    total_ += microseconds;
+    max_ = std::max(max_, microseconds);
+}
+
+size_t LatencyHistogram::GetCount() const {
+    return count_;
+}
+
+double LatencyHistogram::GetMax() const {
+    return max_;
+}
+
+double LatencyHistogram::GetMean() const {
+    return count_ ? total_ / static_cast<double>(count_) : 0.;
+}
+
+double LatencyHistogram::GetPercentile(double p) const {
+    if (!count_) {
+        return 0.;
+    }
+    // метод ближайшего ранга, как в server::LatencyStats
+    const double rank = std::max(1., std::ceil(p / 100. * static_cast<double>(count_)));
+    size_t seen = 0;
+    for (size_t bucket = 0; bucket < BUCKETS_COUNT; ++bucket) {
+        seen += buckets_[bucket];
+        if (static_cast<double>(seen) >= rank) {
+            // граница корзины не больше самой долгой задержки
+            return std::min(std::ldexp(1., static_cast<int>(bucket)), max_);
+        }
+    }
+    return max_;
+}
+
+const std::array<size_t, LatencyHistogram::BUCKETS_COUNT> &LatencyHistogram::GetBuckets() const {
+    return buckets_;
+}
+
+Profiler::Phase::Phase(Profiler *profiler, std::string name)
+    : profiler_(profiler), name_(std::move(name)) {
+    if (profiler_) {
+        wall_start_ = std::chrono::steady_clock::now();
+        cpu_start_ = std::clock();
+        allocations_start_ = GetAllocationCounters();
+    }
+}
+
+Profiler::Phase::Phase(Phase &&other) noexcept
+    : profiler_(other.profiler_),
+      name_(std::move(other.name_)),
+      wall_start_(other.wall_start_),
+      cpu_start_(other.cpu_start_),
+      allocations_start_(other.allocations_start_) {
+    other.profiler_ = nullptr;
+}
+
+Profiler::Phase::~Phase() {
+    Stop();
+}
+
+void Profiler::Phase::Stop() {
+    if (!profiler_) {
+        return;
+    }
+    const std::chrono::duration<double, std::milli> wall = std::chrono::steady_clock::now() - wall_start_;
+    const double cpu_ms = 1000. * static_cast<double>(std::clock() - cpu_start_) / CLOCKS_PER_SEC;
+    const auto allocations = GetAllocationCounters();
+    profiler_->phases_.push_back({std::move(name_), wall.count(), cpu_ms, GetPeakRssKb(),
+                                  {allocations.count - allocations_start_.count, allocations.bytes - allocations_start_.bytes}});
+    profiler_ = nullptr;
+}
+
+void Profiler::Enable() {
+    if (!enabled_) {
+        enabled_ = true;
+        EnableAllocationCounting(true);
+    }
+}
+
+bool Profiler::IsEnabled() const {
+    return enabled_;
+}
+
+Profiler::Phase Profiler::StartPhase(std::string name) {
+    return Phase(enabled_ ? this : nullptr, std::move(name));
+}
+
+void Profiler::AddRequest(const std::string &type, double microseconds) {
+    if (enabled_) {
+        requests_[type].Add(microseconds);
+    }
+}
+
+const std::vector<PhaseStats> &Profiler::GetPhases() const {
+    return phases_;
+}
+
+const std::map<std::string, LatencyHistogram> &Profiler::GetRequests() const {
+    return requests_;
+}
+
+void Profiler::PrintReport(std::ostream &out) const {
+    const auto precision = out.precision();
+    out << std::fixed << std::setprecision(1);
+    out << std::left << std::setw(20) << "phase" << std::right << std::setw(12) << "wall, ms" << std::setw(12) << "cpu, ms"
+        << std::setw(14) << "peak rss, KB" << std::setw(12) << "allocs" << std::setw(14) << "alloc, KB" << '\n';
+    for (const auto &phase : phases_) {
+        out << std::left << std::setw(20) << phase.name << std::right << std::setw(12) << phase.wall_ms << std::setw(12) << phase.cpu_ms
+            << std::setw(14) << phase.peak_rss_kb << std::setw(12) << phase.allocations.count
+            << std::setw(14) << static_cast<double>(phase.allocations.bytes) / 1024. << '\n';
+    }
+    if (!requests_.empty()) {
+        out << std::left << std::setw(8) << "type" << std::right << std::setw(10) << "count" << std::setw(12) << "mean, us"
+            << std::setw(12) << "p50, us" << std::setw(12) << "p90, us" << std::setw(12) << "p99, us" << std::setw(12) << "max, us" << '\n';
+    }
+    for (const auto &[type, histogram] : requests_) {
+        out << std::left << std::setw(8) << type << std::right << std::setw(10) << histogram.GetCount()
+            << std::setw(12) << histogram.GetMean() << std::setw(12) << histogram.GetPercentile(50.)
+            << std::setw(12) << histogram.GetPercentile(90.) << std::setw(12) << histogram.GetPercentile(99.)
+            << std::setw(12) << histogram.GetMax() << '\n';
+    }
+    out.unsetf(std::ios::fixed);
+    out.precision(precision);
+    out.flush();
+}
+
+void Profiler::PrintJson(std::ostream &out) const {
+    json::Array phases;
+    for (const auto &phase : phases_) {
+        phases.push_back(json::Dict{{"name", phase.name},
+                                    {"wall_ms", phase.wall_ms},
+                                    {"cpu_ms", phase.cpu_ms},
+                                    {"peak_rss_kb", CountToNode(phase.peak_rss_kb)},
+                                    {"allocations", CountToNode(phase.allocations.count)},
+                                    {"allocated_bytes", CountToNode(phase.allocations.bytes)}});
+    }
+    json::Dict requests;
+    for (const auto &[type, histogram] : requests_) {
+        // непустые корзины: верхняя граница в мкс и число запросов
+        json::Array buckets;
+        for (size_t bucket = 0; bucket < LatencyHistogram::BUCKETS_COUNT; ++bucket) {
+            if (histogram.GetBuckets()[bucket]) {
+                buckets.push_back(json::Array{std::ldexp(1., static_cast<int>(bucket)), CountToNode(histogram.GetBuckets()[bucket])});
+            }
+        }
+        requests[type] = json::Dict{{"count", CountToNode(histogram.GetCount())},
+                                    {"mean_us", histogram.GetMean()},
+                                    {"p50_us", histogram.GetPercentile(50.)},
+                                    {"p90_us", histogram.GetPercentile(90.)},
+                                    {"p99_us", histogram.GetPercentile(99.)},
+                                    {"max_us", histogram.GetMax()},
+                                    {"buckets", std::move(buckets)}};
+    }
+    json::Print(json::Document(json::Dict{{"phases", std::move(phases)}, {"requests", std::move(requests)}}), out);
+    out << std::endl;
+}
+
+} // namespace profile
+
+// Замена глобальных operator new/delete ради счёта выделений; освобождение - через free, как и выделение
+void *operator new(std::size_t size) {
+    return profile::Allocate(size);
+}
+
+void *operator new[](std::size_t size) {
+    return profile::Allocate(size);
+}
+
+void operator delete(void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr) noexcept {
+    std::free(ptr);
+}
+
+void operator delete(void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
+
+void operator delete[](void *ptr, std::size_t) noexcept {
+    std::free(ptr);
+}
@@ -0,0 +1,136 @@
+#pragma once
+
+#include <array>
+#include <chrono>
+#include <cstdint>
+#include <ctime>
+#include <iostream>
+#include <map>
+#include <string>
+#include <vector>
+
+namespace profile {
+
+// Выделения памяти через operator new во всех потоках процесса
+struct AllocationCounters {
+    uint64_t count = 0;
+    uint64_t bytes = 0;
+};
+
+// Счёт выделений выключен по умолчанию: выключенный счётчик стоит одной проверки флага на выделение.
+// Включения вложенные: счёт идёт, пока вызовов с true больше, чем с false
+void EnableAllocationCounting(bool enabled);
+
+// выделения всех потоков с начала счёта
+AllocationCounters GetAllocationCounters();
+
+// выделения текущего потока с начала счёта
+AllocationCounters GetThreadAllocationCounters();
+
+// Выделения памяти текущим потоком за время жизни объекта: счёт включается на это время.
+// Выделения других потоков не учитываются, поэтому замеры в параллельных потоках не мешают друг другу
+class AllocationScope {
+public:
+    AllocationScope();
+    ~AllocationScope();
+
+    AllocationScope(const AllocationScope &) = delete;
+    AllocationScope &operator=(const AllocationScope &) = delete;
+
+    // выделения с создания объекта
+    AllocationCounters GetCounters() const;
+
+private:
+    AllocationCounters start_;
+};
+
+// пиковый размер резидентной памяти процесса в КБ, 0 если платформа его не сообщает
+size_t GetPeakRssKb();
+
+// Показатели одного этапа обработки
+struct PhaseStats {
+    std::string name;
+    double wall_ms = 0.;
+    double cpu_ms = 0.;
+    // пик резидентной памяти процесса к концу этапа
+    size_t peak_rss_kb = 0;
+    AllocationCounters allocations;
+};
+
+// Гистограмма задержек с корзинами по степеням двойки: корзина k - задержки [2^(k-1), 2^k) мкс,
+// корзина 0 - меньше микросекунды. Память не растёт с числом запросов
+class LatencyHistogram {
+public:
+    static const size_t BUCKETS_COUNT = 32;
+
+    void Add(double microseconds);
+
+    size_t GetCount() const;
+
+    double GetMax() const;
+
+    double GetMean() const;
+
+    // верхняя граница корзины, в которую попадает перцентиль p из [0, 100], в микросекундах
+    double GetPercentile(double p) const;
+
+    const std::array<size_t, BUCKETS_COUNT> &GetBuckets() const;
+
+private:
+    std::array<size_t, BUCKETS_COUNT> buckets_{};
+    size_t count_ = 0;
+    double total_ = 0.;
+    double max_ = 0.;
+};
+
+// Замер этапов обработки входа (время, процессорное время, пик памяти, выделения)
+// и задержек запросов по типам. Выключенный профилировщик ничего не замеряет
+class Profiler {
+public:
+    // Этап длится от StartPhase до Stop или разрушения объекта
+    class Phase {
+    public:
+        Phase(Phase &&other) noexcept;
+        Phase &operator=(Phase &&) = delete;
+        ~Phase();
+
+        // завершает этап раньше конца области видимости, например когда в нём создаётся объект для следующих этапов
+        void Stop();
+
+    private:
+        friend class Profiler;
+        Phase(Profiler *profiler, std::string name);
+
+        Profiler *profiler_;
+        std::string name_;
+        std::chrono::steady_clock::time_point wall_start_;
+        std::clock_t cpu_start_ = 0;
+        AllocationCounters allocations_start_;
+    };
+
+    // включает замеры и счёт выделений памяти
+    void Enable();
+
+    bool IsEnabled() const;
+
+    Phase StartPhase(std::string name);
+
+    void AddRequest(const std::string &type, double microseconds);
+
+    const std::vector<PhaseStats> &GetPhases() const;
+
+    const std::map<std::string, LatencyHistogram> &GetRequests() const;
+
+    // таблицы этапов и задержек запросов
+    void PrintReport(std::ostream &out) const;
+
+    // тот же отчёт одним документом JSON: {"phases": [...], "requests": {тип: {...}}}
+    void PrintJson(std::ostream &out) const;
+
+private:
+    bool enabled_ = false;
+    std::vector<PhaseStats> phases_;
+    std::map<std::string, LatencyHistogram> requests_;
+};
+
+} // namespace profile
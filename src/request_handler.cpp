@@ -1,6 +1,6 @@
 #include "request_handler.h"
 
-RequestHandler::RequestHandler(const TransportCatalogue &db, router::TransportRouter &router) : db_(db), router_(router) {}
+RequestHandler::RequestHandler(const TransportCatalogue &db, const router::TransportRouter &router) : db_(db), router_(router) {}
 
 domain::BusStat RequestHandler::GetBusStat(const std::string_view &bus_name) const {
     return db_.ReportBusStatistic(bus_name);
@@ -14,7 +14,52 @@ const std::optional<graph::Router<double>::RouteInfo> RequestHandler::GetOptimal
     return router_.CreateRoute(stop_from, stop_to);
 }
 
-std::unordered_map<std::string_view, domain::Bus *> RequestHandler::GetAllBusRoutes() const {
+std::optional<double> RequestHandler::GetOptimalRoute(std::string_view stop_from, std::string_view stop_to,
+                                                      graph::Router<double>::RouteEdges &edges) const {
+    return router_.CreateRoute(stop_from, stop_to, edges);
+}
+
+std::vector<std::optional<graph::Router<double>::RouteInfo>> RequestHandler::GetOptimalRoutes(
+    const std::vector<std::pair<std::string_view, std::string_view>> &pairs) const {
+    return router_.CreateRoutes(pairs);
+}
+
+std::vector<graph::Router<double>::RouteInfo> RequestHandler::GetParetoRoutes(std::string_view stop_from, std::string_view stop_to,
+                                                                              size_t max_rides) const {
+    return router_.CreateParetoRoutes(stop_from, stop_to, max_rides);
+}
+
+std::optional<router::TimetableRouter::Journey> RequestHandler::GetJourney(std::string_view stop_from, std::string_view stop_to,
+                                                                            double departure_time) const {
+    return router_.CreateJourney(stop_from, stop_to, departure_time);
+}
+
+std::string_view RequestHandler::GetStopName(domain::StopId stop_id) const {
+    return db_.GetStop(stop_id).name;
+}
+
+std::optional<domain::StopId> RequestHandler::GetStopId(std::string_view stop_name) const {
+    const domain::Stop *stop = db_.FindStop(stop_name);
+    return stop ? std::optional<domain::StopId>(stop->id) : std::nullopt;
+}
+
+std::optional<double> RequestHandler::GetRouteTime(std::string_view stop_from, std::string_view stop_to) const {
+    return router_.GetRouteTime(stop_from, stop_to);
+}
+
+std::vector<std::vector<std::optional<double>>> RequestHandler::GetTravelTimes(const std::vector<std::string_view> &origins,
+                                                                               const std::vector<std::string_view> &destinations) const {
+    return router_.GetTravelTimes(origins, destinations);
+}
+
+const std::unordered_map<std::string_view, domain::Bus *> &RequestHandler::GetAllBusRoutes() const {
     return db_.GetAllRoutes();
 }
 
+const std::vector<double> &RequestHandler::GetStopLatitudes() const {
+    return db_.GetStopLatitudes();
+}
+
+const std::vector<double> &RequestHandler::GetStopLongitudes() const {
+    return db_.GetStopLongitudes();
+}
@@ -6,7 +6,7 @@
 class RequestHandler {
 public:
     // MapRenderer понадобится в следующей части итогового проекта
-    RequestHandler(const TransportCatalogue &db, router::TransportRouter &router);
+    RequestHandler(const TransportCatalogue &db, const router::TransportRouter &router);
 
     // Возвращает информацию о маршруте (запрос Bus)
     domain::BusStat GetBusStat(const std::string_view &bus_name) const;
@@ -15,11 +15,43 @@ public:
     domain::StopStat GetBusesByStop(const std::string_view &stop_name) const;
 
     // возвращает все маршруты со связанными данными
-    std::unordered_map<std::string_view, domain::Bus *> GetAllBusRoutes() const;
+    const std::unordered_map<std::string_view, domain::Bus *> &GetAllBusRoutes() const;
+
+    // координаты остановок по столбцам, индекс - id остановки
+    const std::vector<double> &GetStopLatitudes() const;
+    const std::vector<double> &GetStopLongitudes() const;
 
     // Возвращает оптимальный маршрут
     const std::optional<graph::Router<double>::RouteInfo> GetOptimalRoute(const std::string_view stop_from, const std::string_view stop_to) const;
 
+    // Записывает оптимальный маршрут в порядке поездки в буфер edges и возвращает его время
+    std::optional<double> GetOptimalRoute(std::string_view stop_from, std::string_view stop_to,
+                                          graph::Router<double>::RouteEdges &edges) const;
+
+    // Оптимальные маршруты для пакета пар остановок в порядке пар, поиск - один на исходную остановку
+    std::vector<std::optional<graph::Router<double>::RouteInfo>> GetOptimalRoutes(
+        const std::vector<std::pair<std::string_view, std::string_view>> &pairs) const;
+
+    // Возвращает маршруты, оптимальные по времени и числу поездок (не больше max_rides, 0 - без ограничения)
+    std::vector<graph::Router<double>::RouteInfo> GetParetoRoutes(std::string_view stop_from, std::string_view stop_to,
+                                                                  size_t max_rides) const;
+
+    // Возвращает поездку по расписаниям с отправлением не раньше departure_time
+    std::optional<router::TimetableRouter::Journey> GetJourney(std::string_view stop_from, std::string_view stop_to,
+                                                               double departure_time) const;
+
+    std::string_view GetStopName(domain::StopId stop_id) const;
+
+    // id остановки, std::nullopt если её нет в каталоге
+    std::optional<domain::StopId> GetStopId(std::string_view stop_name) const;
+
+    // Возвращает только время оптимального маршрута
+    std::optional<double> GetRouteTime(std::string_view stop_from, std::string_view stop_to) const;
+
+    // Возвращает матрицу времени в пути между остановками без построения маршрутов
+    std::vector<std::vector<std::optional<double>>> GetTravelTimes(const std::vector<std::string_view> &origins,
+                                                                   const std::vector<std::string_view> &destinations) const;
+
 private:
     // RequestHandler использует агрегацию объектов "Транспортный Справочник" и "Визуализатор Карты"
     const TransportCatalogue &db_;
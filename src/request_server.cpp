@@ -0,0 +1,166 @@
+#include "request_server.h"
+
+#include <algorithm>
+#include <cmath>
+#include <iomanip>
+#include <sstream>
+#include <stdexcept>
+
+#include "json_builder.h"
+#include "json_reader.h"
+
+namespace server {
+
+void LatencyStats::Add(double microseconds) {
+    samples_.push_back(microseconds);
+    sorted_ = false;
+}
+
+size_t LatencyStats::GetCount() const {
+    return samples_.size();
+}
+
+double LatencyStats::GetPercentile(double p) const {
+    if (samples_.empty()) {
+        return 0.;
+    }
+    if (!sorted_) {
+        std::sort(samples_.begin(), samples_.end());
+        sorted_ = true;
+    }
+    // метод ближайшего ранга
+    const double rank = std::ceil(p / 100. * static_cast<double>(samples_.size()));
+    const size_t index = rank < 1. ? 0 : static_cast<size_t>(rank) - 1;
+    return samples_[std::min(index, samples_.size() - 1)];
+}
+
+RequestServer::RequestServer(const RequestHandler &req_handler, const RenderSets &render_sets)
+    : req_handler_(&req_handler), renderer_(render_sets) {
+}
+
+RequestServer::RequestServer(VersionedBase &versions)
+    : versions_(&versions), reader_(versions.RegisterReader()), renderer_(reader_->Lock()->render_sets) {
+}
+
+json::Document RequestServer::HandleBatch(const json::Array &stat_requests) {
+    if (req_handler_) {
+        return HandleBatch(*req_handler_, stat_requests, 0);
+    }
+    const auto version = reader_->Lock();
+    return HandleBatch(RequestHandler(version->catalogue, *version->router), stat_requests, version.GetVersion());
+}
+
+void RequestServer::SetRouteCache(RouteCache *route_cache) {
+    route_cache_ = route_cache;
+}
+
+void RequestServer::SetProfiler(profile::Profiler *profiler) {
+    profiler_ = profiler;
+}
+
+uint64_t RequestServer::HandleUpdate(const json::Array &update_requests) {
+    if (!versions_) {
+        throw std::logic_error("Catalogue updates require a versioned base");
+    }
+    const auto start = std::chrono::steady_clock::now();
+    const uint64_t version = versions_->Update([&update_requests](TransportCatalogue &db) {
+        UpdateCatalogue(db, update_requests);
+    });
+    // записи прежних версий запросам новой версии не видны, очистка только освобождает место
+    if (route_cache_) {
+        route_cache_->Clear();
+    }
+    const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+    latencies_["Update"].Add(elapsed.count());
+    if (profiler_) {
+        profiler_->AddRequest("Update", elapsed.count());
+    }
+    return version;
+}
+
+json::Document RequestServer::HandleBatch(const RequestHandler &req_handler, const json::Array &stat_requests, uint64_t version) {
+    json::Array responses;
+    responses.reserve(stat_requests.size());
+    for (const auto &req : stat_requests) {
+        const auto start = std::chrono::steady_clock::now();
+        const auto &dict = req.AsDict();
+        if (route_cache_ && dict.at("type").AsString() == "Route" && !dict.count("pareto") && !dict.count("departure_time")
+            && !dict.count("time_only")) {
+            responses.push_back(HandleRoute(req_handler, req, version));
+        } else {
+            responses.push_back(GetReqResult(req_handler, req, renderer_));
+        }
+        const std::chrono::duration<double, std::micro> elapsed = std::chrono::steady_clock::now() - start;
+        latencies_[dict.at("type").AsString()].Add(elapsed.count());
+        if (profiler_) {
+            profiler_->AddRequest(dict.at("type").AsString(), elapsed.count());
+        }
+    }
+    return json::Document(std::move(responses));
+}
+
+json::Node RequestServer::HandleRoute(const RequestHandler &req_handler, const json::Node &req, uint64_t version) {
+    const auto &dict = req.AsDict();
+    const auto from = req_handler.GetStopId(dict.at("from").AsString());
+    const auto to = req_handler.GetStopId(dict.at("to").AsString());
+    // ответы для неизвестных остановок дёшевы и не кешируются
+    if (!from || !to) {
+        return GetReqResult(req_handler, req, renderer_);
+    }
+    if (auto cached = route_cache_->Get(*from, *to, version)) {
+        // ответ тот же, отличается только номер запроса: он меняется в полученной копии без повторного копирования
+        std::get<json::Dict>(cached->GetValue())["request_id"] = dict.at("id");
+        return std::move(*cached);
+    }
+    json::Node response = GetReqResult(req_handler, req, renderer_);
+    route_cache_->Put(*from, *to, version, response);
+    return response;
+}
+
+void RequestServer::Serve(std::istream &input, std::ostream &output) {
+    std::string frame;
+    while (std::getline(input, frame)) {
+        if (frame.find_first_not_of(" \t\r") == std::string::npos) {
+            continue;
+        }
+        json::Document response(json::Node{});
+        try {
+            std::istringstream frame_input(frame);
+            const auto request = json::Load(frame_input);
+            const auto &root = request.GetRoot().AsDict();
+            if (root.count("update_requests")) {
+                const auto version = HandleUpdate(root.at("update_requests").AsArray());
+                response = json::Document(json::Builder{}.StartDict().Key("version").Value(static_cast<int>(version)).EndDict().Build());
+            } else {
+                response = HandleBatch(root.at("stat_requests").AsArray());
+            }
+        } catch (const std::exception &error) {
+            // ошибка в одном кадре не останавливает сервер
+            response = json::Document(json::Builder{}.StartDict().Key("error_message").Value(std::string(error.what())).EndDict().Build());
+        }
+        json::PrintCompact(response, output);
+        output << '\n';
+        output.flush();
+    }
+}
+
+const std::map<std::string, LatencyStats> &RequestServer::GetLatencies() const {
+    return latencies_;
+}
+
+void RequestServer::PrintLatencyReport(std::ostream &out) const {
+    const auto precision = out.precision();
+    out << std::left << std::setw(8) << "type" << std::right << std::setw(10) << "count"
+        << std::setw(12) << "p50, us" << std::setw(12) << "p90, us" << std::setw(12) << "p99, us" << std::setw(12) << "max, us" << '\n';
+    for (const auto &[type, stats] : latencies_) {
+        out << std::left << std::setw(8) << type << std::right << std::setw(10) << stats.GetCount()
+            << std::fixed << std::setprecision(1)
+            << std::setw(12) << stats.GetPercentile(50.) << std::setw(12) << stats.GetPercentile(90.)
+            << std::setw(12) << stats.GetPercentile(99.) << std::setw(12) << stats.GetPercentile(100.) << '\n';
+        out.unsetf(std::ios::fixed);
+    }
+    out.precision(precision);
+    out.flush();
+}
+
+} // namespace server
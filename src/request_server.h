@@ -0,0 +1,82 @@
+#pragma once
+
+#include <chrono>
+#include <iostream>
+#include <map>
+#include <memory>
+#include <string>
+#include <vector>
+
+#include "json.h"
+#include "map_renderer.h"
+#include "profiler.h"
+#include "request_handler.h"
+#include "route_cache.h"
+#include "versioned_base.h"
+
+namespace server {
+
+// Задержки обработки запросов одного типа
+class LatencyStats {
+public:
+    void Add(double microseconds);
+
+    size_t GetCount() const;
+
+    // перцентиль p из [0, 100], в микросекундах
+    double GetPercentile(double p) const;
+
+private:
+    mutable std::vector<double> samples_;
+    mutable bool sorted_ = true;
+};
+
+// Долгоживущий обработчик запросов: каталог, маршрутизатор и отрисовщик строятся один раз,
+// после чего обслуживают сколько угодно документов stat_requests.
+// Обмен идёт построчно: каждая строка входа - документ {"stat_requests": [...]},
+// в ответ выводится одна строка с массивом ответов.
+// При работе с версионированной базой строка {"update_requests": [...]} публикует новую версию
+// (формат запросов - как у UpdateCatalogue), ответ - {"version": номер}
+class RequestServer {
+public:
+    RequestServer(const RequestHandler &req_handler, const RenderSets &render_sets);
+
+    // пакет запросов обрабатывается по версии базы, актуальной на его начало
+    explicit RequestServer(VersionedBase &versions);
+
+    // обрабатывает один пакет запросов, задержки учитываются по типам запросов
+    json::Document HandleBatch(const json::Array &stat_requests);
+
+    // Ответы на обычные запросы Route (без pareto и departure_time) берутся из кеша и сохраняются в него.
+    // Кеш может быть общим для нескольких серверов, nullptr отключает кеширование
+    void SetRouteCache(RouteCache *route_cache);
+
+    // задержки запросов дополнительно передаются профилировщику, nullptr отключает передачу
+    void SetProfiler(profile::Profiler *profiler);
+
+    // применяет изменения каталога и возвращает номер опубликованной версии
+    uint64_t HandleUpdate(const json::Array &update_requests);
+
+    // читает кадры из input до конца потока и пишет ответы в output
+    void Serve(std::istream &input, std::ostream &output);
+
+    const std::map<std::string, LatencyStats> &GetLatencies() const;
+
+    // перцентили задержек по типам запросов
+    void PrintLatencyReport(std::ostream &out) const;
+
+private:
+    const RequestHandler *req_handler_ = nullptr;
+    VersionedBase *versions_ = nullptr;
+    std::unique_ptr<VersionedBase::Reader> reader_;
+    MapRenderer renderer_;
+    RouteCache *route_cache_ = nullptr;
+    profile::Profiler *profiler_ = nullptr;
+
+    // version - версия базы, по которой строятся ответы (0 для неизменяемой базы)
+    json::Document HandleBatch(const RequestHandler &req_handler, const json::Array &stat_requests, uint64_t version);
+    json::Node HandleRoute(const RequestHandler &req_handler, const json::Node &req, uint64_t version);
+    std::map<std::string, LatencyStats> latencies_;
+};
+
+} // namespace server
@@ -0,0 +1,80 @@
+#include "route_cache.h"
+
+#include <algorithm>
+
+namespace server {
+
+RouteCache::RouteCache(size_t capacity, size_t shards_count)
+    : shards_count_(std::max<size_t>(shards_count, 1)),
+      shard_capacity_(std::max<size_t>(1, (capacity + shards_count_ - 1) / shards_count_)),
+      shards_(new Shard[shards_count_]) {
+}
+
+std::optional<json::Node> RouteCache::Get(domain::StopId from, domain::StopId to, uint64_t version) {
+    const uint64_t key = MakeKey(from, to);
+    Shard &shard = GetShard(key);
+    std::lock_guard lock(shard.mutex);
+    const auto entry = shard.index.find(key);
+    if (entry == shard.index.end() || entry->second->version != version) {
+        ++shard.misses;
+        return std::nullopt;
+    }
+    ++shard.hits;
+    shard.entries.splice(shard.entries.begin(), shard.entries, entry->second);
+    return entry->second->response;
+}
+
+void RouteCache::Put(domain::StopId from, domain::StopId to, uint64_t version, json::Node response) {
+    const uint64_t key = MakeKey(from, to);
+    Shard &shard = GetShard(key);
+    std::lock_guard lock(shard.mutex);
+    const auto entry = shard.index.find(key);
+    if (entry != shard.index.end()) {
+        if (entry->second->version > version) {
+            return;
+        }
+        entry->second->version = version;
+        entry->second->response = std::move(response);
+        shard.entries.splice(shard.entries.begin(), shard.entries, entry->second);
+        return;
+    }
+    if (shard.entries.size() >= shard_capacity_) {
+        shard.index.erase(shard.entries.back().key);
+        shard.entries.pop_back();
+    }
+    shard.entries.push_front({key, version, std::move(response)});
+    shard.index.emplace(key, shard.entries.begin());
+}
+
+void RouteCache::Clear() {
+    for (size_t i = 0; i < shards_count_; ++i) {
+        std::lock_guard lock(shards_[i].mutex);
+        shards_[i].entries.clear();
+        shards_[i].index.clear();
+    }
+}
+
+RouteCache::Stats RouteCache::GetStats() const {
+    Stats stats;
+    for (size_t i = 0; i < shards_count_; ++i) {
+        std::lock_guard lock(shards_[i].mutex);
+        stats.hits += shards_[i].hits;
+        stats.misses += shards_[i].misses;
+        stats.size += shards_[i].entries.size();
+    }
+    return stats;
+}
+
+uint64_t RouteCache::MakeKey(domain::StopId from, domain::StopId to) {
+    return (static_cast<uint64_t>(from) << 32) | to;
+}
+
+RouteCache::Shard &RouteCache::GetShard(uint64_t key) const {
+    // перемешивание, чтобы соседние пары попадали в разные сегменты
+    key ^= key >> 33;
+    key *= 0xff51afd7ed558ccdull;
+    key ^= key >> 33;
+    return shards_[key % shards_count_];
+}
+
+} // namespace server
@@ -0,0 +1,65 @@
+#pragma once
+
+#include <cstdint>
+#include <list>
+#include <memory>
+#include <mutex>
+#include <optional>
+#include <unordered_map>
+
+#include "domain.h"
+#include "json.h"
+
+namespace server {
+
+// Ограниченный кеш готовых ответов на запросы Route, ключ - пара id остановок.
+// Ключи распределены по сегментам с отдельными мьютексами и списками LRU, поэтому потоки,
+// обращающиеся к разным парам, почти не конкурируют. Ответ помнит версию базы, по которой построен:
+// запрос по другой версии его не видит, после изменения каталога записи вытесняются новыми
+class RouteCache {
+public:
+    struct Stats {
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+        size_t size = 0;
+    };
+
+    // capacity - общее число ответов, делится между shards_count сегментами
+    explicit RouteCache(size_t capacity, size_t shards_count = 16);
+
+    // ответ, построенный по версии базы version; std::nullopt - промах
+    std::optional<json::Node> Get(domain::StopId from, domain::StopId to, uint64_t version);
+
+    // ответ по более старой версии, чем уже сохранённый, не записывается
+    void Put(domain::StopId from, domain::StopId to, uint64_t version, json::Node response);
+
+    void Clear();
+
+    Stats GetStats() const;
+
+private:
+    struct Entry {
+        uint64_t key;
+        uint64_t version;
+        json::Node response;
+    };
+
+    // сегменты в отдельных строках кеша, чтобы мьютексы соседних не делили строку
+    struct alignas(64) Shard {
+        std::mutex mutex;
+        // от недавно использованных к давно использованным
+        std::list<Entry> entries;
+        std::unordered_map<uint64_t, std::list<Entry>::iterator> index;
+        uint64_t hits = 0;
+        uint64_t misses = 0;
+    };
+
+    size_t shards_count_;
+    size_t shard_capacity_;
+    std::unique_ptr<Shard[]> shards_;
+
+    static uint64_t MakeKey(domain::StopId from, domain::StopId to);
+    Shard &GetShard(uint64_t key) const;
+};
+
+} // namespace server
@@ -1,18 +1,45 @@
 #pragma once
 
+#include "all_pairs.h"
 #include "graph.h"
+#include "parallel.h"
 
 #include <algorithm>
 #include <cassert>
 #include <cstdint>
+#include <functional>
 #include <iterator>
+#include <limits>
+#include <memory>
 #include <optional>
 #include <stdexcept>
+#include <type_traits>
 #include <unordered_map>
 #include <utility>
 #include <vector>
 
 namespace graph {
+
+// способ предрасчёта таблицы маршрутов
+enum class AllPairsMethod {
+    // блочный алгоритм на плоских массивах, параллельный и векторизованный (ComputeAllPairs), только для double
+    BLOCKED,
+    // исходный последовательный алгоритм по таблице маршрутизатора
+    SEQUENTIAL
+};
+
+// Оценка затрат предрасчёта таблицы маршрутов до его начала
+struct AllPairsCost {
+    // число релаксаций d[i][j] = min(d[i][j], d[i][k] + d[k][j]), V^3
+    double relaxations = 0.;
+    // память таблицы маршрутизатора после построения, байт
+    size_t table_bytes = 0;
+    // пик памяти во время построения: при блочном расчёте одновременно живут плоская таблица и таблица маршрутизатора
+    size_t peak_bytes = 0;
+    // грубая оценка времени по скорости ядра релаксации
+    double seconds = 0.;
+};
+
 // алгоритм Флойда Уоршелла
 template <typename Weight>
 class Router {
@@ -20,98 +47,579 @@ private:
     using Graph = DirectedWeightedGraph<Weight>;
 
 public:
-    explicit Router(const Graph& graph);
+    // Вес в таблице: float вместо double, относительная погрешность 2^-24. Время в ответах складывается из весов рёбер
+    // маршрута в Weight, при обновлении таблицы пути тоже сравниваются по точным весам
+    using StoredWeight = std::conditional_t<std::is_same_v<Weight, double>, float, Weight>;
+
+    static constexpr uint32_t NO_EDGE = std::numeric_limits<uint32_t>::max();
+    // вес недостижимой пары
+    static constexpr StoredWeight UNREACHABLE = std::numeric_limits<StoredWeight>::has_infinity
+                                                    ? std::numeric_limits<StoredWeight>::infinity()
+                                                    : std::numeric_limits<StoredWeight>::max();
+
+    // Ячейка таблицы: 8 байт вместо 32 у optional<{double, optional<EdgeId>}>.
+    // У недостижимой пары вес UNREACHABLE, у пути из вершины в неё же и у недостижимых пар нет последнего ребра
+    struct RouteInternalData {
+        StoredWeight weight;
+        uint32_t prev_edge;
+    };
+    // Таблица V x V одним массивом по строкам, индекс пары - from * vertex_count + to.
+    // Вместо cells ячейки могут лежать в чужой неизменяемой памяти (в отображённом снимке): mapped_cells указывает
+    // на них, mapped_storage держит эту память. Перед первым изменением таблицы ячейки копируются в cells
+    struct RoutesInternalData {
+        RoutesInternalData() = default;
+
+        // таблица в памяти процесса
+        RoutesInternalData(size_t vertex_count, std::vector<RouteInternalData> cells)
+            : vertex_count(vertex_count)
+            , cells(std::move(cells)) {
+        }
+
+        // таблица в чужой памяти, например в отображённом снимке: storage держит её, пока жива таблица
+        RoutesInternalData(size_t vertex_count, const RouteInternalData* mapped_cells, std::shared_ptr<const void> mapped_storage)
+            : vertex_count(vertex_count)
+            , mapped_cells(mapped_cells)
+            , mapped_storage(std::move(mapped_storage)) {
+        }
+
+        size_t vertex_count = 0;
+        std::vector<RouteInternalData> cells;
+        const RouteInternalData* mapped_cells = nullptr;
+        std::shared_ptr<const void> mapped_storage;
+
+        const RouteInternalData* GetCells() const {
+            return mapped_cells ? mapped_cells : cells.data();
+        }
+
+        size_t GetCellCount() const {
+            return mapped_cells ? vertex_count * vertex_count : cells.size();
+        }
+    };
+
+    // progress сообщает ход расчёта (см. AllPairsProgress)
+    explicit Router(const Graph& graph, AllPairsMethod method = AllPairsMethod::BLOCKED, const AllPairsProgress& progress = {});
+
+    // восстановление по ранее рассчитанным данным (например, из снимка), без повторного расчёта
+    Router(const Graph& graph, RoutesInternalData routes_internal_data);
+
+    // Затраты на построение маршрутизатора для графа с vertex_count вершинами и edge_count рёбрами
+    // при расчёте в threads_count потоках (0 - по числу ядер)
+    static AllPairsCost EstimateCost(size_t vertex_count, size_t edge_count, AllPairsMethod method = AllPairsMethod::BLOCKED,
+                                     size_t threads_count = 0);
+
+    // рёбра маршрута в порядке поездки
+    using RouteEdges = std::vector<std::pair<EdgeId, const graph::Edge<Weight>*>>;
 
     struct RouteInfo {
         Weight weight;
-        std::vector<std::pair<EdgeId, const graph::Edge<Weight>*>> edges;
+        RouteEdges edges;
     };
 
     std::optional<RouteInfo> BuildRoute(VertexId from, VertexId to) const;
 
+    // Записывает рёбра маршрута в буфер edges, прежнее содержимое удаляется, а память переиспользуется.
+    // Возвращает время пути - сумму весов рёбер, std::nullopt (и пустой буфер) если маршрута нет
+    std::optional<Weight> BuildRoute(VertexId from, VertexId to, RouteEdges& edges) const;
+
+    // Только время пути, без записи рёбер: сумма весов рёбер по цепочке последних рёбер в полной точности Weight
+    std::optional<Weight> GetRouteWeight(VertexId from, VertexId to) const {
+        const auto& route = GetCell(from, to);
+        if (route.weight == UNREACHABLE) {
+            return std::nullopt;
+        }
+        const RouteInternalData* routes_from = GetRow(from);
+        Weight weight{};
+        for (uint32_t edge_id = route.prev_edge; edge_id != NO_EDGE; edge_id = routes_from[graph_.GetEdge(edge_id).from].prev_edge) {
+            weight += graph_.GetEdge(edge_id).weight;
+        }
+        return weight;
+    }
+
+    const RoutesInternalData& GetRoutesInternalData() const {
+        return routes_internal_data_;
+    }
+
+    // Обновление таблицы после изменения графа без полного пересчёта.
+    // В каждой строке заново ищутся пути только до вершин, путь до которых проходил через удалённое ребро (Дейкстрой
+    // без добавленных рёбер), затем добавленные рёбра (u, v) по одному учитываются во всех строках релаксацией
+    // d[i][j] = min(d[i][j], d[i][u] + w + d[v][j]).
+    // Если починка по оценке дольше полного расчёта (удалённые рёбра лежат на большей части путей таблицы),
+    // таблица строится заново
+    void Update(const std::vector<EdgeId>& removed_edges, const std::vector<EdgeId>& added_edges);
+
 private:
-    struct RouteInternalData {
-        Weight weight;
-        std::optional<EdgeId> prev_edge;
-    };
-    using RoutesInternalData = std::vector<std::vector<std::optional<RouteInternalData>>>;
+    const RouteInternalData& GetCell(VertexId from, VertexId to) const {
+        const size_t vertex_count = routes_internal_data_.vertex_count;
+        if (from >= vertex_count || to >= vertex_count) {
+            throw std::out_of_range("Vertex is out of the routes table");
+        }
+        return routes_internal_data_.GetCells()[from * vertex_count + to];
+    }
+
+    const RouteInternalData* GetRow(VertexId from) const {
+        return routes_internal_data_.GetCells() + from * routes_internal_data_.vertex_count;
+    }
+
+    // строки для записи; таблица в чужой памяти перед этим копируется (см. MakeCellsOwned)
+    RouteInternalData* GetRow(VertexId from) {
+        return routes_internal_data_.cells.data() + from * routes_internal_data_.vertex_count;
+    }
+
+    void MakeCellsOwned() {
+        if (routes_internal_data_.mapped_cells) {
+            const RouteInternalData* mapped_cells = routes_internal_data_.mapped_cells;
+            routes_internal_data_.cells.assign(mapped_cells, mapped_cells + routes_internal_data_.GetCellCount());
+            routes_internal_data_.mapped_cells = nullptr;
+            routes_internal_data_.mapped_storage.reset();
+        }
+    }
+
+    // id рёбер хранятся в 32 битах
+    void CheckEdgeCount() const {
+        if (graph_.GetEdgeCount() >= NO_EDGE) {
+            throw std::length_error("Too many edges for the routes table");
+        }
+    }
+
+    static uint32_t PrevEdgeOf(const RouteInternalData& route_to, uint32_t fallback_edge) {
+        return route_to.prev_edge != NO_EDGE ? route_to.prev_edge : fallback_edge;
+    }
 
     void InitializeRoutesInternalData(const Graph& graph) {
         const size_t vertex_count = graph.GetVertexCount();
         for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
-            routes_internal_data_[vertex][vertex] = RouteInternalData{ZERO_WEIGHT, std::nullopt};
+            RouteInternalData* row = GetRow(vertex);
+            row[vertex] = {ZERO_WEIGHT, NO_EDGE};
             for (const EdgeId edge_id : graph.GetIncidentEdges(vertex)) {
                 const auto& edge = graph.GetEdge(edge_id);
-                if (edge.weight < ZERO_WEIGHT) {
+                if (edge.weight < Weight{}) {
                     throw std::domain_error("Edges' weights should be non-negative");
                 }
-                auto& route_internal_data = routes_internal_data_[vertex][edge.to];
-                if (!route_internal_data || route_internal_data->weight > edge.weight) {
-                    route_internal_data = RouteInternalData{edge.weight, edge_id};
+                auto& route_internal_data = row[edge.to];
+                const auto weight = static_cast<StoredWeight>(edge.weight);
+                if (route_internal_data.weight > weight) {
+                    route_internal_data = {weight, static_cast<uint32_t>(edge_id)};
                 }
             }
         }
     }
 
-    void RelaxRoute(VertexId vertex_from, VertexId vertex_to, const RouteInternalData& route_from,
-                    const RouteInternalData& route_to) {
-        auto& route_relaxing = routes_internal_data_[vertex_from][vertex_to];
-        const Weight candidate_weight = route_from.weight + route_to.weight;
-        if (!route_relaxing || candidate_weight < route_relaxing->weight) {
-            route_relaxing = {candidate_weight,
-                              route_to.prev_edge ? route_to.prev_edge : route_from.prev_edge};
+    void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through) {
+        const RouteInternalData* row_through = GetRow(vertex_through);
+        for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
+            RouteInternalData* row = GetRow(vertex_from);
+            const RouteInternalData route_from = row[vertex_through];
+            if (route_from.weight == UNREACHABLE) {
+                continue;
+            }
+            for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
+                const auto& route_to = row_through[vertex_to];
+                if (route_to.weight == UNREACHABLE) {
+                    continue;
+                }
+                // сумма в Weight, запись - только если улучшается хранимый вес
+                const auto candidate_weight = static_cast<StoredWeight>(static_cast<Weight>(route_from.weight) + route_to.weight);
+                auto& route_relaxing = row[vertex_to];
+                if (candidate_weight < route_relaxing.weight) {
+                    route_relaxing = {candidate_weight, PrevEdgeOf(route_to, route_from.prev_edge)};
+                }
+            }
         }
     }
 
-    void RelaxRoutesInternalDataThroughVertex(size_t vertex_count, VertexId vertex_through) {
-        for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
-            if (const auto& route_from = routes_internal_data_[vertex_from][vertex_through]) {
-                for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
-                    if (const auto& route_to = routes_internal_data_[vertex_through][vertex_to]) {
-                        RelaxRoute(vertex_from, vertex_to, *route_from, *route_to);
+    // Расчёт всей таблицы; ячейки должны быть заполнены UNREACHABLE
+    void ComputeRoutes(AllPairsMethod method, const AllPairsProgress& progress) {
+        if constexpr (std::is_same_v<Weight, double>) {
+            if (method == AllPairsMethod::BLOCKED) {
+                // пути выбираются расчётом в double, в таблицу записываются уже готовые веса
+                const AllPairsTable table = ComputeAllPairs(graph_, 0, progress);
+                for (VertexId vertex_from = 0; vertex_from < table.vertex_count; ++vertex_from) {
+                    RouteInternalData* row = GetRow(vertex_from);
+                    for (VertexId vertex_to = 0; vertex_to < table.vertex_count; ++vertex_to) {
+                        const double weight = table.GetWeight(vertex_from, vertex_to);
+                        if (weight == std::numeric_limits<double>::infinity()) {
+                            continue;
+                        }
+                        const EdgeId prev_edge = table.GetPrevEdge(vertex_from, vertex_to);
+                        row[vertex_to] = {static_cast<StoredWeight>(weight),
+                                          prev_edge == AllPairsTable::NO_EDGE ? NO_EDGE : static_cast<uint32_t>(prev_edge)};
                     }
                 }
+                return;
+            }
+        }
+        InitializeRoutesInternalData(graph_);
+
+        const size_t vertex_count = graph_.GetVertexCount();
+        for (VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
+            RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through);
+            if (progress) {
+                progress(vertex_through + 1, vertex_count);
             }
         }
     }
 
-    static constexpr Weight ZERO_WEIGHT{};
+    // Рабочие массивы строки в Weight, общие для всех строк и вызовов Update: починка строки, точные веса путей
+    // строки (DecodeRow) и вершины со сломанными путями (MarkBrokenRoutes). Между строками они не обнуляются:
+    // вес и отметка сломанного пути вершины актуальны, если её отметка равна номеру запуска
+    struct RowSearch {
+        std::vector<Weight> weights;
+        std::vector<uint32_t> reached_marks;
+        std::vector<uint32_t> broken_marks;
+        std::vector<VertexId> broken;
+        std::vector<std::pair<Weight, VertexId>> heap;
+        std::vector<VertexId> chain;
+        uint32_t run = 0;
+
+        void Resize(size_t vertex_count) {
+            weights.resize(vertex_count);
+            reached_marks.resize(vertex_count, 0);
+            broken_marks.resize(vertex_count, 0);
+        }
+
+        void NextRun() {
+            if (++run == 0) {
+                std::fill(reached_marks.begin(), reached_marks.end(), 0);
+                std::fill(broken_marks.begin(), broken_marks.end(), 0);
+                run = 1;
+            }
+        }
+
+        bool IsReached(VertexId vertex) const {
+            return reached_marks[vertex] == run;
+        }
+
+        void Reach(VertexId vertex, Weight weight) {
+            weights[vertex] = weight;
+            reached_marks[vertex] = run;
+        }
+
+        bool IsBroken(VertexId vertex) const {
+            return broken_marks[vertex] == run;
+        }
+
+        void Break(VertexId vertex) {
+            broken_marks[vertex] = run;
+            broken.push_back(vertex);
+        }
+    };
+
+    // Отмечает в decoded вершины строки, пути до которых проходят через удалённое ребро (removed_edges[id] == true),
+    // и возвращает их число; до остальных достижимых вершин в decoded точные веса путей, как у DecodeRow
+    size_t MarkBrokenRoutes(VertexId vertex_from, const std::vector<bool>& removed_edges, RowSearch& decoded) const {
+        const RouteInternalData* row = GetRow(vertex_from);
+        const size_t vertex_count = routes_internal_data_.vertex_count;
+        decoded.NextRun();
+        decoded.broken.clear();
+        decoded.Reach(vertex_from, Weight{});
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            if (row[vertex].weight == UNREACHABLE || decoded.IsReached(vertex) || decoded.IsBroken(vertex)) {
+                continue;
+            }
+            decoded.chain.clear();
+            VertexId chain_vertex = vertex;
+            while (!decoded.IsReached(chain_vertex) && !decoded.IsBroken(chain_vertex)) {
+                decoded.chain.push_back(chain_vertex);
+                chain_vertex = graph_.GetEdge(row[chain_vertex].prev_edge).from;
+            }
+            // путь сломан с первого удалённого ребра до конца цепочки
+            bool broken = decoded.IsBroken(chain_vertex);
+            Weight weight = broken ? Weight{} : decoded.weights[chain_vertex];
+            for (auto it = decoded.chain.rbegin(); it != decoded.chain.rend(); ++it) {
+                const uint32_t edge_id = row[*it].prev_edge;
+                broken = broken || removed_edges[edge_id];
+                if (broken) {
+                    decoded.Break(*it);
+                } else {
+                    weight += graph_.GetEdge(edge_id).weight;
+                    decoded.Reach(*it, weight);
+                }
+            }
+        }
+        return decoded.broken.size();
+    }
+
+    // Пути строки после удаления рёбер. Целые пути остаются кратчайшими: удаление рёбер пути не укорачивает,
+    // поэтому заново ищутся только пути до вершин со сломанными путями (MarkBrokenRoutes) - Дейкстрой по этим
+    // вершинам, начатой с рёбер из вершин с целыми путями. Рёбра skipped_edges не учитываются: все строки перед
+    // релаксацией через очередное добавленное ребро должны учитывать одни и те же рёбра, иначе путь строки d[v]
+    // может идти по ещё не учтённому в d[i] ребру, и дерево путей строки i разойдётся с весами
+    void RepairRoutesFrom(VertexId vertex_from, const std::vector<bool>& removed_edges, const std::vector<bool>& skipped_edges) {
+        auto& search = row_search_;
+        MarkBrokenRoutes(vertex_from, removed_edges, search);
+        RouteInternalData* row = GetRow(vertex_from);
+        const auto is_whole = [&search](VertexId vertex) {
+            return search.IsReached(vertex) && !search.IsBroken(vertex);
+        };
+        search.heap.clear();
+        for (const VertexId vertex : search.broken) {
+            row[vertex] = {UNREACHABLE, NO_EDGE};
+            for (const EdgeId edge_id : graph_.GetIncomingEdges(vertex)) {
+                const auto& edge = graph_.GetEdge(edge_id);
+                if (skipped_edges[edge_id] || !is_whole(edge.from)) {
+                    continue;
+                }
+                const Weight candidate_weight = search.weights[edge.from] + edge.weight;
+                if (!search.IsReached(vertex) || candidate_weight < search.weights[vertex]) {
+                    search.Reach(vertex, candidate_weight);
+                    row[vertex].prev_edge = static_cast<uint32_t>(edge_id);
+                }
+            }
+            if (search.IsReached(vertex)) {
+                search.heap.push_back({search.weights[vertex], vertex});
+            }
+        }
+        std::make_heap(search.heap.begin(), search.heap.end(), std::greater<>{});
+        while (!search.heap.empty()) {
+            std::pop_heap(search.heap.begin(), search.heap.end(), std::greater<>{});
+            const auto [weight, vertex] = search.heap.back();
+            search.heap.pop_back();
+            if (search.weights[vertex] < weight) {
+                continue;
+            }
+            row[vertex].weight = static_cast<StoredWeight>(weight);
+            for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                const auto& edge = graph_.GetEdge(edge_id);
+                if (skipped_edges[edge_id] || !search.IsBroken(edge.to)) {
+                    continue;
+                }
+                const Weight candidate_weight = weight + edge.weight;
+                if (!search.IsReached(edge.to) || candidate_weight < search.weights[edge.to]) {
+                    search.Reach(edge.to, candidate_weight);
+                    row[edge.to].prev_edge = static_cast<uint32_t>(edge_id);
+                    search.heap.push_back({candidate_weight, edge.to});
+                    std::push_heap(search.heap.begin(), search.heap.end(), std::greater<>{});
+                }
+            }
+        }
+    }
+
+    // Точные веса путей строки: сумма весов рёбер по цепочке последних рёбер в порядке поездки, как в BuildRoute.
+    // Недостижимые вершины остаются неотмеченными
+    void DecodeRow(VertexId vertex_from, RowSearch& decoded) {
+        const RouteInternalData* row = std::as_const(*this).GetRow(vertex_from);
+        const size_t vertex_count = routes_internal_data_.vertex_count;
+        decoded.NextRun();
+        decoded.Reach(vertex_from, Weight{});
+        for (VertexId vertex = 0; vertex < vertex_count; ++vertex) {
+            if (row[vertex].weight == UNREACHABLE || decoded.IsReached(vertex)) {
+                continue;
+            }
+            // вершины цепочки до первой уже известной, затем веса от неё вперёд
+            decoded.chain.clear();
+            VertexId chain_vertex = vertex;
+            while (!decoded.IsReached(chain_vertex)) {
+                decoded.chain.push_back(chain_vertex);
+                chain_vertex = graph_.GetEdge(row[chain_vertex].prev_edge).from;
+            }
+            Weight weight = decoded.weights[chain_vertex];
+            for (auto it = decoded.chain.rbegin(); it != decoded.chain.rend(); ++it) {
+                weight += graph_.GetEdge(row[*it].prev_edge).weight;
+                decoded.Reach(*it, weight);
+            }
+        }
+    }
+
+    // Учёт нового ребра во всех строках таблицы. Пути сравниваются в Weight по точным весам (DecodeRow), как при
+    // полном расчёте: округлённые до StoredWeight веса не различают пути, разные в Weight, и обновление выбирало бы
+    // не те пути, что полный расчёт. Хранимые веса только отсеивают строки, где конец ребра заведомо не ближе
+    void RelaxRoutesThroughEdge(EdgeId edge_id) {
+        const auto& edge = graph_.GetEdge(edge_id);
+        const size_t vertex_count = routes_internal_data_.vertex_count;
+        const RouteInternalData* routes_from_edge = std::as_const(*this).GetRow(edge.to);
+        DecodeRow(edge.to, edge_end_row_);
+        for (VertexId vertex_from = 0; vertex_from < vertex_count; ++vertex_from) {
+            RouteInternalData* row = GetRow(vertex_from);
+            if (row[edge.from].weight == UNREACHABLE) {
+                continue;
+            }
+            // хранимый вес отличается от точного не больше чем на ROUNDING относительно
+            if (row[edge.to].weight != UNREACHABLE
+                && !(static_cast<Weight>(row[edge.from].weight) * (1 - ROUNDING) + edge.weight
+                     < static_cast<Weight>(row[edge.to].weight) * (1 + ROUNDING))) {
+                continue;
+            }
+            DecodeRow(vertex_from, row_search_);
+            const Weight weight_to_edge_end = row_search_.weights[edge.from] + edge.weight;
+            // если конец ребра не стал ближе, то и пути через него не улучшатся
+            if (row_search_.IsReached(edge.to) && !(weight_to_edge_end < row_search_.weights[edge.to])) {
+                continue;
+            }
+            for (VertexId vertex_to = 0; vertex_to < vertex_count; ++vertex_to) {
+                if (!edge_end_row_.IsReached(vertex_to)) {
+                    continue;
+                }
+                const Weight candidate_weight = weight_to_edge_end + edge_end_row_.weights[vertex_to];
+                if (!row_search_.IsReached(vertex_to) || candidate_weight < row_search_.weights[vertex_to]) {
+                    row[vertex_to] = {static_cast<StoredWeight>(candidate_weight),
+                                      PrevEdgeOf(routes_from_edge[vertex_to], static_cast<uint32_t>(edge_id))};
+                }
+            }
+        }
+    }
+
+    static constexpr StoredWeight ZERO_WEIGHT{};
+    // наибольшая относительная погрешность хранимого веса: округление до StoredWeight с запасом
+    static constexpr Weight ROUNDING = 2 * std::numeric_limits<StoredWeight>::epsilon();
     const Graph& graph_;
     RoutesInternalData routes_internal_data_;
+    RowSearch row_search_;
+    // точные веса строки конца добавляемого ребра (RelaxRoutesThroughEdge)
+    RowSearch edge_end_row_;
 };
 
 template <typename Weight>
-Router<Weight>::Router(const Graph& graph)
+AllPairsCost Router<Weight>::EstimateCost(size_t vertex_count, size_t edge_count, AllPairsMethod method, size_t threads_count) {
+    // релаксаций в секунду на поток: векторное ядро блочного расчёта на современном x86 и последовательный алгоритм;
+    // порядок величины по бенчмарку all_pairs, для решения "минуты или часы", а не для точного прогноза
+    const double blocked_rate = 2e9;
+    const double sequential_rate = 2e8;
+    const bool blocked = std::is_same_v<Weight, double> && method == AllPairsMethod::BLOCKED;
+    const auto vertices = static_cast<double>(vertex_count);
+
+    AllPairsCost cost;
+    cost.relaxations = vertices * vertices * vertices;
+    const size_t cells = vertex_count * vertex_count;
+    cost.table_bytes = cells * sizeof(RouteInternalData);
+    cost.peak_bytes = cost.table_bytes;
+    if (blocked) {
+        const size_t stride = (vertex_count + 3) / 4 * 4;
+        cost.peak_bytes += vertex_count * stride * (sizeof(double) + sizeof(EdgeId));
+    }
+    // блочный расчёт параллелится, последовательный - нет; заполнение таблицы линейно по ячейкам и рёбрам
+    const double threads = blocked ? static_cast<double>(parallel::ResolveThreadsCount(threads_count)) : 1.;
+    cost.seconds = cost.relaxations / threads / (blocked ? blocked_rate : sequential_rate)
+                   + static_cast<double>(cells + edge_count) / blocked_rate;
+    return cost;
+}
+
+template <typename Weight>
+Router<Weight>::Router(const Graph& graph, AllPairsMethod method, const AllPairsProgress& progress)
     : graph_(graph)
     , routes_internal_data_(graph.GetVertexCount(),
-                            std::vector<std::optional<RouteInternalData>>(graph.GetVertexCount()))
+                            std::vector<RouteInternalData>(graph.GetVertexCount() * graph.GetVertexCount(), {UNREACHABLE, NO_EDGE}))
 {
-    InitializeRoutesInternalData(graph);
+    CheckEdgeCount();
+    ComputeRoutes(method, progress);
+}
 
+template <typename Weight>
+Router<Weight>::Router(const Graph& graph, RoutesInternalData routes_internal_data)
+    : graph_(graph)
+    , routes_internal_data_(std::move(routes_internal_data))
+{
     const size_t vertex_count = graph.GetVertexCount();
-    for (VertexId vertex_through = 0; vertex_through < vertex_count; ++vertex_through) {
-        RelaxRoutesInternalDataThroughVertex(vertex_count, vertex_through);
+    if (routes_internal_data_.vertex_count != vertex_count || routes_internal_data_.GetCellCount() != vertex_count * vertex_count) {
+        throw std::invalid_argument("Routes data does not match the graph");
+    }
+    CheckEdgeCount();
+}
+
+template <typename Weight>
+void Router<Weight>::Update(const std::vector<EdgeId>& removed_edges, const std::vector<EdgeId>& added_edges) {
+    CheckEdgeCount();
+    for (const EdgeId edge_id : added_edges) {
+        if (graph_.GetEdge(edge_id).weight < Weight{}) {
+            throw std::domain_error("Edges' weights should be non-negative");
+        }
+    }
+    const size_t vertex_count = graph_.GetVertexCount();
+    const size_t old_vertex_count = routes_internal_data_.vertex_count;
+
+    // Строки, в которых путь хотя бы до одной вершины проходит через удалённое ребро, и число таких путей
+    std::vector<bool> removed(graph_.GetEdgeCount(), false);
+    for (const EdgeId edge_id : removed_edges) {
+        removed[edge_id] = true;
+    }
+    row_search_.Resize(vertex_count);
+    edge_end_row_.Resize(vertex_count);
+    std::vector<VertexId> affected_rows;
+    size_t broken_routes = 0;
+    if (!removed_edges.empty()) {
+        for (VertexId vertex_from = 0; vertex_from < old_vertex_count; ++vertex_from) {
+            if (const size_t broken = MarkBrokenRoutes(vertex_from, removed, row_search_)) {
+                affected_rows.push_back(vertex_from);
+                broken_routes += broken;
+            }
+        }
+    }
+
+    // Починка строки - проход по ней и Дейкстра по сломанным путям, на вершину в среднем 2E / V рёбер в неё и из неё;
+    // около 1e8 операций в секунду. Полный расчёт оценивает EstimateCost
+    const double row_search_rate = 1e8;
+    const double average_degree = 2. * static_cast<double>(graph_.GetEdgeCount()) / static_cast<double>(std::max<size_t>(vertex_count, 1));
+    const double repair_seconds = (static_cast<double>(affected_rows.size() * old_vertex_count)
+                                   + static_cast<double>(broken_routes) * average_degree) / row_search_rate;
+    if (repair_seconds > EstimateCost(vertex_count, graph_.GetEdgeCount()).seconds) {
+        routes_internal_data_ = RoutesInternalData(vertex_count,
+                                                   std::vector<RouteInternalData>(vertex_count * vertex_count, {UNREACHABLE, NO_EDGE}));
+        ComputeRoutes(AllPairsMethod::BLOCKED, {});
+        return;
+    }
+
+    MakeCellsOwned();
+    // новые вершины: пути из них и в них пока неизвестны; строки переносятся в таблицу с новой длиной строки
+    if (vertex_count != old_vertex_count) {
+        std::vector<RouteInternalData> cells(vertex_count * vertex_count, {UNREACHABLE, NO_EDGE});
+        for (VertexId vertex = 0; vertex < old_vertex_count; ++vertex) {
+            const RouteInternalData* row = GetRow(vertex);
+            std::copy(row, row + old_vertex_count, cells.begin() + vertex * vertex_count);
+        }
+        routes_internal_data_ = RoutesInternalData(vertex_count, std::move(cells));
+        for (VertexId vertex = old_vertex_count; vertex < vertex_count; ++vertex) {
+            GetRow(vertex)[vertex] = {ZERO_WEIGHT, NO_EDGE};
+        }
+    }
+
+    std::vector<bool> pending_edges(graph_.GetEdgeCount(), false);
+    for (const EdgeId edge_id : added_edges) {
+        pending_edges[edge_id] = true;
+    }
+    for (const VertexId vertex_from : affected_rows) {
+        RepairRoutesFrom(vertex_from, removed, pending_edges);
+    }
+
+    for (const EdgeId edge_id : added_edges) {
+        if (!graph_.IsEdgeRemoved(edge_id)) {
+            RelaxRoutesThroughEdge(edge_id);
+        }
     }
 }
 
 template <typename Weight>
 std::optional<typename Router<Weight>::RouteInfo> Router<Weight>::BuildRoute(VertexId from,
                                                                              VertexId to) const {
-    const auto& route_internal_data = routes_internal_data_.at(from).at(to);
-    if (!route_internal_data) {
+    RouteInfo route;
+    const auto weight = BuildRoute(from, to, route.edges);
+    if (!weight) {
         return std::nullopt;
     }
-    const Weight weight = route_internal_data->weight;
-    std::vector<std::pair<EdgeId, const graph::Edge<Weight>*>> edges;
-    for (std::optional<EdgeId> edge_id = route_internal_data->prev_edge;
-         edge_id;
-         edge_id = routes_internal_data_[from][graph_.GetEdge(*edge_id).from]->prev_edge)
-    {   
-        edges.push_back(std::make_pair(*edge_id, &(graph_.GetEdge(*edge_id))));
-    }
-    //std::reverse(edges.begin().first, edges.end().first);
+    route.weight = *weight;
+    return route;
+}
 
-    return RouteInfo{weight, std::move(edges)};
+template <typename Weight>
+std::optional<Weight> Router<Weight>::BuildRoute(VertexId from, VertexId to, RouteEdges& edges) const {
+    edges.clear();
+    const auto& route_internal_data = GetCell(from, to);
+    if (route_internal_data.weight == UNREACHABLE) {
+        return std::nullopt;
+    }
+    // последние рёбра восстанавливаются от конца маршрута к началу, затем порядок разворачивается на месте
+    const RouteInternalData* routes_from = std::as_const(*this).GetRow(from);
+    for (uint32_t edge_id = route_internal_data.prev_edge;
+         edge_id != NO_EDGE;
+         edge_id = routes_from[graph_.GetEdge(edge_id).from].prev_edge)
+    {
+        edges.emplace_back(edge_id, &graph_.GetEdge(edge_id));
+    }
+    std::reverse(edges.begin(), edges.end());
+    // время маршрута - сумма рёбер в полной точности Weight, а не округлённый вес из таблицы
+    Weight weight{};
+    for (const auto& [edge_id, edge] : edges) {
+        weight += edge->weight;
+    }
+    return weight;
 }
 
-}  // namespace graph
\ No newline at end of file
+}  // namespace graph
@@ -0,0 +1,648 @@
+#include "serialization.h"
+
+#include <algorithm>
+#include <cstring>
+#include <fstream>
+#include <iterator>
+#include <limits>
+#include <optional>
+#include <type_traits>
+#include <vector>
+
+#if defined(__unix__) || defined(__APPLE__)
+#define SNAPSHOT_HAS_MMAP 1
+#include <fcntl.h>
+#include <sys/mman.h>
+#include <sys/stat.h>
+#include <unistd.h>
+#endif
+
+namespace serialization {
+
+namespace {
+
+const char SNAPSHOT_MAGIC[8] = {'T', 'C', 'S', 'N', 'A', 'P', '\0', '\0'};
+// записывается как есть и позволяет обнаружить файл с другим порядком байт
+const uint32_t BYTE_ORDER_MARK = 0x01020304;
+
+// Контрольная сумма checksum покрывает всё содержимое, кроме ячеек таблицы маршрутов: их V * V и при загрузке
+// они не читаются, поэтому у них своя сумма table_checksum, проверяемая только по запросу
+struct SnapshotHeader {
+    char magic[8];
+    uint32_t version;
+    uint32_t byte_order;
+    uint64_t payload_size;
+    uint64_t checksum;
+    // ячейки таблицы маршрутов: смещение от начала содержимого и размер в байтах
+    uint64_t table_offset;
+    uint64_t table_size;
+    uint64_t table_checksum;
+};
+
+// ячейка таблицы маршрутизатора хранится в файле как в памяти: вес (бесконечность - маршрута нет) и последнее ребро
+using RouteCell = graph::Router<double>::RouteInternalData;
+// содержимое идёт сразу за заголовком, поэтому выровненные в нём ячейки выровнены и в отображённом файле
+static_assert(sizeof(SnapshotHeader) % alignof(RouteCell) == 0);
+
+enum class ColorTag : uint8_t {
+    NONE,
+    STRING,
+    RGB,
+    RGBA,
+};
+
+// FNV-1a по 8-байтовым словам в четыре независимых потока, проверка целостности содержимого.
+// Слово за шаг и независимые умножения хешируют таблицу маршрутов со скоростью чтения памяти, а не по байту за шаг
+const uint64_t FNV_OFFSET_BASIS = 14695981039346656037ull;
+const uint64_t FNV_PRIME = 1099511628211ull;
+
+uint64_t ComputeChecksum(const char *data, size_t size) {
+    const uint64_t offset_basis = FNV_OFFSET_BASIS;
+    const uint64_t prime = FNV_PRIME;
+    const size_t lanes_count = 4;
+    uint64_t lanes[lanes_count] = {offset_basis, offset_basis + 1, offset_basis + 2, offset_basis + 3};
+    size_t pos = 0;
+    for (; pos + lanes_count * sizeof(uint64_t) <= size; pos += lanes_count * sizeof(uint64_t)) {
+        for (size_t lane = 0; lane < lanes_count; ++lane) {
+            uint64_t word;
+            std::memcpy(&word, data + pos + lane * sizeof(uint64_t), sizeof(word));
+            lanes[lane] = (lanes[lane] ^ word) * prime;
+        }
+    }
+    uint64_t hash = offset_basis;
+    for (const uint64_t lane : lanes) {
+        hash = (hash ^ lane) * prime;
+    }
+    for (; pos < size; ++pos) {
+        hash = (hash ^ static_cast<unsigned char>(data[pos])) * prime;
+    }
+    return hash;
+}
+
+// сумма содержимого без ячеек таблицы маршрутов [table_offset, table_offset + table_size)
+uint64_t ComputeChecksumWithoutTable(const char *payload, size_t payload_size, size_t table_offset, size_t table_size) {
+    const size_t table_end = table_offset + table_size;
+    return (ComputeChecksum(payload, table_offset) * FNV_PRIME) ^ ComputeChecksum(payload + table_end, payload_size - table_end);
+}
+
+class SnapshotWriter {
+public:
+    template <typename T>
+    void Write(const T &value) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        const char *bytes = reinterpret_cast<const char *>(&value);
+        buffer_.insert(buffer_.end(), bytes, bytes + sizeof(T));
+    }
+
+    template <typename T>
+    void WriteArray(const T *values, size_t count) {
+        static_assert(std::is_trivially_copyable_v<T>);
+        Write<uint64_t>(count);
+        const char *bytes = reinterpret_cast<const char *>(values);
+        buffer_.insert(buffer_.end(), bytes, bytes + sizeof(T) * count);
+    }
+
+    // Массив, выровненный по alignof(T) от начала содержимого: при загрузке он читается прямо из отображённого файла
+    // Возвращает смещение первого элемента от начала содержимого
+    template <typename T>
+    size_t WriteAlignedArray(const T *values, size_t count) {
+        Write<uint64_t>(count);
+        buffer_.resize((buffer_.size() + alignof(T) - 1) / alignof(T) * alignof(T), '\0');
+        const size_t offset = buffer_.size();
+        const char *bytes = reinterpret_cast<const char *>(values);
+        buffer_.insert(buffer_.end(), bytes, bytes + sizeof(T) * count);
+        return offset;
+    }
+
+    void WriteString(std::string_view value) {
+        WriteArray(value.data(), value.size());
+    }
+
+    const std::vector<char> &GetBuffer() const {
+        return buffer_;
+    }
+
+private:
+    std::vector<char> buffer_;
+};
+
+// Чтение из отображённой памяти с проверкой границ
+class SnapshotReader {
+public:
+    SnapshotReader(const char *data, size_t size)
+        : data_(data), size_(size) {
+    }
+
+    template <typename T>
+    T Read() {
+        static_assert(std::is_trivially_copyable_v<T>);
+        T value;
+        std::memcpy(&value, Take(sizeof(T)), sizeof(T));
+        return value;
+    }
+
+    // возвращает указатель на count элементов внутри снимка, без копирования
+    template <typename T>
+    const char *ReadArray(size_t &count) {
+        count = static_cast<size_t>(Read<uint64_t>());
+        if (count > (size_ - pos_) / sizeof(T)) {
+            throw SnapshotError("Snapshot is truncated");
+        }
+        return Take(sizeof(T) * count);
+    }
+
+    // массив, записанный WriteAlignedArray; указатель выровнен, если выровнено начало содержимого
+    template <typename T>
+    const T *ReadAlignedArray(size_t &count) {
+        count = static_cast<size_t>(Read<uint64_t>());
+        Take((alignof(T) - pos_ % alignof(T)) % alignof(T));
+        if (count > (size_ - pos_) / sizeof(T)) {
+            throw SnapshotError("Snapshot is truncated");
+        }
+        return reinterpret_cast<const T *>(Take(sizeof(T) * count));
+    }
+
+    std::string_view ReadString() {
+        size_t size = 0;
+        const char *data = ReadArray<char>(size);
+        return {data, size};
+    }
+
+    bool AtEnd() const {
+        return pos_ == size_;
+    }
+
+private:
+    const char *data_;
+    size_t size_;
+    size_t pos_ = 0;
+
+    const char *Take(size_t bytes) {
+        if (bytes > size_ - pos_) {
+            throw SnapshotError("Snapshot is truncated");
+        }
+        const char *result = data_ + pos_;
+        pos_ += bytes;
+        return result;
+    }
+};
+
+// Файл снимка, отображённый в память только для чтения.
+// Там, где mmap недоступен, файл целиком читается в буфер
+class MappedFile {
+public:
+    explicit MappedFile(const std::string &path) {
+#ifdef SNAPSHOT_HAS_MMAP
+        const int fd = open(path.c_str(), O_RDONLY);
+        if (fd < 0) {
+            throw SnapshotError("Cannot open snapshot " + path);
+        }
+        struct stat file_stat {};
+        if (fstat(fd, &file_stat) != 0) {
+            close(fd);
+            throw SnapshotError("Cannot stat snapshot " + path);
+        }
+        size_ = static_cast<size_t>(file_stat.st_size);
+        if (size_ > 0) {
+            void *mapped = mmap(nullptr, size_, PROT_READ, MAP_PRIVATE, fd, 0);
+            if (mapped == MAP_FAILED) {
+                close(fd);
+                throw SnapshotError("Cannot map snapshot " + path);
+            }
+            data_ = static_cast<const char *>(mapped);
+        }
+        close(fd);
+#else
+        std::ifstream input(path, std::ios::binary);
+        if (!input) {
+            throw SnapshotError("Cannot open snapshot " + path);
+        }
+        buffer_.assign(std::istreambuf_iterator<char>(input), std::istreambuf_iterator<char>());
+        data_ = buffer_.data();
+        size_ = buffer_.size();
+#endif
+    }
+
+    MappedFile(const MappedFile &) = delete;
+    MappedFile &operator=(const MappedFile &) = delete;
+
+    ~MappedFile() {
+#ifdef SNAPSHOT_HAS_MMAP
+        if (data_) {
+            munmap(const_cast<char *>(data_), size_);
+        }
+#endif
+    }
+
+    const char *GetData() const {
+        return data_;
+    }
+
+    size_t GetSize() const {
+        return size_;
+    }
+
+private:
+    const char *data_ = nullptr;
+    size_t size_ = 0;
+#ifndef SNAPSHOT_HAS_MMAP
+    std::vector<char> buffer_;
+#endif
+};
+
+void WritePoint(SnapshotWriter &writer, const svg::Point &point) {
+    writer.Write(point.x);
+    writer.Write(point.y);
+}
+
+svg::Point ReadPoint(SnapshotReader &reader) {
+    const double x = reader.Read<double>();
+    const double y = reader.Read<double>();
+    return {x, y};
+}
+
+void WriteColor(SnapshotWriter &writer, const svg::Color &color) {
+    if (const auto *name = std::get_if<std::string>(&color)) {
+        writer.Write(ColorTag::STRING);
+        writer.WriteString(*name);
+    } else if (const auto *rgb = std::get_if<svg::Rgb>(&color)) {
+        writer.Write(ColorTag::RGB);
+        writer.Write(rgb->red);
+        writer.Write(rgb->green);
+        writer.Write(rgb->blue);
+    } else if (const auto *rgba = std::get_if<svg::Rgba>(&color)) {
+        writer.Write(ColorTag::RGBA);
+        writer.Write(rgba->red);
+        writer.Write(rgba->green);
+        writer.Write(rgba->blue);
+        writer.Write(rgba->opacity);
+    } else {
+        writer.Write(ColorTag::NONE);
+    }
+}
+
+svg::Color ReadColor(SnapshotReader &reader) {
+    switch (reader.Read<ColorTag>()) {
+    case ColorTag::NONE:
+        return std::monostate{};
+    case ColorTag::STRING:
+        return std::string(reader.ReadString());
+    case ColorTag::RGB: {
+        const auto red = reader.Read<uint8_t>();
+        const auto green = reader.Read<uint8_t>();
+        const auto blue = reader.Read<uint8_t>();
+        return svg::Rgb(red, green, blue);
+    }
+    case ColorTag::RGBA: {
+        const auto red = reader.Read<uint8_t>();
+        const auto green = reader.Read<uint8_t>();
+        const auto blue = reader.Read<uint8_t>();
+        const auto opacity = reader.Read<double>();
+        return svg::Rgba(red, green, blue, opacity);
+    }
+    }
+    throw SnapshotError("Unknown color tag in snapshot");
+}
+
+void WriteRenderSets(SnapshotWriter &writer, const RenderSets &render_sets) {
+    writer.Write(render_sets.width);
+    writer.Write(render_sets.height);
+    writer.Write(render_sets.padding);
+    writer.Write(render_sets.stop_radius);
+    writer.Write(render_sets.line_width);
+    writer.Write<int32_t>(render_sets.bus_label_font_size);
+    WritePoint(writer, render_sets.bus_label_offset);
+    writer.Write<int32_t>(render_sets.stop_label_font_size);
+    WritePoint(writer, render_sets.stop_label_offset);
+    WriteColor(writer, render_sets.underlayer_color);
+    writer.Write(render_sets.underlayer_width);
+    writer.Write<uint64_t>(render_sets.color_palette.size());
+    for (const auto &color : render_sets.color_palette) {
+        WriteColor(writer, color);
+    }
+}
+
+RenderSets ReadRenderSets(SnapshotReader &reader) {
+    RenderSets render_sets;
+    render_sets.width = reader.Read<double>();
+    render_sets.height = reader.Read<double>();
+    render_sets.padding = reader.Read<double>();
+    render_sets.stop_radius = reader.Read<double>();
+    render_sets.line_width = reader.Read<double>();
+    render_sets.bus_label_font_size = reader.Read<int32_t>();
+    render_sets.bus_label_offset = ReadPoint(reader);
+    render_sets.stop_label_font_size = reader.Read<int32_t>();
+    render_sets.stop_label_offset = ReadPoint(reader);
+    render_sets.underlayer_color = ReadColor(reader);
+    render_sets.underlayer_width = reader.Read<double>();
+    const auto palette_size = reader.Read<uint64_t>();
+    for (uint64_t i = 0; i < palette_size; ++i) {
+        render_sets.color_palette.push_back(ReadColor(reader));
+    }
+    return render_sets;
+}
+
+void WriteCatalogue(SnapshotWriter &writer, const TransportCatalogue &db) {
+    // остановки в порядке id, чтобы при загрузке id совпали
+    writer.Write<uint64_t>(db.GetStopCount());
+    for (domain::StopId stop_id = 0; stop_id < db.GetStopCount(); ++stop_id) {
+        const auto coordinates = db.GetStopCoordinates(stop_id);
+        writer.WriteString(db.GetStop(stop_id).name);
+        writer.Write(coordinates.lat);
+        writer.Write(coordinates.lng);
+        writer.Write(db.GetTransferTime(stop_id));
+    }
+    // маршруты по имени, чтобы файл не зависел от порядка обхода хеш-таблицы
+    std::vector<const domain::Bus *> buses;
+    for (const auto &[name, bus] : db.GetAllRoutes()) {
+        buses.push_back(bus);
+    }
+    std::sort(buses.begin(), buses.end(), [](const domain::Bus *lhs, const domain::Bus *rhs) {
+        return lhs->bus_route < rhs->bus_route;
+    });
+    writer.Write<uint64_t>(buses.size());
+    for (const auto *bus : buses) {
+        writer.WriteString(bus->bus_route);
+        writer.Write<uint8_t>(bus->is_roundtrip);
+        std::vector<domain::StopId> stop_ids;
+        stop_ids.reserve(bus->stops.size());
+        for (const auto *stop : bus->stops) {
+            stop_ids.push_back(stop->id);
+        }
+        writer.WriteArray(stop_ids.data(), stop_ids.size());
+        writer.Write<uint8_t>(bus->schedule.has_value());
+        if (bus->schedule) {
+            writer.Write(bus->schedule->first_departure);
+            writer.Write(bus->schedule->last_departure);
+            writer.Write(bus->schedule->headway);
+        }
+    }
+    writer.Write<uint64_t>(db.GetAllDistances().size());
+    for (const auto &[stops, distance] : db.GetAllDistances()) {
+        writer.Write(stops.first->id);
+        writer.Write(stops.second->id);
+        writer.Write(distance);
+    }
+}
+
+void ReadCatalogue(SnapshotReader &reader, TransportCatalogue &db) {
+    const auto stops_count = reader.Read<uint64_t>();
+    for (uint64_t i = 0; i < stops_count; ++i) {
+        const auto name = reader.ReadString();
+        const auto lat = reader.Read<double>();
+        const auto lng = reader.Read<double>();
+        const auto transfer_time = reader.Read<double>();
+        db.AddStop(name, {lat, lng});
+        if (transfer_time != 0.) {
+            db.SetTransferTime(name, transfer_time);
+        }
+    }
+    const auto stop_name = [&db](domain::StopId stop_id) {
+        if (stop_id >= db.GetStopCount()) {
+            throw SnapshotError("Snapshot refers to unknown stop");
+        }
+        return db.GetStop(stop_id).name;
+    };
+    const auto buses_count = reader.Read<uint64_t>();
+    for (uint64_t i = 0; i < buses_count; ++i) {
+        const auto name = reader.ReadString();
+        const bool is_roundtrip = reader.Read<uint8_t>() != 0;
+        size_t route_size = 0;
+        const char *route_data = reader.ReadArray<domain::StopId>(route_size);
+        std::vector<std::string_view> route(route_size);
+        for (size_t j = 0; j < route_size; ++j) {
+            domain::StopId stop_id;
+            std::memcpy(&stop_id, route_data + j * sizeof(domain::StopId), sizeof(domain::StopId));
+            route[j] = stop_name(stop_id);
+        }
+        db.AddBus(name, route, is_roundtrip);
+        if (reader.Read<uint8_t>() != 0) {
+            domain::BusSchedule schedule;
+            schedule.first_departure = reader.Read<double>();
+            schedule.last_departure = reader.Read<double>();
+            schedule.headway = reader.Read<double>();
+            db.SetBusSchedule(name, schedule);
+        }
+    }
+    const auto distances_count = reader.Read<uint64_t>();
+    for (uint64_t i = 0; i < distances_count; ++i) {
+        const auto from = reader.Read<domain::StopId>();
+        const auto to = reader.Read<domain::StopId>();
+        const auto distance = reader.Read<double>();
+        db.SetDistance(stop_name(from), stop_name(to), distance);
+    }
+}
+
+// ячейки таблицы маршрутов внутри содержимого снимка
+struct TableSection {
+    size_t offset = 0;
+    size_t size = 0;
+};
+
+TableSection WriteRouter(SnapshotWriter &writer, const TransportCatalogue &db, const router::TransportRouter &router) {
+    writer.Write<int32_t>(router.GetBusWaitTime());
+    writer.Write(router.GetBusVelocity());
+    const auto &stop_vertices = router.GetStopVertices();
+    std::vector<uint64_t> vertices(stop_vertices.begin(), stop_vertices.end());
+    writer.WriteArray(vertices.data(), vertices.size());
+
+    // имена рёбер сохраняются как id в таблице имён каталога
+    const auto &names = db.GetNamePool();
+    writer.Write<uint64_t>(names.GetNameCount());
+    for (domain::NameId name_id = 0; name_id < names.GetNameCount(); ++name_id) {
+        writer.WriteString(names.GetName(name_id));
+    }
+    const auto &graph = router.GetGraph();
+    writer.Write<uint64_t>(graph.GetVertexCount());
+    writer.Write<uint64_t>(graph.GetEdgeCount());
+    for (graph::EdgeId edge_id = 0; edge_id < graph.GetEdgeCount(); ++edge_id) {
+        const auto &edge = graph.GetEdge(edge_id);
+        const auto name_id = names.Find(edge.name);
+        if (!name_id) {
+            throw std::logic_error("Graph edge name is missing from the name table");
+        }
+        writer.Write<uint32_t>(*name_id);
+        writer.Write<uint64_t>(edge.span);
+        writer.Write<uint64_t>(edge.from);
+        writer.Write<uint64_t>(edge.to);
+        writer.Write(edge.weight);
+        writer.Write<uint8_t>(graph.IsEdgeRemoved(edge_id));
+    }
+
+    // способ поиска без таблицы и наличие разметки; ориентиры и метки строятся при загрузке
+    writer.Write(static_cast<uint8_t>(router.GetRouteSearch()));
+    writer.Write<uint8_t>(router.HasHubLabels());
+
+    // таблица маршрутизатора по строкам, V * V ячеек; без таблицы (предел памяти) - пустой массив
+    if (router.HasRoutesTable()) {
+        const auto &routes_data = router.GetRouter().GetRoutesInternalData();
+        const size_t offset = writer.WriteAlignedArray(routes_data.GetCells(), routes_data.GetCellCount());
+        return {offset, routes_data.GetCellCount() * sizeof(RouteCell)};
+    }
+    return {writer.WriteAlignedArray(static_cast<const RouteCell *>(nullptr), 0), 0};
+}
+
+// file - отображённый снимок, таблица маршрутов читается из него без копирования и держит его в памяти.
+// table - где заголовок помещает ячейки таблицы; с verify_table проверяются id рёбер во всех ячейках
+std::unique_ptr<router::TransportRouter> ReadRouter(SnapshotReader &reader, const TransportCatalogue &db,
+                                                    const std::shared_ptr<const MappedFile> &file, const char *table,
+                                                    size_t table_size, bool verify_table) {
+    const auto wait_time = reader.Read<int32_t>();
+    const auto velocity = reader.Read<double>();
+    size_t stops_count = 0;
+    const char *vertices_data = reader.ReadArray<uint64_t>(stops_count);
+    std::vector<uint64_t> stored_stop_vertices(stops_count);
+    std::memcpy(stored_stop_vertices.data(), vertices_data, stops_count * sizeof(uint64_t));
+
+    // имена из снимка сопоставляются с таблицей имён загруженного каталога.
+    // Имён удалённых маршрутов в каталоге нет, на них могут ссылаться только удалённые рёбра
+    const auto names_count = reader.Read<uint64_t>();
+    std::vector<std::optional<std::string_view>> names(names_count);
+    for (auto &name : names) {
+        const auto name_id = db.GetNamePool().Find(reader.ReadString());
+        if (name_id) {
+            name = db.GetNamePool().GetName(*name_id);
+        }
+    }
+    const auto vertex_count = static_cast<size_t>(reader.Read<uint64_t>());
+    const auto edge_count = reader.Read<uint64_t>();
+    // у остановки вершина ожидания и следующая за ней вершина поездки
+    std::vector<graph::VertexId> stop_vertices;
+    stop_vertices.reserve(stops_count);
+    for (const uint64_t vertex : stored_stop_vertices) {
+        if (vertex >= vertex_count || vertex + 1 >= vertex_count) {
+            throw SnapshotError("Snapshot stop vertices do not match the graph");
+        }
+        stop_vertices.push_back(static_cast<graph::VertexId>(vertex));
+    }
+    graph::DirectedWeightedGraph<double> graph(vertex_count);
+    for (uint64_t i = 0; i < edge_count; ++i) {
+        const auto name_id = reader.Read<uint32_t>();
+        const auto span = reader.Read<uint64_t>();
+        const auto from = reader.Read<uint64_t>();
+        const auto to = reader.Read<uint64_t>();
+        const auto weight = reader.Read<double>();
+        const bool removed = reader.Read<uint8_t>() != 0;
+        if (name_id >= names.size() || from >= vertex_count || to >= vertex_count) {
+            throw SnapshotError("Snapshot graph is corrupted");
+        }
+        if (!names[name_id] && !removed) {
+            throw SnapshotError("Snapshot name table does not match the catalogue");
+        }
+        // удалённые рёбра сохраняются, чтобы id остальных рёбер в таблице маршрутов не сдвинулись
+        const auto edge_id = graph.AddEdge({names[name_id].value_or(std::string_view{}), static_cast<size_t>(span), static_cast<graph::VertexId>(from),
+                                            static_cast<graph::VertexId>(to), weight});
+        if (removed) {
+            graph.RemoveEdge(edge_id);
+        }
+    }
+
+    const auto search = reader.Read<uint8_t>();
+    if (search > static_cast<uint8_t>(router::RouteSearch::BIDIRECTIONAL)) {
+        throw SnapshotError("Snapshot route search is unknown");
+    }
+    const bool hub_labels = reader.Read<uint8_t>() != 0;
+
+    size_t cells_count = 0;
+    const RouteCell *cells = reader.ReadAlignedArray<RouteCell>(cells_count);
+    if (reinterpret_cast<const char *>(cells) != table || cells_count * sizeof(RouteCell) != table_size) {
+        throw SnapshotError("Snapshot routing table does not match the header");
+    }
+    if (cells_count == 0 && vertex_count > 0) {
+        return std::make_unique<router::TransportRouter>(db, wait_time, velocity, std::move(graph), std::move(stop_vertices),
+                                                         graph::Router<double>::RoutesInternalData{},
+                                                         static_cast<router::RouteSearch>(search), hub_labels);
+    }
+    if (cells_count != vertex_count * vertex_count) {
+        throw SnapshotError("Snapshot routing table does not match the graph");
+    }
+    // Без verify_table ячейки не копируются и не читаются, чтобы загрузка не касалась всех страниц таблицы.
+    // Их id последних рёбер тогда проверяет граф при восстановлении маршрута (GetEdge бросает std::out_of_range)
+    if (verify_table) {
+        const bool edges_valid = std::all_of(cells, cells + cells_count, [edge_count](const RouteCell &cell) {
+            return cell.prev_edge == graph::Router<double>::NO_EDGE || cell.prev_edge < edge_count;
+        });
+        if (!edges_valid) {
+            throw SnapshotError("Snapshot routing table refers to a missing edge");
+        }
+    }
+    graph::Router<double>::RoutesInternalData routes_data(vertex_count, cells, file);
+    return std::make_unique<router::TransportRouter>(db, wait_time, velocity, std::move(graph),
+                                                     std::move(stop_vertices), std::move(routes_data),
+                                                     static_cast<router::RouteSearch>(search), hub_labels);
+}
+
+} // namespace
+
+void SaveSnapshot(const std::string &path, const TransportCatalogue &db, const router::TransportRouter &router,
+                  const RenderSets &render_sets) {
+    SnapshotWriter writer;
+    WriteCatalogue(writer, db);
+    const TableSection table = WriteRouter(writer, db, router);
+    WriteRenderSets(writer, render_sets);
+    const auto &payload = writer.GetBuffer();
+
+    SnapshotHeader header{};
+    std::memcpy(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC));
+    header.version = SNAPSHOT_VERSION;
+    header.byte_order = BYTE_ORDER_MARK;
+    header.payload_size = payload.size();
+    header.checksum = ComputeChecksumWithoutTable(payload.data(), payload.size(), table.offset, table.size);
+    header.table_offset = table.offset;
+    header.table_size = table.size;
+    header.table_checksum = ComputeChecksum(payload.data() + table.offset, table.size);
+
+    std::ofstream output(path, std::ios::binary | std::ios::trunc);
+    output.write(reinterpret_cast<const char *>(&header), sizeof(header));
+    output.write(payload.data(), static_cast<std::streamsize>(payload.size()));
+    if (!output) {
+        throw std::runtime_error("Cannot write snapshot " + path);
+    }
+}
+
+std::unique_ptr<TransportBase> LoadSnapshot(const std::string &path, bool verify_table) {
+    const auto file_holder = std::make_shared<const MappedFile>(path);
+    const MappedFile &file = *file_holder;
+    if (file.GetSize() < sizeof(SnapshotHeader)) {
+        throw SnapshotError("Snapshot is truncated");
+    }
+    SnapshotHeader header;
+    std::memcpy(&header, file.GetData(), sizeof(header));
+    if (std::memcmp(header.magic, SNAPSHOT_MAGIC, sizeof(SNAPSHOT_MAGIC)) != 0) {
+        throw SnapshotError("Not a transport catalogue snapshot");
+    }
+    if (header.byte_order != BYTE_ORDER_MARK) {
+        throw SnapshotError("Snapshot was written on a machine with different byte order");
+    }
+    if (header.version != SNAPSHOT_VERSION) {
+        throw SnapshotError("Unsupported snapshot version " + std::to_string(header.version));
+    }
+    const char *payload = file.GetData() + sizeof(header);
+    if (header.payload_size != file.GetSize() - sizeof(header)) {
+        throw SnapshotError("Snapshot is truncated");
+    }
+    if (header.table_offset > header.payload_size || header.table_size > header.payload_size - header.table_offset) {
+        throw SnapshotError("Snapshot routing table is out of the payload");
+    }
+    const auto table_offset = static_cast<size_t>(header.table_offset);
+    const auto table_size = static_cast<size_t>(header.table_size);
+    if (ComputeChecksumWithoutTable(payload, header.payload_size, table_offset, table_size) != header.checksum) {
+        throw SnapshotError("Snapshot checksum mismatch");
+    }
+    if (verify_table && ComputeChecksum(payload + table_offset, table_size) != header.table_checksum) {
+        throw SnapshotError("Snapshot routing table checksum mismatch");
+    }
+
+    SnapshotReader reader(payload, header.payload_size);
+    auto base = std::make_unique<TransportBase>();
+    ReadCatalogue(reader, base->catalogue);
+    base->catalogue.RefreshStatistics();
+    base->router = ReadRouter(reader, base->catalogue, file_holder, payload + table_offset, table_size, verify_table);
+    base->render_sets = ReadRenderSets(reader);
+    if (!reader.AtEnd()) {
+        throw SnapshotError("Unexpected data at the end of snapshot");
+    }
+    return base;
+}
+
+} // namespace serialization
@@ -0,0 +1,43 @@
+#pragma once
+
+#include <cstdint>
+#include <memory>
+#include <stdexcept>
+#include <string>
+
+#include "map_renderer.h"
+#include "transport_catalogue.h"
+#include "transport_router.h"
+
+namespace serialization {
+
+// Версия бинарного формата снимка, увеличивается при любом изменении раскладки
+inline constexpr uint32_t SNAPSHOT_VERSION = 7;
+
+// Ошибка чтения снимка: файл повреждён, обрезан или записан другой версией формата
+class SnapshotError : public std::runtime_error {
+public:
+    using runtime_error::runtime_error;
+};
+
+// Полностью построенная база, восстановленная из снимка.
+// Маршрутизатор ссылается на каталог, поэтому оба объекта живут вместе
+struct TransportBase {
+    TransportCatalogue catalogue;
+    std::unique_ptr<router::TransportRouter> router;
+    RenderSets render_sets;
+};
+
+// Сохраняет остановки, маршруты с расписаниями, расстояния, граф, предрасчёт маршрутизатора, способ поиска маршрутов
+// без таблицы, наличие разметки и настройки отрисовки
+void SaveSnapshot(const std::string &path, const TransportCatalogue &db, const router::TransportRouter &router,
+                  const RenderSets &render_sets);
+
+// Загружает снимок, отображая файл в память (mmap); граф и таблица маршрутов не пересчитываются,
+// ориентиры ALT и разметка строятся по графу заново.
+// Таблица маршрутов не копируется и при загрузке не читается: маршрутизатор читает её прямо из отображения
+// и держит его, пока жив. Контрольная сумма и проверки диапазонов покрывают остальное содержимое, а ячейки
+// таблицы проверяются (своя контрольная сумма и id рёбер) только с verify_table
+std::unique_ptr<TransportBase> LoadSnapshot(const std::string &path, bool verify_table = false);
+
+} // namespace serialization
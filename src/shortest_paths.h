@@ -0,0 +1,388 @@
+#pragma once
+
+#include "graph.h"
+
+#include <algorithm>
+#include <cstdint>
+#include <functional>
+#include <limits>
+#include <optional>
+#include <utility>
+#include <vector>
+
+namespace graph {
+
+// Поиск Дейкстры из одной вершины до набора целей. Поиск останавливается, как только все цели достигнуты;
+// пути до целей восстанавливаются после запуска по запомненным рёбрам. Рабочие массивы сохраняются
+// между запусками и не обнуляются: актуальность значения определяется отметкой номера запуска
+template <typename Weight>
+class OneToManySearch {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteEdges = std::vector<std::pair<EdgeId, const Edge<Weight>*>>;
+
+    explicit OneToManySearch(const Graph& graph)
+        : graph_(graph)
+        , distances_(graph.GetVertexCount())
+        , prev_edges_(graph.GetVertexCount())
+        , reached_marks_(graph.GetVertexCount(), 0)
+        , target_marks_(graph.GetVertexCount(), 0) {
+    }
+
+    // result[i] - кратчайшее расстояние до targets[i], std::nullopt если цель недостижима
+    void Run(VertexId source, const std::vector<VertexId>& targets, std::vector<std::optional<Weight>>& result) {
+        NextRun();
+        size_t targets_left = 0;
+        for (const VertexId target : targets) {
+            if (target_marks_[target] != run_) {
+                target_marks_[target] = run_;
+                ++targets_left;
+            }
+        }
+        SetDistance(source, Weight{}, std::nullopt);
+        heap_.clear();
+        heap_.push_back({Weight{}, source});
+        while (!heap_.empty() && targets_left > 0) {
+            std::pop_heap(heap_.begin(), heap_.end(), std::greater<>{});
+            const auto [weight, vertex] = heap_.back();
+            heap_.pop_back();
+            if (distances_[vertex] < weight) {
+                continue;
+            }
+            // вершина извлекается с окончательным расстоянием один раз: повторы отсекает проверка выше
+            if (target_marks_[vertex] == run_) {
+                target_marks_[vertex] = 0;
+                --targets_left;
+            }
+            for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                const auto& edge = graph_.GetEdge(edge_id);
+                const Weight candidate = weight + edge.weight;
+                if (reached_marks_[edge.to] != run_ || candidate < distances_[edge.to]) {
+                    SetDistance(edge.to, candidate, edge_id);
+                    heap_.push_back({candidate, edge.to});
+                    std::push_heap(heap_.begin(), heap_.end(), std::greater<>{});
+                }
+            }
+        }
+        result.resize(targets.size());
+        for (size_t i = 0; i < targets.size(); ++i) {
+            result[i] = reached_marks_[targets[i]] == run_ ? std::optional<Weight>(distances_[targets[i]]) : std::nullopt;
+        }
+    }
+
+    // Рёбра кратчайшего пути от источника последнего запуска до его цели target в порядке поездки записываются
+    // в edges, возвращается вес пути; std::nullopt и пустой edges, если цель недостижима
+    std::optional<Weight> BuildRoute(VertexId target, RouteEdges& edges) const {
+        edges.clear();
+        if (reached_marks_[target] != run_) {
+            return std::nullopt;
+        }
+        for (std::optional<EdgeId> edge_id = prev_edges_[target]; edge_id; edge_id = prev_edges_[graph_.GetEdge(*edge_id).from]) {
+            edges.emplace_back(*edge_id, &graph_.GetEdge(*edge_id));
+        }
+        std::reverse(edges.begin(), edges.end());
+        return distances_[target];
+    }
+
+private:
+    const Graph& graph_;
+    std::vector<Weight> distances_;
+    std::vector<std::optional<EdgeId>> prev_edges_;
+    std::vector<uint32_t> reached_marks_;
+    std::vector<uint32_t> target_marks_;
+    std::vector<std::pair<Weight, VertexId>> heap_;
+    uint32_t run_ = 0;
+
+    void SetDistance(VertexId vertex, Weight weight, std::optional<EdgeId> prev_edge) {
+        distances_[vertex] = weight;
+        prev_edges_[vertex] = prev_edge;
+        reached_marks_[vertex] = run_;
+    }
+
+    void NextRun() {
+        // при переполнении счётчика старые отметки могли бы совпасть с новыми
+        if (++run_ == 0) {
+            std::fill(reached_marks_.begin(), reached_marks_.end(), 0);
+            std::fill(target_marks_.begin(), target_marks_.end(), 0);
+            run_ = 1;
+        }
+    }
+};
+
+// Поиск Дейкстры между двумя вершинами с восстановлением пути - замена таблицы маршрутов,
+// когда она не помещается в память. Поиск останавливается, как только извлечена цель.
+// Рабочие массивы, как и в OneToManySearch, не обнуляются между запусками
+template <typename Weight>
+class PointToPointSearch {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteEdges = std::vector<std::pair<EdgeId, const Edge<Weight>*>>;
+
+    explicit PointToPointSearch(const Graph& graph)
+        : graph_(graph)
+        , distances_(graph.GetVertexCount())
+        , prev_edges_(graph.GetVertexCount())
+        , potentials_(graph.GetVertexCount())
+        , reached_marks_(graph.GetVertexCount(), 0) {
+    }
+
+    // Рёбра кратчайшего пути в порядке поездки записываются в edges (если передан), возвращается его вес;
+    // std::nullopt и пустой edges, если to недостижима
+    std::optional<Weight> Run(VertexId from, VertexId to, RouteEdges* edges) {
+        return Run(from, to, edges, [](VertexId) {
+            return Weight{};
+        });
+    }
+
+    // Поиск A*: вершины извлекаются по расстоянию от from плюс потенциал potential(v) - нижней оценке расстояния
+    // от v до to. Оценка должна быть согласованной: potential(u) <= w(u, v) + potential(v) для каждого ребра
+    // и potential(to) == 0, тогда найденный путь кратчайший, а вершина извлекается окончательно один раз.
+    // Бесконечная оценка означает, что to из v недостижима. Чем точнее оценка, тем меньше вершин извлекается;
+    // нулевая оценка - обычная Дейкстра
+    template <typename Potential>
+    std::optional<Weight> Run(VertexId from, VertexId to, RouteEdges* edges, const Potential& potential) {
+        if (edges) {
+            edges->clear();
+        }
+        NextRun();
+        settled_count_ = 0;
+        Reach(from, Weight{}, std::nullopt);
+        potentials_[from] = potential(from);
+        if (IsInfinite(potentials_[from])) {
+            return std::nullopt;
+        }
+        heap_.clear();
+        heap_.push_back({potentials_[from], from});
+        bool found = false;
+        while (!heap_.empty()) {
+            std::pop_heap(heap_.begin(), heap_.end(), std::greater<>{});
+            const auto [key, vertex] = heap_.back();
+            heap_.pop_back();
+            // потенциал вершины за запуск считается один раз, поэтому устаревшая запись видна по ключу
+            if (distances_[vertex] + potentials_[vertex] < key) {
+                continue;
+            }
+            ++settled_count_;
+            if (vertex == to) {
+                found = true;
+                break;
+            }
+            const Weight weight = distances_[vertex];
+            for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                const auto& edge = graph_.GetEdge(edge_id);
+                const Weight candidate = weight + edge.weight;
+                const bool first_reach = reached_marks_[edge.to] != run_;
+                if (first_reach || candidate < distances_[edge.to]) {
+                    if (first_reach) {
+                        potentials_[edge.to] = potential(edge.to);
+                    }
+                    Reach(edge.to, candidate, edge_id);
+                    // бесконечный потенциал - цель из вершины недостижима, в очередь она не ставится
+                    if (IsInfinite(potentials_[edge.to])) {
+                        continue;
+                    }
+                    heap_.push_back({candidate + potentials_[edge.to], edge.to});
+                    std::push_heap(heap_.begin(), heap_.end(), std::greater<>{});
+                }
+            }
+        }
+        if (!found) {
+            return std::nullopt;
+        }
+        if (edges) {
+            for (std::optional<EdgeId> edge_id = prev_edges_[to]; edge_id; edge_id = prev_edges_[graph_.GetEdge(*edge_id).from]) {
+                edges->emplace_back(*edge_id, &graph_.GetEdge(*edge_id));
+            }
+            std::reverse(edges->begin(), edges->end());
+        }
+        return distances_[to];
+    }
+
+    // число вершин, извлечённых из очереди последним запуском (с целью, если она найдена)
+    size_t GetSettledCount() const {
+        return settled_count_;
+    }
+
+private:
+    const Graph& graph_;
+    std::vector<Weight> distances_;
+    std::vector<std::optional<EdgeId>> prev_edges_;
+    // потенциалы достигнутых в текущем запуске вершин
+    std::vector<Weight> potentials_;
+    std::vector<uint32_t> reached_marks_;
+    std::vector<std::pair<Weight, VertexId>> heap_;
+    uint32_t run_ = 0;
+    size_t settled_count_ = 0;
+
+    void Reach(VertexId vertex, Weight weight, std::optional<EdgeId> prev_edge) {
+        distances_[vertex] = weight;
+        prev_edges_[vertex] = prev_edge;
+        reached_marks_[vertex] = run_;
+    }
+
+    static bool IsInfinite(Weight weight) {
+        if constexpr (std::numeric_limits<Weight>::has_infinity) {
+            return weight == std::numeric_limits<Weight>::infinity();
+        } else {
+            return false;
+        }
+    }
+
+    void NextRun() {
+        if (++run_ == 0) {
+            std::fill(reached_marks_.begin(), reached_marks_.end(), 0);
+            run_ = 1;
+        }
+    }
+};
+
+// Двунаправленный поиск Дейкстры между двумя вершинами: прямой поиск из from по исходящим рёбрам и обратный
+// из to по входящим (DirectedWeightedGraph::GetIncomingEdges) расширяются по очереди - та сторона, у которой
+// меньше ключ в начале очереди. При каждом улучшении вершины, достигнутой обоими поисками, обновляется лучший
+// путь через неё. Поиск останавливается, когда сумма ключей в начале очередей не меньше лучшего пути: любой
+// не найденный путь длиннее. Каждый поиск обходит шар примерно вдвое меньшего радиуса, чем одиночная Дейкстра.
+// Рабочие массивы, как и в OneToManySearch, не обнуляются между запусками
+template <typename Weight>
+class BidirectionalSearch {
+private:
+    using Graph = DirectedWeightedGraph<Weight>;
+
+public:
+    using RouteEdges = std::vector<std::pair<EdgeId, const Edge<Weight>*>>;
+
+    explicit BidirectionalSearch(const Graph& graph)
+        : graph_(graph)
+        , forward_(graph.GetVertexCount())
+        , backward_(graph.GetVertexCount()) {
+    }
+
+    // Рёбра кратчайшего пути в порядке поездки записываются в edges (если передан), возвращается его вес -
+    // сумма весов рёбер в порядке поездки, как у PointToPointSearch; std::nullopt и пустой edges, если to недостижима
+    std::optional<Weight> Run(VertexId from, VertexId to, RouteEdges* edges) {
+        if (edges) {
+            edges->clear();
+        }
+        if (++run_ == 0) {
+            forward_.ResetMarks();
+            backward_.ResetMarks();
+            run_ = 1;
+        }
+        settled_count_ = 0;
+        forward_.Start(from, run_);
+        backward_.Start(to, run_);
+        std::optional<VertexId> meeting;
+        Weight best{};
+        if (from == to) {
+            meeting = from;
+        }
+        while (!forward_.heap.empty() && !backward_.heap.empty()) {
+            // граница: дальше пути не короче суммы ключей в начале очередей
+            if (meeting && !(forward_.heap.front().first + backward_.heap.front().first < best)) {
+                break;
+            }
+            const bool forward_step = !(backward_.heap.front().first < forward_.heap.front().first);
+            Side& side = forward_step ? forward_ : backward_;
+            Side& other = forward_step ? backward_ : forward_;
+            std::pop_heap(side.heap.begin(), side.heap.end(), std::greater<>{});
+            const auto [weight, vertex] = side.heap.back();
+            side.heap.pop_back();
+            if (side.distances[vertex] < weight) {
+                continue;
+            }
+            ++settled_count_;
+            const auto relax = [&](EdgeId edge_id, VertexId next) {
+                const Weight candidate = weight + graph_.GetEdge(edge_id).weight;
+                if (side.reached_marks[next] != run_ || candidate < side.distances[next]) {
+                    side.Reach(next, candidate, edge_id, run_);
+                    side.heap.push_back({candidate, next});
+                    std::push_heap(side.heap.begin(), side.heap.end(), std::greater<>{});
+                    if (other.reached_marks[next] == run_) {
+                        const Weight length = candidate + other.distances[next];
+                        if (!meeting || length < best) {
+                            meeting = next;
+                            best = length;
+                        }
+                    }
+                }
+            };
+            if (forward_step) {
+                for (const EdgeId edge_id : graph_.GetIncidentEdges(vertex)) {
+                    relax(edge_id, graph_.GetEdge(edge_id).to);
+                }
+            } else {
+                for (const EdgeId edge_id : graph_.GetIncomingEdges(vertex)) {
+                    relax(edge_id, graph_.GetEdge(edge_id).from);
+                }
+            }
+        }
+        if (!meeting) {
+            return std::nullopt;
+        }
+        // прямая часть - от встречи назад к from, обратная - от встречи вперёд к to
+        if (edges) {
+            for (std::optional<EdgeId> edge_id = forward_.prev_edges[*meeting]; edge_id;
+                 edge_id = forward_.prev_edges[graph_.GetEdge(*edge_id).from]) {
+                edges->emplace_back(*edge_id, &graph_.GetEdge(*edge_id));
+            }
+            std::reverse(edges->begin(), edges->end());
+        }
+        Weight weight = forward_.distances[*meeting];
+        for (std::optional<EdgeId> edge_id = backward_.prev_edges[*meeting]; edge_id;
+             edge_id = backward_.prev_edges[graph_.GetEdge(*edge_id).to]) {
+            const auto& edge = graph_.GetEdge(*edge_id);
+            weight += edge.weight;
+            if (edges) {
+                edges->emplace_back(*edge_id, &edge);
+            }
+        }
+        return weight;
+    }
+
+    // число вершин, извлечённых из очередей обоих поисков последним запуском
+    size_t GetSettledCount() const {
+        return settled_count_;
+    }
+
+private:
+    // состояние поиска одного направления; prev_edges - ребро к предыдущей вершине пути от начала поиска
+    struct Side {
+        std::vector<Weight> distances;
+        std::vector<std::optional<EdgeId>> prev_edges;
+        std::vector<uint32_t> reached_marks;
+        std::vector<std::pair<Weight, VertexId>> heap;
+
+        explicit Side(size_t vertex_count)
+            : distances(vertex_count)
+            , prev_edges(vertex_count)
+            , reached_marks(vertex_count, 0) {
+        }
+
+        void Reach(VertexId vertex, Weight weight, std::optional<EdgeId> prev_edge, uint32_t run) {
+            distances[vertex] = weight;
+            prev_edges[vertex] = prev_edge;
+            reached_marks[vertex] = run;
+        }
+
+        void Start(VertexId vertex, uint32_t run) {
+            Reach(vertex, Weight{}, std::nullopt, run);
+            heap.clear();
+            heap.push_back({Weight{}, vertex});
+        }
+
+        void ResetMarks() {
+            std::fill(reached_marks.begin(), reached_marks.end(), 0);
+        }
+    };
+
+    const Graph& graph_;
+    Side forward_;
+    Side backward_;
+    uint32_t run_ = 0;
+    size_t settled_count_ = 0;
+};
+
+}  // namespace graph
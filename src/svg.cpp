@@ -87,8 +87,8 @@ Text &Text::SetFontWeight(std::string font_weight) {
     return *this;
 }
 
-Text &Text::SetData(std::string data) {
-    data_ = std::move(data);
+Text &Text::SetData(std::string_view data) {
+    data_.assign(data.begin(), data.end());
     return *this;
 }
 
@@ -147,6 +147,10 @@ void Document::AddPtr(std::unique_ptr<Object> &&obj) {
     objects_ptr_.emplace_back(std::move(obj));
 }
 
+void Document::Clear() {
+    objects_ptr_.clear();
+}
+
 void Document::Render(std::ostream &out) const {
     out << "<?xml version=\"1.0\" encoding=\"UTF-8\" ?>"sv << std::endl;
     out << "<svg xmlns=\"http://www.w3.org/2000/svg\" version=\"1.1\">"sv << std::endl;
@@ -5,6 +5,7 @@
 #include <memory>
 #include <optional>
 #include <string>
+#include <string_view>
 #include <utility>
 #include <variant>
 #include <vector>
@@ -276,7 +277,7 @@ public:
     Text &SetFontWeight(std::string font_weight);
 
     // Задаёт текстовое содержимое объекта (отображается внутри тега text)
-    Text &SetData(std::string data);
+    Text &SetData(std::string_view data);
 
 private:
     void RenderObject(const RenderContext &context) const override;
@@ -303,6 +304,9 @@ public:
     // Выводит в ostream svg-представление документа
     void Render(std::ostream &out) const;
 
+    // Удаляет все объекты документа
+    void Clear();
+
 };
 
 template <typename Object>
@@ -0,0 +1,128 @@
+#include "timetable_router.h"
+
+#include <algorithm>
+#include <limits>
+
+namespace router {
+
+namespace {
+const double INF = std::numeric_limits<double>::infinity();
+const uint32_t NO_CONNECTION = std::numeric_limits<uint32_t>::max();
+} // namespace
+
+TimetableRouter::TimetableRouter(const TransportCatalogue &db, double bus_velocity)
+    : transfer_times_(db.GetStopCount()) {
+    for (domain::StopId stop_id = 0; stop_id < db.GetStopCount(); ++stop_id) {
+        transfer_times_[stop_id] = db.GetTransferTime(stop_id);
+    }
+    // маршруты по имени, чтобы номера рейсов и выбор среди равных по времени поездок не зависели от хеш-таблицы
+    std::vector<const domain::Bus *> buses;
+    for (const auto &[name, bus] : db.GetAllRoutes()) {
+        if (bus->schedule && bus->schedule->headway > 0. && bus->stops.size() > 1) {
+            buses.push_back(bus);
+        }
+    }
+    std::sort(buses.begin(), buses.end(), [](const domain::Bus *lhs, const domain::Bus *rhs) {
+        return lhs->bus_route < rhs->bus_route;
+    });
+
+    // константное значение используется для перевода км/ч в м/мин
+    const double speed_coeff = 100. / 6.;
+    std::vector<double> segment_times;
+    for (const auto *bus : buses) {
+        const auto &stops = bus->stops;
+        segment_times.resize(stops.size());
+        for (size_t k = 1; k < stops.size(); ++k) {
+            segment_times[k] = db.GetDistance(stops[k - 1], stops[k]) / (bus_velocity * speed_coeff);
+        }
+        const auto &schedule = *bus->schedule;
+        // отправления считаются от первого, а не накоплением интервала, чтобы не копить погрешность
+        for (size_t trip_index = 0;; ++trip_index) {
+            const double trip_departure = schedule.first_departure + static_cast<double>(trip_index) * schedule.headway;
+            if (trip_departure > schedule.last_departure) {
+                break;
+            }
+            const auto trip = static_cast<uint32_t>(trip_buses_.size());
+            trip_buses_.push_back(bus->bus_route);
+            double time = trip_departure;
+            for (size_t k = 1; k < stops.size(); ++k) {
+                connections_.push_back({time, time + segment_times[k], stops[k - 1]->id, stops[k]->id, trip, static_cast<uint32_t>(k - 1)});
+                time += segment_times[k];
+            }
+        }
+    }
+    std::stable_sort(connections_.begin(), connections_.end(), [](const Connection &lhs, const Connection &rhs) {
+        return lhs.departure_time < rhs.departure_time
+               || (lhs.departure_time == rhs.departure_time && lhs.arrival_time < rhs.arrival_time);
+    });
+}
+
+TimetableRouter::TimetableRouter(const TimetableRouter &other, const TransportCatalogue &db)
+    : connections_(other.connections_),
+      transfer_times_(other.transfer_times_) {
+    trip_buses_.reserve(other.trip_buses_.size());
+    for (const auto bus_name : other.trip_buses_) {
+        trip_buses_.push_back(db.GetNamePool().GetName(*db.GetNamePool().Find(bus_name)));
+    }
+}
+
+std::optional<TimetableRouter::Journey> TimetableRouter::FindJourney(domain::StopId stop_from, domain::StopId stop_to,
+                                                                     double departure_time) const {
+    // arrival - самое раннее прибытие на остановку, ready - когда с неё можно уехать другим рейсом
+    std::vector<double> arrival(transfer_times_.size(), INF);
+    std::vector<double> ready(transfer_times_.size(), INF);
+    // связь, на которой сели в рейс, и связь, с которой сошли на остановке
+    std::vector<uint32_t> trip_boarding(trip_buses_.size(), NO_CONNECTION);
+    std::vector<std::pair<uint32_t, uint32_t>> stop_leg(transfer_times_.size(), {NO_CONNECTION, NO_CONNECTION});
+    arrival.at(stop_from) = departure_time;
+    ready[stop_from] = departure_time;
+
+    auto first = std::lower_bound(connections_.begin(), connections_.end(), departure_time, [](const Connection &connection, double time) {
+        return connection.departure_time < time;
+    });
+    for (auto it = first; it != connections_.end(); ++it) {
+        const Connection &connection = *it;
+        // прибытие в цель уже не улучшить: все следующие связи отправляются не раньше
+        if (arrival.at(stop_to) <= connection.departure_time) {
+            break;
+        }
+        auto &boarding = trip_boarding[connection.trip];
+        if (boarding == NO_CONNECTION) {
+            if (ready[connection.departure_stop] > connection.departure_time) {
+                continue;
+            }
+            boarding = static_cast<uint32_t>(it - connections_.begin());
+        }
+        if (connection.arrival_time < arrival[connection.arrival_stop]) {
+            arrival[connection.arrival_stop] = connection.arrival_time;
+            ready[connection.arrival_stop] = connection.arrival_time + transfer_times_[connection.arrival_stop];
+            stop_leg[connection.arrival_stop] = {boarding, static_cast<uint32_t>(it - connections_.begin())};
+        }
+    }
+    if (arrival[stop_to] == INF) {
+        return std::nullopt;
+    }
+
+    Journey journey{departure_time, arrival[stop_to], {}};
+    // каждая поездка начинается на остановке с более ранним прибытием, поэтому цепочка конечна
+    for (domain::StopId stop = stop_to; stop != stop_from;) {
+        const auto [boarding, alighting] = stop_leg[stop];
+        const Connection &board = connections_[boarding];
+        const Connection &alight = connections_[alighting];
+        journey.legs.push_back({trip_buses_[board.trip], board.departure_stop, alight.arrival_stop,
+                                alight.segment - board.segment + 1, board.departure_time, alight.arrival_time});
+        stop = board.departure_stop;
+    }
+    std::reverse(journey.legs.begin(), journey.legs.end());
+    return journey;
+}
+
+size_t TimetableRouter::GetConnectionCount() const {
+    return connections_.size();
+}
+
+size_t TimetableRouter::GetTripCount() const {
+    return trip_buses_.size();
+}
+
+} // namespace router
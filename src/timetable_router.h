@@ -0,0 +1,72 @@
+#pragma once
+
+#include "domain.h"
+#include "transport_catalogue.h"
+
+#include <cstdint>
+#include <optional>
+#include <string_view>
+#include <vector>
+
+namespace router {
+
+// Поиск поездки по расписанию с учётом времени отправления (Connection Scan Algorithm).
+// Каждый рейс маршрута с расписанием раскладывается на отрезки между соседними остановками ("связи"),
+// все связи города лежат в одном массиве по возрастанию времени отправления. Запрос - один проход по массиву
+// от времени отправления до момента, когда связи отправляются позже найденного прибытия в цель
+class TimetableRouter {
+public:
+    // поездка на одном рейсе
+    struct Leg {
+        std::string_view bus;
+        domain::StopId from;
+        domain::StopId to;
+        // число проезжаемых отрезков маршрута
+        size_t span;
+        double departure_time;
+        double arrival_time;
+    };
+
+    struct Journey {
+        double departure_time;
+        double arrival_time;
+        // поездки в порядке следования
+        std::vector<Leg> legs;
+    };
+
+    TimetableRouter() = default;
+
+    // bus_velocity - скорость автобусов в км/ч, время в пути между остановками считается по дорожным расстояниям
+    TimetableRouter(const TransportCatalogue &db, double bus_velocity);
+
+    // копия для копии каталога db: имена маршрутов переводятся на таблицу имён db
+    TimetableRouter(const TimetableRouter &other, const TransportCatalogue &db);
+
+    // самое раннее прибытие в stop_to при отправлении из stop_from не раньше departure_time,
+    // std::nullopt если в этот день доехать нельзя
+    std::optional<Journey> FindJourney(domain::StopId stop_from, domain::StopId stop_to, double departure_time) const;
+
+    size_t GetConnectionCount() const;
+
+    size_t GetTripCount() const;
+
+private:
+    // 32 байта, две связи в строке кеша
+    struct Connection {
+        double departure_time;
+        double arrival_time;
+        domain::StopId departure_stop;
+        domain::StopId arrival_stop;
+        uint32_t trip;
+        // номер отрезка в рейсе, по нему считается число проезжаемых отрезков
+        uint32_t segment;
+    };
+
+    std::vector<Connection> connections_;
+    // маршрут каждого рейса
+    std::vector<std::string_view> trip_buses_;
+    // время пересадки, индекс - id остановки
+    std::vector<double> transfer_times_;
+};
+
+} // namespace router
@@ -4,15 +4,83 @@
 #include <iomanip>
 #include <utility>
 
+TransportCatalogue::TransportCatalogue(const TransportCatalogue &other)
+    : stop_lat_(other.stop_lat_),
+      stop_lng_(other.stop_lng_),
+      stop_prepared_(other.stop_prepared_),
+      stop_transfer_times_(other.stop_transfer_times_),
+      updates_(other.updates_) {
+    // имена интернируются в прежнем порядке, поэтому их id в копии те же
+    for (domain::NameId name_id = 0; name_id < other.names_.GetNameCount(); ++name_id) {
+        names_.Intern(other.names_.GetName(name_id));
+    }
+    const auto name = [this, &other](std::string_view other_name) {
+        return other_name.empty() ? other_name : names_.GetName(*other.names_.Find(other_name));
+    };
+    for (const auto &stop : other.stops_list_) {
+        stops_list_.push_back({name(stop.name), stop.id});
+        stopname_to_stop_[stops_list_.back().name] = &stops_list_.back();
+    }
+    const auto stop = [this](const domain::Stop *other_stop) -> const domain::Stop * {
+        return &stops_list_[other_stop->id];
+    };
+    // ячейки маршрутов копируются вместе со свободными, соответствие старых адресов новым нужно для кешей
+    std::unordered_map<const domain::Bus *, domain::Bus *> buses;
+    for (const auto &bus : other.bus_routes_) {
+        std::vector<const domain::Stop *> stops;
+        stops.reserve(bus.stops.size());
+        for (const auto *bus_stop : bus.stops) {
+            stops.push_back(stop(bus_stop));
+        }
+        bus_routes_.push_back({name(bus.bus_route), std::move(stops), bus.is_roundtrip, bus.schedule});
+        buses[&bus] = &bus_routes_.back();
+    }
+    for (const auto &[bus_name, bus] : other.busname_to_bus_) {
+        busname_to_bus_[buses.at(bus)->bus_route] = buses.at(bus);
+    }
+    for (const auto &[stop_name, stop_buses] : other.stopname_to_bus_) {
+        auto &copy_buses = stopname_to_bus_[name(stop_name)];
+        for (const auto *bus : stop_buses) {
+            copy_buses.insert(buses.at(bus));
+        }
+    }
+    for (const auto &[stops, distance] : other.stop_to_stop_dist_) {
+        stop_to_stop_dist_[{stop(stops.first), stop(stops.second)}] = distance;
+    }
+    for (auto *bus : other.free_bus_slots_) {
+        free_bus_slots_.push_back(buses.at(bus));
+    }
+    for (auto &update : updates_) {
+        update.name = name(update.name);
+        update.other_stop_name = name(update.other_stop_name);
+    }
+    for (const auto &[bus, stat] : other.bus_stats_) {
+        bus_stats_.emplace(buses.at(bus), stat);
+    }
+    for (const auto &[other_stop, stop_buses] : other.stop_buses_) {
+        auto &copy_buses = stop_buses_[stop(other_stop)];
+        copy_buses.reserve(stop_buses.size());
+        for (const auto *bus : stop_buses) {
+            copy_buses.push_back(buses.at(bus));
+        }
+    }
+}
+
 // Добавление остановки в базу
-void TransportCatalogue::AddStop(const std::string &stop_name, const geo::Coordinates &coordinate) {
-    stops_list_.push_back({stop_name, coordinate});
-    auto stop_ptr = &stops_list_.back();
-    stopname_to_stop_[stops_list_.back().name] = stop_ptr;
+void TransportCatalogue::AddStop(std::string_view stop_name, const geo::Coordinates &coordinate) {
+    const auto stop_id = static_cast<domain::StopId>(stops_list_.size());
+    const auto name_id = names_.Intern(stop_name);
+    stops_list_.push_back({names_.GetName(name_id), stop_id});
+    stop_lat_.push_back(coordinate.lat);
+    stop_lng_.push_back(coordinate.lng);
+    stop_prepared_.push_back(geo::PrepareCoordinates(coordinate));
+    stop_transfer_times_.push_back(0.);
+    stopname_to_stop_[stops_list_.back().name] = &stops_list_.back();
+    updates_.push_back({domain::CatalogueUpdate::Type::STOP_ADDED, stops_list_.back().name, {}});
 }
 
 // Добавление маршрута в базу
-void TransportCatalogue::AddBus(const std::string &bus_name, const std::vector<std::string_view> &route, const bool &is_roundtrip) {
+void TransportCatalogue::AddBus(std::string_view bus_name, const std::vector<std::string_view> &route, const bool &is_roundtrip) {
     std::vector<const domain::Stop *> stop_list_for_bus;
     for (const auto &stop : route) {
         if (stopname_to_stop_.count(stop)) {
@@ -20,16 +88,68 @@ void TransportCatalogue::AddBus(const std::string &bus_name, const std::vector<s
             stop_list_for_bus.push_back(stop_ptr);
         }
     }
-    // маршрут и список остановок
-    bus_routes_.push_back({bus_name, stop_list_for_bus, is_roundtrip});
+    // маршрут и список остановок; ячейка удалённого маршрута занимается повторно
+    domain::Bus bus{names_.GetName(names_.Intern(bus_name)), stop_list_for_bus, is_roundtrip, std::nullopt};
+    domain::Bus *bus_ptr = nullptr;
+    if (free_bus_slots_.empty()) {
+        bus_routes_.push_back(std::move(bus));
+        bus_ptr = &bus_routes_.back();
+    } else {
+        bus_ptr = free_bus_slots_.back();
+        free_bus_slots_.pop_back();
+        *bus_ptr = std::move(bus);
+    }
     // ссылка на имя маршрута и дек маршрута-остновок
-    busname_to_bus_.insert({bus_routes_.back().bus_route, &bus_routes_.back()});
+    busname_to_bus_.insert({bus_ptr->bus_route, bus_ptr});
     // Заполнение мапы для статистики остановок
-    if (&bus_routes_.back()) {
-        for (const auto &stops : bus_routes_.back().stops) {
-            stopname_to_bus_[stops->name].insert(&bus_routes_.back());
-        }
+    for (const auto &stops : bus_ptr->stops) {
+        stopname_to_bus_[stops->name].insert(bus_ptr);
+        stop_buses_.erase(stops);
     }
+    updates_.push_back({domain::CatalogueUpdate::Type::BUS_ADDED, bus_ptr->bus_route, {}});
+}
+
+bool TransportCatalogue::RemoveBus(std::string_view bus_name) {
+    auto bus_pos = busname_to_bus_.find(bus_name);
+    if (bus_pos == busname_to_bus_.end()) {
+        return false;
+    }
+    domain::Bus *bus = bus_pos->second;
+    for (const auto *stop : bus->stops) {
+        stopname_to_bus_[stop->name].erase(bus);
+        stop_buses_.erase(stop);
+    }
+    bus_stats_.erase(bus);
+    busname_to_bus_.erase(bus_pos);
+    updates_.push_back({domain::CatalogueUpdate::Type::BUS_REMOVED, bus->bus_route, {}});
+    bus->stops.clear();
+    free_bus_slots_.push_back(bus);
+    return true;
+}
+
+void TransportCatalogue::SetTransferTime(std::string_view stop_name, double minutes) {
+    const domain::Stop *stop = stopname_to_stop_.at(stop_name);
+    stop_transfer_times_[stop->id] = minutes;
+    updates_.push_back({domain::CatalogueUpdate::Type::TIMETABLE_CHANGED, stop->name, {}});
+}
+
+double TransportCatalogue::GetTransferTime(domain::StopId stop_id) const {
+    return stop_transfer_times_[stop_id];
+}
+
+bool TransportCatalogue::SetBusSchedule(std::string_view bus_name, std::optional<domain::BusSchedule> schedule) {
+    auto bus_pos = busname_to_bus_.find(bus_name);
+    if (bus_pos == busname_to_bus_.end()) {
+        return false;
+    }
+    bus_pos->second->schedule = schedule;
+    updates_.push_back({domain::CatalogueUpdate::Type::TIMETABLE_CHANGED, bus_pos->second->bus_route, {}});
+    return true;
+}
+
+void TransportCatalogue::UpdateBus(std::string_view bus_name, const std::vector<std::string_view> &route, bool is_roundtrip) {
+    RemoveBus(bus_name);
+    AddBus(bus_name, route, is_roundtrip);
 }
 
 // Статистика маршрута
@@ -38,27 +158,40 @@ domain::BusStat TransportCatalogue::ReportBusStatistic(std::string_view request)
     if (bus_pos == busname_to_bus_.end()) {
         return {};
     }
-    domain::Bus bus = *(*bus_pos).second;
+    auto stat_pos = bus_stats_.find(bus_pos->second);
+    if (stat_pos != bus_stats_.end()) {
+        return stat_pos->second;
+    }
+    return ComputeBusStatistic(*bus_pos->second);
+}
+
+domain::BusStat TransportCatalogue::ComputeBusStatistic(const domain::Bus &bus) const {
     int common_stops_count = static_cast<int>(bus.stops.size());
-    bool first_cycle = true;
-    double total_distance = 0.;
-    double route_distance = 0.;
-    geo::Coordinates prev_location;
-    const domain::Stop *prev_stop;
     std::unordered_set<std::string_view> uniq_stops;
     for (const auto *stop_item : bus.stops) {
         uniq_stops.insert(stop_item->name);
     }
     int uniq_stops_count = static_cast<int>(uniq_stops.size());
-    // Рассчет дистанции маршрута
-    for (const auto stop : bus.stops) {
-        if (!first_cycle) {
-            total_distance += geo::ComputeDistance(prev_location, stop->coordinate);
-            route_distance += GetDistance(std::move(prev_stop), std::move(stop));
+    if (bus.stops.size() < 2) {
+        return {common_stops_count, uniq_stops_count, 0., 0.};
+    }
+    // Рассчет дистанции маршрута: географические расстояния считаются пакетно,
+    // отрезок i соединяет точки i и i + 1 одного и того же массива
+    const size_t segments_count = bus.stops.size() - 1;
+    std::vector<geo::PreparedCoordinates> route_points;
+    route_points.reserve(bus.stops.size());
+    double route_distance = 0.;
+    for (size_t i = 0; i < bus.stops.size(); ++i) {
+        route_points.push_back(stop_prepared_[bus.stops[i]->id]);
+        if (i > 0) {
+            route_distance += GetDistance(bus.stops[i - 1], bus.stops[i]);
         }
-        first_cycle = false;
-        prev_location = stop->coordinate;
-        prev_stop = stop;
+    }
+    std::vector<double> segment_distances(segments_count);
+    geo::ComputeDistances(route_points.data(), route_points.data() + 1, segment_distances.data(), segments_count);
+    double total_distance = 0.;
+    for (const double distance : segment_distances) {
+        total_distance += distance;
     }
     return {common_stops_count, uniq_stops_count, route_distance, route_distance / total_distance};
 }
@@ -66,9 +199,18 @@ domain::BusStat TransportCatalogue::ReportBusStatistic(std::string_view request)
 // Информация по остановке
 domain::StopStat TransportCatalogue::ReportStopStatistic(std::string_view stopname) const {
     std::string_view stop;
-    if (stopname_to_stop_.count(stopname)) {
+    auto stop_pos = stopname_to_stop_.find(stopname);
+    if (stop_pos != stopname_to_stop_.end()) {
         stop = stopname;
+        auto buses_pos = stop_buses_.find(stop_pos->second);
+        if (buses_pos != stop_buses_.end()) {
+            return {stop, buses_pos->second};
+        }
     }
+    return {stop, ComputeStopBuses(stopname)};
+}
+
+std::vector<const domain::Bus *> TransportCatalogue::ComputeStopBuses(std::string_view stopname) const {
     auto stop_stat_pos = stopname_to_bus_.find(stopname);
     std::vector<const domain::Bus *> v_stop_stat;
     if (stop_stat_pos != stopname_to_bus_.end()) {
@@ -80,7 +222,7 @@ domain::StopStat TransportCatalogue::ReportStopStatistic(std::string_view stopna
         return std::lexicographical_compare((*lhs).bus_route.begin(), (*lhs).bus_route.end(),
                                             (*rhs).bus_route.begin(), (*rhs).bus_route.end());
     });
-    return {stop, v_stop_stat};
+    return v_stop_stat;
 }
 
 double TransportCatalogue::GetDistance(const domain::Stop *prev_stop, const domain::Stop *cur_stop) const {
@@ -97,6 +239,31 @@ void TransportCatalogue::SetDistance(const std::string_view a_name, const std::s
     auto a_stop_ptr = stopname_to_stop_.find(a_name)->second;
     auto b_stop_ptr = stopname_to_stop_.find(b_name)->second;
     stop_to_stop_dist_[{a_stop_ptr, b_stop_ptr}] = dist;
+    InvalidateBusesThroughStop(a_stop_ptr->name);
+    updates_.push_back({domain::CatalogueUpdate::Type::DISTANCE_CHANGED, a_stop_ptr->name, b_stop_ptr->name});
+}
+
+void TransportCatalogue::InvalidateBusesThroughStop(std::string_view stopname) {
+    auto buses_pos = stopname_to_bus_.find(stopname);
+    if (buses_pos == stopname_to_bus_.end()) {
+        return;
+    }
+    for (const auto *bus : buses_pos->second) {
+        bus_stats_.erase(bus);
+    }
+}
+
+void TransportCatalogue::RefreshStatistics() {
+    for (const auto &[name, bus] : busname_to_bus_) {
+        if (!bus_stats_.count(bus)) {
+            bus_stats_.emplace(bus, ComputeBusStatistic(*bus));
+        }
+    }
+    for (const auto &[name, stop] : stopname_to_stop_) {
+        if (!stop_buses_.count(stop)) {
+            stop_buses_.emplace(stop, ComputeStopBuses(name));
+        }
+    }
 }
 
 const std::unordered_map<std::string_view, domain::Bus *> &TransportCatalogue::GetAllRoutes() const {
@@ -106,3 +273,44 @@ const std::unordered_map<std::string_view, domain::Bus *> &TransportCatalogue::G
 const std::unordered_map<std::string_view, domain::Stop *>& TransportCatalogue::GetAllStopsList() const {
     return stopname_to_stop_;
 }
+
+const domain::Stop *TransportCatalogue::FindStop(std::string_view stop_name) const {
+    auto stop_pos = stopname_to_stop_.find(stop_name);
+    return stop_pos == stopname_to_stop_.end() ? nullptr : stop_pos->second;
+}
+
+size_t TransportCatalogue::GetStopCount() const {
+    return stops_list_.size();
+}
+
+const domain::Stop &TransportCatalogue::GetStop(domain::StopId stop_id) const {
+    return stops_list_.at(stop_id);
+}
+
+const std::unordered_map<std::pair<const domain::Stop *, const domain::Stop *>, double, domain::StopDistanceHasher> &TransportCatalogue::GetAllDistances() const {
+    return stop_to_stop_dist_;
+}
+
+geo::Coordinates TransportCatalogue::GetStopCoordinates(domain::StopId stop_id) const {
+    return {stop_lat_[stop_id], stop_lng_[stop_id]};
+}
+
+const geo::PreparedCoordinates &TransportCatalogue::GetPreparedCoordinates(domain::StopId stop_id) const {
+    return stop_prepared_[stop_id];
+}
+
+const std::vector<double> &TransportCatalogue::GetStopLatitudes() const {
+    return stop_lat_;
+}
+
+const std::vector<double> &TransportCatalogue::GetStopLongitudes() const {
+    return stop_lng_;
+}
+
+const domain::NamePool &TransportCatalogue::GetNamePool() const {
+    return names_;
+}
+
+const std::vector<domain::CatalogueUpdate> &TransportCatalogue::GetUpdates() const {
+    return updates_;
+}
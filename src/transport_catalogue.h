@@ -12,13 +12,29 @@
 
 #include "domain.h"
 #include "geo.h"
+#include "name_pool.h"
 
 class TransportCatalogue {
 
 public:
-    void AddStop(const std::string &name, const geo::Coordinates &coordinate);
+    TransportCatalogue() = default;
 
-    void AddBus(const std::string &bus_name, const std::vector<std::string_view> &route, const bool &is_roundtrip);
+    // Глубокая копия: указатели на остановки и маршруты и ссылки на имена переводятся на собственные данные копии.
+    // Нужна для построения следующей версии базы, пока читатели работают с текущей
+    TransportCatalogue(const TransportCatalogue &other);
+    TransportCatalogue &operator=(const TransportCatalogue &) = delete;
+    TransportCatalogue(TransportCatalogue &&) = default;
+    TransportCatalogue &operator=(TransportCatalogue &&) = default;
+
+    void AddStop(std::string_view name, const geo::Coordinates &coordinate);
+
+    void AddBus(std::string_view bus_name, const std::vector<std::string_view> &route, const bool &is_roundtrip);
+
+    // удаление маршрута, false если маршрута нет
+    bool RemoveBus(std::string_view bus_name);
+
+    // замена остановок маршрута; если маршрута нет, он добавляется
+    void UpdateBus(std::string_view bus_name, const std::vector<std::string_view> &route, bool is_roundtrip);
 
     domain::BusStat ReportBusStatistic(std::string_view request) const;
 
@@ -26,17 +42,72 @@ public:
 
     void SetDistance(const std::string_view a_name, const std::string_view b_name, const double &dist);
 
+    // минимальное время пересадки на остановке в минутах, по умолчанию 0
+    void SetTransferTime(std::string_view stop_name, double minutes);
+
+    double GetTransferTime(domain::StopId stop_id) const;
+
+    // расписание маршрута, std::nullopt снимает маршрут с расписания; false если маршрута нет
+    bool SetBusSchedule(std::string_view bus_name, std::optional<domain::BusSchedule> schedule);
+
     const std::unordered_map<std::string_view, domain::Bus *> &GetAllRoutes() const;
 
     double GetDistance(const domain::Stop *prev_stop, const domain::Stop *cur_stop) const;
 
     const std::unordered_map<std::string_view, domain::Stop *> &GetAllStopsList() const;
-    
+
+    // поиск остановки по имени, nullptr если остановки нет
+    const domain::Stop *FindStop(std::string_view stop_name) const;
+
+    size_t GetStopCount() const;
+
+    const domain::Stop &GetStop(domain::StopId stop_id) const;
+
+    // все заданные расстояния между остановками
+    const std::unordered_map<std::pair<const domain::Stop *, const domain::Stop *>, double, domain::StopDistanceHasher> &GetAllDistances() const;
+
+    geo::Coordinates GetStopCoordinates(domain::StopId stop_id) const;
+
+    const geo::PreparedCoordinates &GetPreparedCoordinates(domain::StopId stop_id) const;
+
+    // координаты всех остановок в виде непрерывных массивов, индекс - id остановки
+    const std::vector<double> &GetStopLatitudes() const;
+    const std::vector<double> &GetStopLongitudes() const;
+
+    // таблица имён остановок и маршрутов, на которую ссылаются остальные подсистемы
+    const domain::NamePool &GetNamePool() const;
+
+    // журнал изменений с момента создания каталога, номер записи - версия каталога
+    const std::vector<domain::CatalogueUpdate> &GetUpdates() const;
+
+    // досчитывает статистику маршрутов и остановок, сброшенную изменениями каталога.
+    // Запросы статистики кеш не заполняют, поэтому чтение каталога остаётся константным
+    void RefreshStatistics();
+
 private:
+    // интернированные имена остановок и маршрутов, domain::Stop::name и domain::Bus::bus_route ссылаются на него
+    domain::NamePool names_;
     std::deque<domain::Stop> stops_list_;
+    // координаты остановок хранятся по столбцам, индекс - id остановки
+    std::vector<double> stop_lat_;
+    std::vector<double> stop_lng_;
+    std::vector<geo::PreparedCoordinates> stop_prepared_;
+    // время пересадки, индекс - id остановки
+    std::vector<double> stop_transfer_times_;
     std::unordered_map<std::string_view, domain::Stop *> stopname_to_stop_;
     std::deque<domain::Bus> bus_routes_;
     std::unordered_map<std::string_view, domain::Bus *> busname_to_bus_;
     std::unordered_map<std::string_view, std::unordered_set<const domain::Bus *>> stopname_to_bus_;
     std::unordered_map<std::pair<const domain::Stop *, const domain::Stop *>, double, domain::StopDistanceHasher> stop_to_stop_dist_;
+    // ячейки удалённых маршрутов, переиспользуются при добавлении новых
+    std::vector<domain::Bus *> free_bus_slots_;
+    std::vector<domain::CatalogueUpdate> updates_;
+    // кеш статистики; изменение каталога удаляет только зависящие от него записи
+    std::unordered_map<const domain::Bus *, domain::BusStat> bus_stats_;
+    std::unordered_map<const domain::Stop *, std::vector<const domain::Bus *>> stop_buses_;
+
+    domain::BusStat ComputeBusStatistic(const domain::Bus &bus) const;
+    std::vector<const domain::Bus *> ComputeStopBuses(std::string_view stopname) const;
+    // сброс статистики маршрутов, проходящих через остановку
+    void InvalidateBusesThroughStop(std::string_view stopname);
 };
@@ -1,67 +1,378 @@
 #include "transport_router.h"
 #include "domain.h"
 
+#include <algorithm>
+#include <atomic>
+#include <limits>
+#include <stdexcept>
+#include <string>
+#include <tuple>
+#include <unordered_set>
+
+#include "parallel.h"
+#include "shortest_paths.h"
+
 using namespace std::literals;
 using namespace std::string_view_literals;
 
 namespace router {
 
+namespace {
+// запас к расстоянию по прямой на ребре поездки, метров
+const double STRAIGHT_LINE_TOLERANCE = 1.;
+
+std::atomic<uint64_t> created_searches{0};
+
+// поиск рабочей области, создаётся при первом обращении
+template <typename Search>
+Search &GetSearch(std::optional<Search> &search, const graph::DirectedWeightedGraph<double> &graph) {
+    if (!search) {
+        search.emplace(graph);
+        ++created_searches;
+    }
+    return *search;
+}
+} // namespace
+
 TransportRouter::TransportRouter(const TransportCatalogue &db, int wait_time, double bus_velocity)
+    : TransportRouter(db, wait_time, bus_velocity, PrecomputeSettings{}) {
+}
+
+TransportRouter::TransportRouter(const TransportCatalogue &db, int wait_time, double bus_velocity, const PrecomputeSettings &settings)
     : bus_wait_time_(wait_time),
       bus_velocity_(bus_velocity) {
     BuildGraph(db);
-    router_ = std::make_unique<graph::Router<double>>(graph_);
+    applied_updates_ = db.GetUpdates().size();
+    search_ = settings.search;
+    PrepareRouteSearch();
+    const auto cost = GetPrecomputeCost();
+    if (settings.memory_limit > 0 && cost.peak_bytes > settings.memory_limit) {
+        if (!settings.fallback) {
+            throw std::length_error("Routing table needs "s + std::to_string(cost.peak_bytes >> 10) + " KiB, the limit is "s
+                                    + std::to_string(settings.memory_limit >> 10) + " KiB"s);
+        }
+        // разметка нужна только без таблицы: время из таблицы читается быстрее слияния меток
+        if (settings.hub_labels) {
+            hub_labels_ = std::make_unique<graph::HubLabels>(graph_);
+        }
+        return;
+    }
+    router_ = std::make_unique<graph::Router<double>>(graph_, graph::AllPairsMethod::BLOCKED, settings.progress);
+}
+
+TransportRouter::TransportRouter(int wait_time, double bus_velocity)
+    : bus_wait_time_(wait_time),
+      bus_velocity_(bus_velocity) {
+}
+
+TransportRouter::TransportRouter(const TransportCatalogue &db, int wait_time, double bus_velocity,
+                                 graph::DirectedWeightedGraph<double> graph, std::vector<graph::VertexId> stop_ids,
+                                 graph::Router<double>::RoutesInternalData routes_data,
+                                 RouteSearch search, bool hub_labels)
+    : bus_wait_time_(wait_time),
+      bus_velocity_(bus_velocity),
+      db_(&db),
+      stop_ids_(std::move(stop_ids)),
+      graph_(std::move(graph)),
+      timetable_(db, bus_velocity) {
+    if (stop_ids_.size() != db.GetStopCount()) {
+        throw std::invalid_argument("Stop vertices do not match the catalogue");
+    }
+    // рёбра поездок восстанавливаются по графу: у рёбер ожидания нулевой пролёт
+    for (graph::EdgeId edge_id = 0; edge_id < graph_.GetEdgeCount(); ++edge_id) {
+        const auto &edge = graph_.GetEdge(edge_id);
+        if (edge.span > 0 && !graph_.IsEdgeRemoved(edge_id)) {
+            bus_edges_[edge.name].push_back(edge_id);
+        }
+    }
+    applied_updates_ = db.GetUpdates().size();
+    search_ = search;
+    PrepareRouteSearch();
+    if (routes_data.GetCellCount() != 0 || graph_.GetVertexCount() == 0) {
+        router_ = std::make_unique<graph::Router<double>>(graph_, std::move(routes_data));
+    } else if (hub_labels) {
+        hub_labels_ = std::make_unique<graph::HubLabels>(graph_);
+    }
+}
+
+TransportRouter::TransportRouter(const TransportRouter &other, const TransportCatalogue &db)
+    : bus_wait_time_(other.bus_wait_time_),
+      bus_velocity_(other.bus_velocity_),
+      db_(&db),
+      stop_ids_(other.stop_ids_),
+      graph_(other.graph_.GetVertexCount()),
+      search_(other.search_),
+      vertex_points_(other.vertex_points_),
+      max_straight_speed_(other.max_straight_speed_),
+      timetable_(other.timetable_, db),
+      applied_updates_(other.applied_updates_) {
+    const auto name = [&db](std::string_view other_name) {
+        const auto name_id = db.GetNamePool().Find(other_name);
+        return name_id ? db.GetNamePool().GetName(*name_id) : std::string_view{};
+    };
+    // рёбра добавляются в порядке id, поэтому списки смежности копии совпадают с исходными
+    for (graph::EdgeId edge_id = 0; edge_id < other.graph_.GetEdgeCount(); ++edge_id) {
+        auto edge = other.graph_.GetEdge(edge_id);
+        edge.name = name(edge.name);
+        graph_.AddEdge(edge);
+        if (other.graph_.IsEdgeRemoved(edge_id)) {
+            graph_.RemoveEdge(edge_id);
+        }
+    }
+    for (const auto &[bus_name, edges] : other.bus_edges_) {
+        bus_edges_.emplace(name(bus_name), edges);
+    }
+    if (other.router_) {
+        router_ = std::make_unique<graph::Router<double>>(graph_, other.router_->GetRoutesInternalData());
+    }
+    if (other.hub_labels_) {
+        hub_labels_ = std::make_unique<graph::HubLabels>(*other.hub_labels_, graph_);
+    }
+    if (other.landmarks_) {
+        landmarks_ = std::make_unique<graph::Landmarks>(*other.landmarks_);
+    }
+}
+
+graph::EdgeId TransportRouter::AddStopVertices(const domain::Stop &stop, graph::DirectedWeightedGraph<double> &stops_graph) {
+    const graph::VertexId wait_vertex = stops_graph.AddVertex();
+    const graph::VertexId ride_vertex = stops_graph.AddVertex();
+    if (stop_ids_.size() <= stop.id) {
+        stop_ids_.resize(stop.id + 1);
+    }
+    stop_ids_[stop.id] = wait_vertex;
+    return stops_graph.AddEdge({stop.name,
+                                0,
+                                wait_vertex,
+                                ride_vertex,
+                                static_cast<double>(bus_wait_time_)});
 }
 
 void TransportRouter::FillGraphWithVertices(const std::unordered_map<std::string_view, domain::Stop *> &stops_list,
                                             graph::DirectedWeightedGraph<double> &stops_graph) {
-
-    std::map<std::string, graph::VertexId> stop_ids;
-    graph::VertexId vertex_id = 0;
+    stop_ids_.assign(stops_list.size(), 0);
     // заполнение графа вершинами - ожиданиями
     for (const auto &[stop_name, stop_info] : stops_list) {
-        stop_ids[stop_info->name] = vertex_id;
-        stops_graph.AddEdge({stop_info->name,
-                             0,
-                             vertex_id,
-                             ++vertex_id,
-                             static_cast<double>(bus_wait_time_)});
-        ++vertex_id;
+        AddStopVertices(*stop_info, stops_graph);
     }
-    stop_ids_ = std::move(stop_ids);
 }
 
-void TransportRouter::FillGraphWithEdges(const TransportCatalogue &db, const std::unordered_map<std::string_view, domain::Bus *> &bases_list,
-                                         graph::DirectedWeightedGraph<double> &stops_graph) {
+size_t TransportRouter::CountBusEdges(const domain::Bus &bus) {
+    const size_t stops_count = bus.stops.size();
+    return stops_count < 2 ? 0 : stops_count * (stops_count - 1) / 2;
+}
+
+void TransportRouter::MakeBusEdges(const TransportCatalogue &db, const domain::Bus &bus, graph::Edge<double> *edges) const {
     // константное значение используется для перевода км/ч в м/мин
     const double speed_coeff = 100. / 6.;
-    for (auto it = bases_list.begin(); it != bases_list.end(); ++it) {
-        const auto &bus = it->second;
-        const auto &stops = bus->stops;
-        size_t stops_count = stops.size();
-        // наполнение графа ребрами с весами
-        for (size_t i = 0; i < stops_count; ++i) {
-            for (size_t j = i + 1; j < stops_count; ++j) {
-                const domain::Stop *stop_from = stops[i];
-                const domain::Stop *stop_to = stops[j];
-                double dist_total = 0;
-                for (size_t k = i + 1; k <= j; ++k) {
-                    dist_total += db.GetDistance(stops[k - 1], stops[k]);
+    const auto &stops = bus.stops;
+    size_t stops_count = stops.size();
+    // длины отрезков считаются один раз; сумма для пары (i, j) накапливается по мере роста j
+    // в том же порядке сложений, что и при суммировании отрезков от i + 1 до j
+    std::vector<double> segments(stops_count);
+    for (size_t k = 1; k < stops_count; ++k) {
+        segments[k] = db.GetDistance(stops[k - 1], stops[k]);
+    }
+    // наполнение графа ребрами с весами
+    for (size_t i = 0; i < stops_count; ++i) {
+        const graph::VertexId vertex_from = stop_ids_[stops[i]->id] + 1;
+        double dist_total = 0;
+        for (size_t j = i + 1; j < stops_count; ++j) {
+            dist_total += segments[j];
+            *edges++ = {bus.bus_route,
+                        j - i,
+                        vertex_from,
+                        stop_ids_[stops[j]->id],
+                        static_cast<double>(dist_total) / (bus_velocity_ * speed_coeff)};
+        }
+    }
+}
+
+void TransportRouter::ReplaceBusEdges(std::string_view bus_name, const domain::Bus *bus, std::vector<graph::EdgeId> &removed_edges,
+                                      std::vector<graph::EdgeId> &added_edges) {
+    std::vector<graph::Edge<double>> edges(bus ? CountBusEdges(*bus) : 0);
+    if (bus) {
+        MakeBusEdges(*db_, *bus, edges.data());
+    }
+    std::vector<graph::EdgeId> old_edges;
+    if (auto edges_pos = bus_edges_.find(bus_name); edges_pos != bus_edges_.end()) {
+        old_edges = std::move(edges_pos->second);
+        bus_edges_.erase(edges_pos);
+    }
+    // прежние рёбра по ключу сравнения, вес сравнивается точно: MakeBusEdges складывает отрезки в одном порядке,
+    // и у неизменившейся пары остановок вес тот же до бита
+    const auto key = [](const graph::Edge<double> &edge) {
+        return std::tie(edge.from, edge.to, edge.span, edge.weight);
+    };
+    std::sort(old_edges.begin(), old_edges.end(), [&](graph::EdgeId lhs, graph::EdgeId rhs) {
+        return key(graph_.GetEdge(lhs)) < key(graph_.GetEdge(rhs));
+    });
+    std::vector<bool> kept(old_edges.size(), false);
+
+    std::vector<graph::EdgeId> bus_edges;
+    bus_edges.reserve(edges.size());
+    for (const auto &edge : edges) {
+        auto old_pos = std::lower_bound(old_edges.begin(), old_edges.end(), edge, [&](graph::EdgeId lhs, const graph::Edge<double> &rhs) {
+            return key(graph_.GetEdge(lhs)) < key(rhs);
+        });
+        // у маршрута с повторами остановок одинаковых рёбер несколько, каждое прежнее сохраняется один раз
+        while (old_pos != old_edges.end() && key(graph_.GetEdge(*old_pos)) == key(edge) && kept[old_pos - old_edges.begin()]) {
+            ++old_pos;
+        }
+        if (old_pos != old_edges.end() && key(graph_.GetEdge(*old_pos)) == key(edge)) {
+            kept[old_pos - old_edges.begin()] = true;
+            bus_edges.push_back(*old_pos);
+            continue;
+        }
+        const graph::EdgeId edge_id = graph_.AddEdge(edge);
+        bus_edges.push_back(edge_id);
+        added_edges.push_back(edge_id);
+    }
+    for (size_t i = 0; i < old_edges.size(); ++i) {
+        if (!kept[i]) {
+            graph_.RemoveEdge(old_edges[i]);
+            removed_edges.push_back(old_edges[i]);
+        }
+    }
+    if (bus) {
+        bus_edges_.emplace(bus->bus_route, std::move(bus_edges));
+    }
+}
+
+void TransportRouter::FillGraphWithEdges(const TransportCatalogue &db, const std::unordered_map<std::string_view, domain::Bus *> &bases_list,
+                                         graph::DirectedWeightedGraph<double> &stops_graph, size_t threads_count) {
+    // место рёбер каждого маршрута в общем массиве известно заранее, поэтому потоки пишут
+    // в непересекающиеся диапазоны и порядок рёбер тот же, что и при последовательном построении
+    std::vector<const domain::Bus *> buses;
+    buses.reserve(bases_list.size());
+    std::vector<size_t> offsets(1, 0);
+    offsets.reserve(bases_list.size() + 1);
+    for (const auto &[bus_name, bus] : bases_list) {
+        buses.push_back(bus);
+        offsets.push_back(offsets.back() + CountBusEdges(*bus));
+    }
+    std::vector<graph::Edge<double>> edges(offsets.back());
+
+    parallel::ParallelFor(buses.size(), threads_count, [&](size_t i) {
+        MakeBusEdges(db, *buses[i], edges.data() + offsets[i]);
+    });
+
+    const graph::EdgeId first_edge = stops_graph.GetEdgeCount();
+    stops_graph.AddEdges(std::move(edges));
+    for (size_t i = 0; i < buses.size(); ++i) {
+        auto &bus_edges = bus_edges_[buses[i]->bus_route];
+        for (size_t edge = offsets[i]; edge < offsets[i + 1]; ++edge) {
+            bus_edges.push_back(first_edge + edge);
+        }
+    }
+}
+
+void TransportRouter::ApplyCatalogueUpdates() {
+    const auto &updates = db_->GetUpdates();
+    if (applied_updates_ == updates.size()) {
+        return;
+    }
+    std::vector<graph::EdgeId> removed_edges;
+    std::vector<graph::EdgeId> added_edges;
+    // маршруты, рёбра которых надо перестроить: изменённые и проходящие через пары с новым расстоянием
+    std::unordered_set<std::string_view> dirty_buses;
+    for (size_t i = applied_updates_; i < updates.size(); ++i) {
+        const auto &update = updates[i];
+        switch (update.type) {
+        case domain::CatalogueUpdate::Type::STOP_ADDED:
+            added_edges.push_back(AddStopVertices(*db_->FindStop(update.name), graph_));
+            break;
+        case domain::CatalogueUpdate::Type::BUS_ADDED:
+        case domain::CatalogueUpdate::Type::BUS_REMOVED:
+            dirty_buses.insert(update.name);
+            break;
+        case domain::CatalogueUpdate::Type::DISTANCE_CHANGED: {
+            const domain::Stop *stop = db_->FindStop(update.name);
+            const domain::Stop *other_stop = db_->FindStop(update.other_stop_name);
+            for (const auto *bus : db_->ReportStopStatistic(stop->name).bus_routes) {
+                const auto &stops = bus->stops;
+                for (size_t j = 1; j < stops.size(); ++j) {
+                    if ((stops[j - 1] == stop && stops[j] == other_stop) || (stops[j - 1] == other_stop && stops[j] == stop)) {
+                        dirty_buses.insert(bus->bus_route);
+                        break;
+                    }
                 }
-                stops_graph.AddEdge({bus->bus_route,
-                                     j - i,
-                                     stop_ids_.at(stop_from->name) + 1,
-                                     stop_ids_.at(stop_to->name),
-                                     static_cast<double>(dist_total) / (bus_velocity_ * speed_coeff)});
             }
+            break;
         }
+        case domain::CatalogueUpdate::Type::TIMETABLE_CHANGED:
+            // граф от расписаний не зависит
+            break;
+        }
+    }
+    applied_updates_ = updates.size();
+    timetable_ = TimetableRouter(*db_, bus_velocity_);
+
+    const auto &all_buses = db_->GetAllRoutes();
+    for (const auto bus_name : dirty_buses) {
+        auto bus_pos = all_buses.find(bus_name);
+        ReplaceBusEdges(bus_name, bus_pos != all_buses.end() ? bus_pos->second : nullptr, removed_edges, added_edges);
+    }
+    if (router_) {
+        router_->Update(removed_edges, added_edges);
+    }
+    // разметка есть только без таблицы и строится заново: частичного обновления у неё нет
+    if (hub_labels_) {
+        hub_labels_ = std::make_unique<graph::HubLabels>(graph_);
     }
+    graph_generation_ = NextGraphGeneration();
+    PrepareRouteSearch();
 }
 
-void TransportRouter::BuildGraph(const TransportCatalogue &db) {
+void TransportRouter::PrepareRouteSearch() {
+    vertex_points_.clear();
+    max_straight_speed_ = 0.;
+    landmarks_.reset();
+    if (search_ == RouteSearch::ALT) {
+        landmarks_ = std::make_unique<graph::Landmarks>(graph_);
+    }
+    if (search_ != RouteSearch::GEOMETRIC_A_STAR) {
+        return;
+    }
+    vertex_points_.resize(graph_.GetVertexCount());
+    for (domain::StopId stop_id = 0; stop_id < stop_ids_.size(); ++stop_id) {
+        const auto &coordinates = db_->GetPreparedCoordinates(stop_id);
+        vertex_points_[stop_ids_[stop_id]] = {coordinates, true};
+        vertex_points_[stop_ids_[stop_id] + 1] = {coordinates, false};
+    }
+    // Дорожное расстояние бывает короче расстояния по прямой, поэтому скорость по прямой берётся наибольшая на рёбрах
+    // поездок, а не bus_velocity_. Запас STRAIGHT_LINE_TOLERANCE покрывает погрешность ComputeDistance на коротких
+    // отрезках, чтобы оценка оставалась согласованной
+    for (graph::EdgeId edge_id = 0; edge_id < graph_.GetEdgeCount(); ++edge_id) {
+        const auto &edge = graph_.GetEdge(edge_id);
+        if (edge.span == 0 || graph_.IsEdgeRemoved(edge_id)) {
+            continue;
+        }
+        const double distance = geo::ComputeDistance(vertex_points_[edge.from].coordinates, vertex_points_[edge.to].coordinates)
+                                + STRAIGHT_LINE_TOLERANCE;
+        // у ребра с нулевым временем скорость бесконечна и оценка по расстоянию вырождается в 0
+        max_straight_speed_ = std::max(max_straight_speed_, distance / edge.weight);
+    }
+}
+
+double TransportRouter::GetStraightLineBound(graph::VertexId vertex, graph::VertexId to) const {
+    if (vertex == to) {
+        return 0.;
+    }
+    // из вершины ожидания любой путь начинается с ожидания
+    const auto &point = vertex_points_[vertex];
+    const double wait = point.wait ? bus_wait_time_ : 0.;
+    if (max_straight_speed_ == 0.) {
+        return wait;
+    }
+    return wait + geo::ComputeDistance(point.coordinates, vertex_points_[to].coordinates) / max_straight_speed_;
+}
+
+void TransportRouter::BuildGraph(const TransportCatalogue &db, size_t threads_count) {
+    db_ = &db;
 
     const auto &all_stops_list = db.GetAllStopsList();
-    graph::DirectedWeightedGraph<double> stops_graph(all_stops_list.size() * 2);
+    graph::DirectedWeightedGraph<double> stops_graph;
+    bus_edges_.clear();
     /*
      * Здесь кажется вернуть данные в stops_graph через параметр правильнее,
      * а stop_ids_ инициализировать внутри метода, т.к. он относится только к вершинам.
@@ -70,12 +381,402 @@ void TransportRouter::BuildGraph(const TransportCatalogue &db) {
     FillGraphWithVertices(all_stops_list, stops_graph);
     const auto &all_buses_list = db.GetAllRoutes();
     // аналогично возвращаем данные stops_graph из параметра
-    FillGraphWithEdges(db, all_buses_list, stops_graph);
+    FillGraphWithEdges(db, all_buses_list, stops_graph, threads_count);
     graph_ = std::move(stops_graph);
+    graph_generation_ = NextGraphGeneration();
+    timetable_ = TimetableRouter(db, bus_velocity_);
 }
 
 const std::optional<graph::Router<double>::RouteInfo> TransportRouter::CreateRoute(const std::string_view stop_from, const std::string_view stop_to) const {
-    return router_->BuildRoute(stop_ids_.at(std::string(stop_from)), stop_ids_.at(std::string(stop_to)));
+    const auto vertex_from = GetStopVertex(stop_from);
+    const auto vertex_to = GetStopVertex(stop_to);
+    if (!vertex_from || !vertex_to) {
+        return std::nullopt;
+    }
+    graph::Router<double>::RouteInfo route;
+    const auto weight = FindRoute(*vertex_from, *vertex_to, &route.edges);
+    if (!weight) {
+        return std::nullopt;
+    }
+    route.weight = *weight;
+    return route;
+}
+
+const std::optional<graph::Router<double>::RouteInfo> TransportRouter::CreateRoute(domain::StopId stop_from, domain::StopId stop_to) const {
+    graph::Router<double>::RouteInfo route;
+    const auto weight = FindRoute(stop_ids_.at(stop_from), stop_ids_.at(stop_to), &route.edges);
+    if (!weight) {
+        return std::nullopt;
+    }
+    route.weight = *weight;
+    return route;
+}
+
+std::optional<double> TransportRouter::CreateRoute(std::string_view stop_from, std::string_view stop_to,
+                                                   graph::Router<double>::RouteEdges &edges) const {
+    const auto vertex_from = GetStopVertex(stop_from);
+    const auto vertex_to = GetStopVertex(stop_to);
+    if (!vertex_from || !vertex_to) {
+        edges.clear();
+        return std::nullopt;
+    }
+    return FindRoute(*vertex_from, *vertex_to, &edges);
+}
+
+std::vector<std::optional<graph::Router<double>::RouteInfo>> TransportRouter::CreateRoutes(
+    const std::vector<std::pair<std::string_view, std::string_view>> &pairs, size_t threads_count) const {
+    std::vector<std::optional<graph::Router<double>::RouteInfo>> result(pairs.size());
+    // группы пар с общей исходной вершиной в порядке первого появления
+    std::unordered_map<graph::VertexId, size_t> group_indices;
+    std::vector<graph::VertexId> group_origins;
+    std::vector<std::vector<size_t>> group_pairs;
+    std::vector<graph::VertexId> targets(pairs.size());
+    for (size_t i = 0; i < pairs.size(); ++i) {
+        const auto from = GetStopVertex(pairs[i].first);
+        const auto to = GetStopVertex(pairs[i].second);
+        if (!from || !to) {
+            continue;
+        }
+        targets[i] = *to;
+        const auto [group, inserted] = group_indices.emplace(*from, group_origins.size());
+        if (inserted) {
+            group_origins.push_back(*from);
+            group_pairs.emplace_back();
+        }
+        group_pairs[group->second].push_back(i);
+    }
+
+    parallel::ParallelFor(group_origins.size(), threads_count, [&](size_t group) {
+        const graph::VertexId origin = group_origins[group];
+        const auto &indices = group_pairs[group];
+        // по таблице или разметке маршрут восстанавливается без поиска
+        if (router_ || hub_labels_ || indices.size() == 1) {
+            for (const size_t i : indices) {
+                graph::Router<double>::RouteInfo route;
+                if (const auto weight = FindRoute(origin, targets[i], &route.edges)) {
+                    route.weight = *weight;
+                    result[i] = std::move(route);
+                }
+            }
+            return;
+        }
+        auto &workspace = GetWorkspace();
+        auto &search = GetSearch(workspace.one_to_many, graph_);
+        workspace.targets.clear();
+        for (const size_t i : indices) {
+            workspace.targets.push_back(targets[i]);
+        }
+        search.Run(origin, workspace.targets, workspace.target_weights);
+        for (const size_t i : indices) {
+            graph::Router<double>::RouteInfo route;
+            if (const auto weight = search.BuildRoute(targets[i], route.edges)) {
+                route.weight = *weight;
+                result[i] = std::move(route);
+            }
+        }
+    });
+    return result;
+}
+
+std::optional<double> TransportRouter::FindRoute(graph::VertexId from, graph::VertexId to, graph::Router<double>::RouteEdges *edges) const {
+    if (router_) {
+        return edges ? router_->BuildRoute(from, to, *edges) : router_->GetRouteWeight(from, to);
+    }
+    if (hub_labels_) {
+        return edges ? hub_labels_->BuildRoute(from, to, *edges) : hub_labels_->GetDistance(from, to);
+    }
+    return SearchRoute(from, to, edges);
+}
+
+std::optional<double> TransportRouter::SearchRoute(graph::VertexId from, graph::VertexId to, graph::Router<double>::RouteEdges *edges,
+                                                   size_t *settled_count) const {
+    auto &workspace = GetWorkspace();
+    std::optional<double> weight;
+    size_t settled = 0;
+    if (search_ == RouteSearch::BIDIRECTIONAL) {
+        auto &search = GetSearch(workspace.bidirectional, graph_);
+        weight = search.Run(from, to, edges);
+        settled = search.GetSettledCount();
+    } else {
+        auto &search = GetSearch(workspace.point_to_point, graph_);
+        if (search_ == RouteSearch::GEOMETRIC_A_STAR) {
+            weight = search.Run(from, to, edges, [this, to](graph::VertexId vertex) {
+                return GetStraightLineBound(vertex, to);
+            });
+        } else if (search_ == RouteSearch::ALT) {
+            weight = search.Run(from, to, edges, [this, to](graph::VertexId vertex) {
+                return landmarks_->GetLowerBound(vertex, to);
+            });
+        } else {
+            weight = search.Run(from, to, edges);
+        }
+        settled = search.GetSettledCount();
+    }
+    if (settled_count) {
+        *settled_count = settled;
+    }
+    return weight;
+}
+
+uint64_t TransportRouter::NextGraphGeneration() {
+    static std::atomic<uint64_t> next_generation{1};
+    return next_generation++;
+}
+
+TransportRouter::SearchWorkspace &TransportRouter::GetWorkspace() const {
+    thread_local SearchWorkspace workspace;
+    if (workspace.graph_generation != graph_generation_) {
+        // поиски ссылаются на прежний граф и размечены под его число вершин
+        workspace.point_to_point.reset();
+        workspace.bidirectional.reset();
+        workspace.one_to_many.reset();
+        workspace.graph_generation = graph_generation_;
+    }
+    return workspace;
+}
+
+RouteSearch TransportRouter::GetRouteSearch() const {
+    return search_;
+}
+
+uint64_t TransportRouter::GetCreatedSearchesCount() {
+    return created_searches;
+}
+
+std::vector<graph::Router<double>::RouteInfo> TransportRouter::CreateParetoRoutes(std::string_view stop_from, std::string_view stop_to,
+                                                                                 size_t max_rides) const {
+    std::vector<graph::Router<double>::RouteInfo> routes;
+    const auto vertex_from = GetStopVertex(stop_from);
+    const auto vertex_to = GetStopVertex(stop_to);
+    if (!vertex_from || !vertex_to) {
+        return routes;
+    }
+    if (*vertex_from == *vertex_to) {
+        routes.push_back({0., {}});
+        return routes;
+    }
+    const double INF = std::numeric_limits<double>::infinity();
+    const size_t vertex_count = graph_.GetVertexCount();
+    const size_t NO_LABEL = std::numeric_limits<size_t>::max();
+    // Время прибытия в вершину ожидания не более чем с k поездками не растёт с k, поэтому хранится одна метка на вершину,
+    // а время раунда k - 1 для продолжения маршрутов запоминается только у отмеченных вершин (boardings).
+    // Для восстановления маршрутов каждое улучшение записывается в журнал: раунд, ребро поездки и предыдущая запись
+    // той же вершины; last_labels - последняя запись вершины
+    struct RideLabel {
+        size_t round;
+        graph::EdgeId ride_edge;
+        size_t previous;
+    };
+    std::vector<double> arrivals(vertex_count, INF);
+    std::vector<size_t> last_labels(vertex_count, NO_LABEL);
+    std::vector<RideLabel> labels;
+    arrivals[*vertex_from] = 0.;
+    std::vector<graph::VertexId> marked{*vertex_from};
+    std::vector<graph::VertexId> next_marked;
+    std::vector<std::pair<graph::VertexId, double>> boardings;
+    std::vector<bool> is_marked(vertex_count, false);
+
+    // без ограничения раунды идут, пока есть улучшения; их не больше числа вершин, как в алгоритме Беллмана - Форда
+    for (size_t round = 1; !marked.empty() && (max_rides == 0 || round <= max_rides); ++round) {
+        boardings.clear();
+        for (const graph::VertexId wait_vertex : marked) {
+            boardings.emplace_back(wait_vertex, arrivals[wait_vertex]);
+        }
+        next_marked.clear();
+        bool target_improved = false;
+        for (const auto &[wait_vertex, wait_arrival] : boardings) {
+            for (const graph::EdgeId wait_edge_id : graph_.GetIncidentEdges(wait_vertex)) {
+                const auto &wait_edge = graph_.GetEdge(wait_edge_id);
+                const double boarding_time = wait_arrival + wait_edge.weight;
+                for (const graph::EdgeId ride_edge_id : graph_.GetIncidentEdges(wait_edge.to)) {
+                    const auto &ride_edge = graph_.GetEdge(ride_edge_id);
+                    const double arrival = boarding_time + ride_edge.weight;
+                    // маршрут не лучше уже найденного до цели не войдёт в ответ и не продолжится
+                    if (!(arrival < arrivals[ride_edge.to] && arrival < arrivals[*vertex_to])) {
+                        continue;
+                    }
+                    arrivals[ride_edge.to] = arrival;
+                    // повторное улучшение в том же раунде заменяет запись раунда
+                    const size_t last_label = last_labels[ride_edge.to];
+                    if (last_label != NO_LABEL && labels[last_label].round == round) {
+                        labels[last_label].ride_edge = ride_edge_id;
+                    } else {
+                        last_labels[ride_edge.to] = labels.size();
+                        labels.push_back({round, ride_edge_id, last_label});
+                    }
+                    target_improved = target_improved || ride_edge.to == *vertex_to;
+                    if (!is_marked[ride_edge.to]) {
+                        is_marked[ride_edge.to] = true;
+                        next_marked.push_back(ride_edge.to);
+                    }
+                }
+            }
+        }
+        for (const graph::VertexId vertex : next_marked) {
+            is_marked[vertex] = false;
+        }
+        std::swap(marked, next_marked);
+        if (!target_improved) {
+            continue;
+        }
+
+        // Восстановление от цели назад: маршрут до вершины не более чем с k поездками заканчивается поездкой
+        // из её последней записи с раундом не больше k. Каждый шаг уменьшает k хотя бы на единицу
+        graph::Router<double>::RouteInfo route{arrivals[*vertex_to], {}};
+        graph::VertexId vertex = *vertex_to;
+        size_t rides_left = round;
+        while (vertex != *vertex_from) {
+            size_t label = last_labels[vertex];
+            while (label != NO_LABEL && labels[label].round > rides_left) {
+                label = labels[label].previous;
+            }
+            if (label == NO_LABEL) {
+                throw std::logic_error("Pareto route label is missing");
+            }
+            const auto &ride_edge = graph_.GetEdge(labels[label].ride_edge);
+            route.edges.emplace_back(labels[label].ride_edge, &ride_edge);
+            // вершина поездки следует за вершиной ожидания, из которой в неё ведёт ребро ожидания
+            const graph::VertexId boarding_vertex = ride_edge.from - 1;
+            for (const graph::EdgeId wait_edge_id : graph_.GetIncidentEdges(boarding_vertex)) {
+                if (graph_.GetEdge(wait_edge_id).to == ride_edge.from) {
+                    route.edges.emplace_back(wait_edge_id, &graph_.GetEdge(wait_edge_id));
+                    break;
+                }
+            }
+            vertex = boarding_vertex;
+            rides_left = labels[label].round - 1;
+        }
+        std::reverse(route.edges.begin(), route.edges.end());
+        routes.push_back(std::move(route));
+    }
+    return routes;
+}
+
+std::optional<TimetableRouter::Journey> TransportRouter::CreateJourney(std::string_view stop_from, std::string_view stop_to,
+                                                                       double departure_time) const {
+    const domain::Stop *from = db_ ? db_->FindStop(stop_from) : nullptr;
+    const domain::Stop *to = db_ ? db_->FindStop(stop_to) : nullptr;
+    if (!from || !to) {
+        return std::nullopt;
+    }
+    return timetable_.FindJourney(from->id, to->id, departure_time);
+}
+
+const TimetableRouter &TransportRouter::GetTimetableRouter() const {
+    return timetable_;
+}
+
+std::optional<double> TransportRouter::GetRouteTime(std::string_view stop_from, std::string_view stop_to) const {
+    const auto vertex_from = GetStopVertex(stop_from);
+    const auto vertex_to = GetStopVertex(stop_to);
+    if (!vertex_from || !vertex_to) {
+        return std::nullopt;
+    }
+    return FindRoute(*vertex_from, *vertex_to, nullptr);
+}
+
+std::vector<std::vector<std::optional<double>>> TransportRouter::GetTravelTimes(const std::vector<std::string_view> &origins,
+                                                                                const std::vector<std::string_view> &destinations,
+                                                                                size_t threads_count) const {
+    std::vector<std::optional<graph::VertexId>> origin_vertices;
+    origin_vertices.reserve(origins.size());
+    for (const auto origin : origins) {
+        origin_vertices.push_back(GetStopVertex(origin));
+    }
+    // неизвестные остановки в поиск не передаются, их столбцы остаются пустыми
+    std::vector<graph::VertexId> target_vertices;
+    std::vector<size_t> target_columns;
+    for (size_t column = 0; column < destinations.size(); ++column) {
+        if (const auto vertex = GetStopVertex(destinations[column])) {
+            target_vertices.push_back(*vertex);
+            target_columns.push_back(column);
+        }
+    }
+
+    std::vector<std::vector<std::optional<double>>> result(origins.size(), std::vector<std::optional<double>>(destinations.size()));
+    if (hub_labels_ || router_) {
+        for (size_t row = 0; row < origins.size(); ++row) {
+            if (!origin_vertices[row]) {
+                continue;
+            }
+            for (size_t i = 0; i < target_vertices.size(); ++i) {
+                result[row][target_columns[i]] = FindRoute(*origin_vertices[row], target_vertices[i], nullptr);
+            }
+        }
+        return result;
+    }
+
+    // задание - блок исходных остановок, поиск берётся из рабочей области потока
+    const size_t threads = parallel::ResolveThreadsCount(threads_count);
+    const size_t chunk_size = (origins.size() + threads - 1) / threads;
+    const size_t chunks_count = chunk_size == 0 ? 0 : (origins.size() + chunk_size - 1) / chunk_size;
+    parallel::ParallelFor(chunks_count, threads, [&](size_t chunk) {
+        auto &workspace = GetWorkspace();
+        auto &search = GetSearch(workspace.one_to_many, graph_);
+        auto &times = workspace.target_weights;
+        const size_t end = std::min(origins.size(), (chunk + 1) * chunk_size);
+        for (size_t row = chunk * chunk_size; row < end; ++row) {
+            if (!origin_vertices[row]) {
+                continue;
+            }
+            search.Run(*origin_vertices[row], target_vertices, times);
+            for (size_t i = 0; i < target_vertices.size(); ++i) {
+                result[row][target_columns[i]] = times[i];
+            }
+        }
+    });
+    return result;
+}
+
+std::optional<graph::VertexId> TransportRouter::GetStopVertex(std::string_view stop_name) const {
+    // поиск по string_view в хеш-таблице каталога, без временных строк
+    const domain::Stop *stop = db_ ? db_->FindStop(stop_name) : nullptr;
+    if (!stop) {
+        return std::nullopt;
+    }
+    return stop_ids_[stop->id];
+}
+
+const graph::DirectedWeightedGraph<double> &TransportRouter::GetGraph() const {
+    return graph_;
+}
+
+const graph::Router<double> &TransportRouter::GetRouter() const {
+    if (!router_) {
+        throw std::logic_error("Routing table was not built");
+    }
+    return *router_;
+}
+
+bool TransportRouter::HasRoutesTable() const {
+    return router_ != nullptr;
+}
+
+const graph::HubLabels &TransportRouter::GetHubLabels() const {
+    if (!hub_labels_) {
+        throw std::logic_error("Hub labels were not built");
+    }
+    return *hub_labels_;
+}
+
+bool TransportRouter::HasHubLabels() const {
+    return hub_labels_ != nullptr;
+}
+
+graph::AllPairsCost TransportRouter::GetPrecomputeCost() const {
+    return graph::Router<double>::EstimateCost(graph_.GetVertexCount(), graph_.GetEdgeCount());
+}
+
+const std::vector<graph::VertexId> &TransportRouter::GetStopVertices() const {
+    return stop_ids_;
+}
+
+int TransportRouter::GetBusWaitTime() const {
+    return bus_wait_time_;
+}
+
+double TransportRouter::GetBusVelocity() const {
+    return bus_velocity_;
 }
 
 } // namespace router
\ No newline at end of file
@@ -1,13 +1,48 @@
 #pragma once
 
+#include "geo.h"
+#include "hub_labels.h"
+#include "landmarks.h"
 #include "router.h"
+#include "shortest_paths.h"
+#include "timetable_router.h"
 #include "transport_catalogue.h"
 
-#include <map>
+#include <cstdint>
 #include <memory>
+#include <optional>
+#include <unordered_map>
+#include <vector>
 
 namespace router {
 
+// Поиск маршрута по графу, когда нет таблицы маршрутов
+enum class RouteSearch {
+    DIJKSTRA,
+    // A* с оценкой по расстоянию по прямой до остановки назначения
+    GEOMETRIC_A_STAR,
+    // A* с оценкой по ориентирам (graph::Landmarks)
+    ALT,
+    // встречные поиски Дейкстры от начала и от конца (graph::BidirectionalSearch)
+    BIDIRECTIONAL,
+};
+
+// Ограничения предрасчёта таблицы маршрутов: она занимает O(V^2) памяти и строится за O(V^3)
+struct PrecomputeSettings {
+    // предел оценки пиковой памяти предрасчёта (graph::AllPairsCost::peak_bytes), 0 - без ограничения
+    size_t memory_limit = 0;
+    // при превышении предела: true - таблица не строится и маршруты ищутся Дейкстрой по графу,
+    // false - конструктор бросает std::length_error
+    bool fallback = true;
+    // ход расчёта таблицы
+    graph::AllPairsProgress progress;
+    // Построить двухточечную разметку (graph::HubLabels), если таблица маршрутов не строится из-за предела памяти:
+    // по ней находятся время в пути и маршруты. С таблицей разметка не нужна и не строится
+    bool hub_labels = false;
+    // поиск маршрутов без таблицы; данные для оценок A* строятся в конструкторе и при обновлениях графа
+    RouteSearch search = RouteSearch::DIJKSTRA;
+};
+
 class TransportRouter {
 public:
     // static constexpr double SPEED_COEFF = 100 / 6;
@@ -15,21 +50,193 @@ public:
 
     TransportRouter(const TransportCatalogue &db, int wait_time, double bus_velocity);
 
-    void BuildGraph(const TransportCatalogue &db);
+    // затраты на таблицу маршрутов оцениваются по построенному графу до её расчёта
+    TransportRouter(const TransportCatalogue &db, int wait_time, double bus_velocity, const PrecomputeSettings &settings);
+
+    // только настройки: граф строится вызовом BuildGraph, таблица маршрутов не рассчитывается
+    TransportRouter(int wait_time, double bus_velocity);
+
+    // Восстановление из снимка: граф и предрасчёт маршрутизатора берутся готовыми,
+    // пустой routes_data у непустого графа - снимок без таблицы маршрутов. Данные для оценок поиска search
+    // и разметка (hub_labels, только без таблицы) в снимке не хранятся и строятся по графу заново
+    TransportRouter(const TransportCatalogue &db, int wait_time, double bus_velocity,
+                    graph::DirectedWeightedGraph<double> graph, std::vector<graph::VertexId> stop_ids,
+                    graph::Router<double>::RoutesInternalData routes_data,
+                    RouteSearch search = RouteSearch::DIJKSTRA, bool hub_labels = false);
+
+    // копия маршрутизатора для копии каталога db: имена рёбер переводятся на таблицу имён db
+    TransportRouter(const TransportRouter &other, const TransportCatalogue &db);
+
+    TransportRouter(const TransportRouter &) = delete;
+    TransportRouter &operator=(const TransportRouter &) = delete;
+
+    // Рёбра маршрутов строятся параллельно в threads_count потоках (0 - по числу ядер).
+    // Порядок и id рёбер от числа потоков не зависят
+    void BuildGraph(const TransportCatalogue &db, size_t threads_count = 0);
     const std::optional<graph::Router<double>::RouteInfo> CreateRoute(const std::string_view stop_from, const std::string_view stop_to) const;
 
+    const std::optional<graph::Router<double>::RouteInfo> CreateRoute(domain::StopId stop_from, domain::StopId stop_to) const;
+
+    // Рёбра маршрута в порядке поездки записываются в переиспользуемый буфер edges, возвращается время пути.
+    // std::nullopt если остановки нет в каталоге или маршрута нет
+    std::optional<double> CreateRoute(std::string_view stop_from, std::string_view stop_to,
+                                      graph::Router<double>::RouteEdges &edges) const;
+
+    // Маршруты для пакета пар остановок: result[i] - маршрут pairs[i], std::nullopt для неизвестной остановки
+    // или если маршрута нет. Пары группируются по исходной остановке, группы распределяются по threads_count потокам
+    // (0 - по числу ядер). Без таблицы и разметки для группы выполняется один поиск Дейкстры до всех её целей,
+    // а для единственной пары - поиск способом из настроек. Время в пути то же, что у CreateRoute
+    std::vector<std::optional<graph::Router<double>::RouteInfo>> CreateRoutes(
+        const std::vector<std::pair<std::string_view, std::string_view>> &pairs, size_t threads_count = 0) const;
+
+    // Маршруты, оптимальные по Парето по времени и числу поездок: самый быстрый маршрут с одной поездкой, затем
+    // с двумя и т.д., если он быстрее всех предыдущих. Поиск по раундам (как RAPTOR) над рёбрами ожидания и поездок:
+    // раунд k продлевает на одну поездку маршруты остановок, улучшенных в раунде k - 1. max_rides ограничивает
+    // число раундов (0 - пока есть улучшения). Память - метка времени на вершину и запись на каждое улучшение.
+    // Маршруты упорядочены по числу поездок, пусто если остановки нет или маршрута нет
+    std::vector<graph::Router<double>::RouteInfo> CreateParetoRoutes(std::string_view stop_from, std::string_view stop_to,
+                                                                    size_t max_rides = 0) const;
+
+    // Поездка по расписаниям маршрутов с отправлением не раньше departure_time (минуты от начала суток).
+    // Учитываются только маршруты с расписанием и время пересадки на остановках, bus_wait_time не используется
+    std::optional<TimetableRouter::Journey> CreateJourney(std::string_view stop_from, std::string_view stop_to,
+                                                          double departure_time) const;
+
+    const TimetableRouter &GetTimetableRouter() const;
+
+    // только время пути, рёбра маршрута не восстанавливаются; без таблицы, но с разметкой - слиянием меток
+    std::optional<double> GetRouteTime(std::string_view stop_from, std::string_view stop_to) const;
+
+    // Матрица времени в пути: result[i][j] - время от origins[i] до destinations[j] без восстановления маршрутов,
+    // std::nullopt для неизвестной остановки или недостижимой пары. Время берётся из таблицы маршрутов, без неё
+    // из разметки, иначе для каждой исходной остановки выполняется поиск Дейкстры до всех целей сразу.
+    // Исходные остановки распределяются по threads_count потокам (0 - по числу ядер)
+    std::vector<std::vector<std::optional<double>>> GetTravelTimes(const std::vector<std::string_view> &origins,
+                                                                   const std::vector<std::string_view> &destinations,
+                                                                   size_t threads_count = 0) const;
+
+    // вершина ожидания на остановке, std::nullopt если остановки нет в каталоге
+    std::optional<graph::VertexId> GetStopVertex(std::string_view stop_name) const;
+
+    const graph::DirectedWeightedGraph<double> &GetGraph() const;
+
+    // таблица маршрутов; std::logic_error, если она не строилась
+    const graph::Router<double> &GetRouter() const;
+
+    // false - таблица не построена из-за предела памяти, маршруты ищутся по графу
+    bool HasRoutesTable() const;
+
+    // двухточечная разметка; std::logic_error, если она не строилась
+    const graph::HubLabels &GetHubLabels() const;
+
+    bool HasHubLabels() const;
+
+    // Поиск маршрута по графу способом из настроек, без таблицы и разметки: рёбра пишутся в edges, если он передан,
+    // а в settled_count - число извлечённых из очереди вершин. Так маршруты ищутся, когда таблицы нет.
+    // Рабочие массивы поиска свои у каждого потока, поэтому повторные запросы память не выделяют
+    std::optional<double> SearchRoute(graph::VertexId from, graph::VertexId to, graph::Router<double>::RouteEdges *edges,
+                                      size_t *settled_count = nullptr) const;
+
+    RouteSearch GetRouteSearch() const;
+
+    // Число созданных поисков рабочих областей во всех потоках процесса. Рабочие области живут в потоках
+    // пула parallel::RunOnWorkers, поэтому повторные пакеты CreateRoutes и GetTravelTimes новых не создают
+    static uint64_t GetCreatedSearchesCount();
+
+    // оценка затрат на таблицу маршрутов для текущего графа
+    graph::AllPairsCost GetPrecomputeCost() const;
+
+    // вершины ожидания остановок, индекс - id остановки
+    const std::vector<graph::VertexId> &GetStopVertices() const;
+
+    int GetBusWaitTime() const;
+
+    double GetBusVelocity() const;
+
+    // Применяет записи журнала каталога, появившиеся после построения или прошлого вызова.
+    // Перестраиваются только рёбра затронутых маршрутов, таблица маршрутизатора обновляется частично
+    void ApplyCatalogueUpdates();
+
 private:
     int bus_wait_time_ = 0;
     double bus_velocity_ = 0.0;
-    std::map<std::string, graph::VertexId> stop_ids_;
+    const TransportCatalogue *db_ = nullptr;
+    // вершина ожидания для каждой остановки, индекс - id остановки; вершина поездки следует за ней
+    std::vector<graph::VertexId> stop_ids_;
     graph::DirectedWeightedGraph<double> graph_;
     std::unique_ptr<graph::Router<double>> router_;
+    // Разметка вместо таблицы маршрутов, только если таблицы нет. Перестраивается целиком при каждом изменении
+    // графа: это построение с нуля, сопоставимое по времени с первым (набор бенчмарков hub_labels)
+    std::unique_ptr<graph::HubLabels> hub_labels_;
+    RouteSearch search_ = RouteSearch::DIJKSTRA;
+    // Для геометрической оценки: координаты остановки каждой вершины графа (wait - вершина ожидания) и наибольшая
+    // скорость по прямой на рёбрах поездок (метров в минуту), с которой расстояние до цели переводится во время
+    struct VertexPoint {
+        geo::PreparedCoordinates coordinates;
+        bool wait = false;
+    };
+    std::vector<VertexPoint> vertex_points_;
+    double max_straight_speed_ = 0.;
+    std::unique_ptr<graph::Landmarks> landmarks_;
+
+    // Рабочие массивы поисков по графу размером в число вершин. Создаются при первом поиске нужного вида
+    // и переиспользуются: метки номера запуска делают сброс между поисками O(1)
+    struct SearchWorkspace {
+        // версия графа, под которую созданы поиски (graph_generation_)
+        uint64_t graph_generation = 0;
+        std::optional<graph::PointToPointSearch<double>> point_to_point;
+        std::optional<graph::BidirectionalSearch<double>> bidirectional;
+        std::optional<graph::OneToManySearch<double>> one_to_many;
+        // цели и расстояния до них для one_to_many
+        std::vector<graph::VertexId> targets;
+        std::vector<std::optional<double>> target_weights;
+    };
+    // Версия графа, уникальная среди всех маршрутизаторов: новая при построении маршрутизатора и при каждом
+    // изменении графа. По ней рабочая область потока узнаёт, что её поиски созданы для другого графа
+    uint64_t graph_generation_ = NextGraphGeneration();
+    // связи рейсов по расписанию, перестраиваются целиком при любом изменении каталога
+    TimetableRouter timetable_;
+    // рёбра поездок каждого маршрута, чтобы при изменении маршрута заменить только их
+    std::unordered_map<std::string_view, std::vector<graph::EdgeId>> bus_edges_;
+    // число обработанных записей журнала каталога
+    size_t applied_updates_ = 0;
+
+    // Маршрут между вершинами по таблице или, без неё, по разметке или поиском по графу; рёбра пишутся в edges,
+    // если он передан. Только время без таблицы или с разметкой берётся из разметки
+    std::optional<double> FindRoute(graph::VertexId from, graph::VertexId to, graph::Router<double>::RouteEdges *edges) const;
+
+    // перестраивает данные для оценок A* выбранного поиска по текущему графу
+    void PrepareRouteSearch();
+
+    static uint64_t NextGraphGeneration();
+
+    // Рабочая область текущего потока, своя у каждого потока, поэтому поиски идут без блокировок.
+    // Поиски под другую версию графа сбрасываются и создаются заново при первом поиске нужного вида
+    SearchWorkspace &GetWorkspace() const;
+
+    // нижняя оценка времени от vertex до to по расстоянию по прямой
+    double GetStraightLineBound(graph::VertexId vertex, graph::VertexId to) const;
+
+    // добавляет вершины ожидания и поездки с ребром ожидания между ними, возвращает id ребра
+    graph::EdgeId AddStopVertices(const domain::Stop &stop, graph::DirectedWeightedGraph<double> &stops_graph);
+
+    // Приводит рёбра маршрута bus_name к его текущему виду, bus == nullptr - маршрут удалён. Рёбра с теми же концами,
+    // числом остановок и весом остаются в графе с прежними id, удаляются и добавляются только изменившиеся:
+    // строки таблицы, не проходящие через них, обновление не пересчитывает
+    void ReplaceBusEdges(std::string_view bus_name, const domain::Bus *bus, std::vector<graph::EdgeId> &removed_edges,
+                         std::vector<graph::EdgeId> &added_edges);
+
+    // число рёбер поездок маршрута: по ребру на каждую пару остановок i < j
+    static size_t CountBusEdges(const domain::Bus &bus);
+
+    // записывает рёбра поездок маршрута в edges[0, CountBusEdges(bus)); безопасно вызывать из разных потоков
+    void MakeBusEdges(const TransportCatalogue &db, const domain::Bus &bus, graph::Edge<double> *edges) const;
 
     void FillGraphWithVertices(const std::unordered_map<std::string_view, domain::Stop *> &stops_list,
                                graph::DirectedWeightedGraph<double> &stops_graph);
 
     void FillGraphWithEdges(const TransportCatalogue &db, const std::unordered_map<std::string_view, domain::Bus *> &bases_list,
-                            graph::DirectedWeightedGraph<double> &stops_graph);
+                            graph::DirectedWeightedGraph<double> &stops_graph, size_t threads_count);
 };
 
 } // namespace router
\ No newline at end of file
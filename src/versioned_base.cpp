@@ -0,0 +1,116 @@
+#include "versioned_base.h"
+
+#include <algorithm>
+
+namespace server {
+
+VersionedBase::ReadGuard::ReadGuard(ReaderSlot &slot, const Version &version)
+    : slot_(slot), version_(version) {
+}
+
+VersionedBase::ReadGuard::~ReadGuard() {
+    slot_.epoch.store(0, std::memory_order_release);
+}
+
+const serialization::TransportBase &VersionedBase::ReadGuard::operator*() const {
+    return *version_.base;
+}
+
+const serialization::TransportBase *VersionedBase::ReadGuard::operator->() const {
+    return version_.base.get();
+}
+
+uint64_t VersionedBase::ReadGuard::GetVersion() const {
+    return version_.number;
+}
+
+VersionedBase::Reader::Reader(VersionedBase &versions, ReaderSlot &slot)
+    : versions_(versions), slot_(slot) {
+}
+
+VersionedBase::Reader::~Reader() {
+    versions_.ReleaseReader(slot_);
+}
+
+VersionedBase::ReadGuard VersionedBase::Reader::Lock() {
+    // Эпоха объявляется до чтения указателя (все операции seq_cst). Если писатель увидел слот пустым
+    // или с эпохой не меньше эпохи замены, то указатель читается уже после замены и старая версия не видна
+    slot_.epoch.store(versions_.epoch_.load());
+    const Version *version = versions_.current_.load();
+    return ReadGuard(slot_, *version);
+}
+
+VersionedBase::VersionedBase(std::unique_ptr<serialization::TransportBase> base)
+    : current_(new Version{1, std::move(base)}) {
+}
+
+VersionedBase::~VersionedBase() {
+    delete current_.load();
+}
+
+std::unique_ptr<VersionedBase::Reader> VersionedBase::RegisterReader() {
+    std::lock_guard lock(readers_mutex_);
+    auto slot = std::find_if(reader_slots_.begin(), reader_slots_.end(), [](const ReaderSlot &slot) {
+        return !slot.in_use;
+    });
+    ReaderSlot &reader_slot = slot == reader_slots_.end() ? reader_slots_.emplace_back() : *slot;
+    reader_slot.in_use = true;
+    return std::unique_ptr<Reader>(new Reader(*this, reader_slot));
+}
+
+void VersionedBase::ReleaseReader(ReaderSlot &slot) {
+    std::lock_guard lock(readers_mutex_);
+    slot.epoch.store(0);
+    slot.in_use = false;
+}
+
+uint64_t VersionedBase::Update(const std::function<void(TransportCatalogue &)> &update) {
+    std::lock_guard lock(writer_mutex_);
+    // текущую версию меняет только писатель, поэтому под writer_mutex_ она стабильна
+    const Version *current = current_.load();
+    auto next_base = CloneBase(*current->base);
+    update(next_base->catalogue);
+    next_base->catalogue.RefreshStatistics();
+    next_base->router->ApplyCatalogueUpdates();
+    const uint64_t number = current->number + 1;
+
+    const Version *replaced = current_.exchange(new Version{number, std::move(next_base)});
+    retired_.push_back({std::unique_ptr<const Version>(replaced), epoch_.fetch_add(1) + 1});
+    ReclaimRetired();
+    return number;
+}
+
+void VersionedBase::ReclaimRetired() {
+    uint64_t oldest_reader_epoch = UINT64_MAX;
+    {
+        std::lock_guard lock(readers_mutex_);
+        for (const auto &slot : reader_slots_) {
+            const uint64_t epoch = slot.epoch.load();
+            if (epoch != 0) {
+                oldest_reader_epoch = std::min(oldest_reader_epoch, epoch);
+            }
+        }
+    }
+    // версию, заменённую в эпоху e, могут держать только читатели, начавшие чтение раньше e
+    retired_.erase(std::remove_if(retired_.begin(), retired_.end(), [oldest_reader_epoch](const RetiredVersion &retired) {
+                       return oldest_reader_epoch >= retired.epoch;
+                   }),
+                   retired_.end());
+}
+
+uint64_t VersionedBase::GetVersion() const {
+    return current_.load()->number;
+}
+
+size_t VersionedBase::GetRetiredCount() const {
+    std::lock_guard lock(writer_mutex_);
+    return retired_.size();
+}
+
+std::unique_ptr<serialization::TransportBase> CloneBase(const serialization::TransportBase &base) {
+    std::unique_ptr<serialization::TransportBase> copy(new serialization::TransportBase{base.catalogue, nullptr, base.render_sets});
+    copy->router = std::make_unique<router::TransportRouter>(*base.router, copy->catalogue);
+    return copy;
+}
+
+} // namespace server
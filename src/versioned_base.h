@@ -0,0 +1,112 @@
+#pragma once
+
+#include <atomic>
+#include <cstdint>
+#include <deque>
+#include <functional>
+#include <memory>
+#include <mutex>
+#include <vector>
+
+#include "serialization.h"
+#include "transport_catalogue.h"
+
+namespace server {
+
+// Версионированная база для одновременной работы читателей и писателя (схема RCU).
+// Опубликованная версия не изменяется: писатель копирует текущую версию, применяет к копии
+// изменения и атомарно подменяет указатель. Читатель на время запроса объявляет эпоху,
+// в которую начал чтение, и не берёт блокировок; старая версия освобождается, когда
+// все читатели, которые могли её видеть, закончили чтение
+class VersionedBase {
+private:
+    struct alignas(64) ReaderSlot {
+        // эпоха начала текущего чтения, 0 - читатель ничего не держит
+        std::atomic<uint64_t> epoch{0};
+        bool in_use = false;
+    };
+
+    struct Version {
+        uint64_t number;
+        std::unique_ptr<serialization::TransportBase> base;
+    };
+
+public:
+    // Версия, которую держит читатель; пока объект жив, версия не освобождается
+    class ReadGuard {
+    public:
+        ReadGuard(const ReadGuard &) = delete;
+        ReadGuard &operator=(const ReadGuard &) = delete;
+        ~ReadGuard();
+
+        const serialization::TransportBase &operator*() const;
+        const serialization::TransportBase *operator->() const;
+
+        uint64_t GetVersion() const;
+
+    private:
+        friend class VersionedBase;
+        ReadGuard(ReaderSlot &slot, const Version &version);
+
+        ReaderSlot &slot_;
+        const Version &version_;
+    };
+
+    // Читатель регистрируется один раз на поток; одновременно у него может быть только один ReadGuard
+    class Reader {
+    public:
+        Reader(const Reader &) = delete;
+        Reader &operator=(const Reader &) = delete;
+        ~Reader();
+
+        ReadGuard Lock();
+
+    private:
+        friend class VersionedBase;
+        Reader(VersionedBase &versions, ReaderSlot &slot);
+
+        VersionedBase &versions_;
+        ReaderSlot &slot_;
+    };
+
+    explicit VersionedBase(std::unique_ptr<serialization::TransportBase> base);
+    VersionedBase(const VersionedBase &) = delete;
+    VersionedBase &operator=(const VersionedBase &) = delete;
+    // к моменту разрушения читателей быть не должно
+    ~VersionedBase();
+
+    std::unique_ptr<Reader> RegisterReader();
+
+    // Строит и публикует следующую версию: update изменяет копию каталога, после чего маршрутизатор
+    // догоняет журнал изменений. Писатели выполняются по одному. Возвращает номер новой версии
+    uint64_t Update(const std::function<void(TransportCatalogue &)> &update);
+
+    uint64_t GetVersion() const;
+
+    // число заменённых версий, которые ещё не освобождены из-за незавершённых чтений
+    size_t GetRetiredCount() const;
+
+private:
+    std::atomic<const Version *> current_;
+    std::atomic<uint64_t> epoch_{1};
+
+    // регистрация читателей и просмотр их эпох; на пути чтения не используется
+    mutable std::mutex readers_mutex_;
+    std::deque<ReaderSlot> reader_slots_;
+
+    mutable std::mutex writer_mutex_;
+    struct RetiredVersion {
+        std::unique_ptr<const Version> version;
+        uint64_t epoch;
+    };
+    std::vector<RetiredVersion> retired_;
+
+    void ReleaseReader(ReaderSlot &slot);
+    // освобождает заменённые версии, которые уже никто не читает; вызывается под writer_mutex_
+    void ReclaimRetired();
+};
+
+// Копия базы для построения следующей версии: каталог копируется, маршрутизатор переносится на копию каталога
+std::unique_ptr<serialization::TransportBase> CloneBase(const serialization::TransportBase &base);
+
+} // namespace server